@@ -71,6 +71,12 @@ namespace flopoco{
 		 */
 		std::string getVendor();
 
+		/** Returns a description of the target and of all the options set on it,
+		 * such that two targets with the same description generate the same operators
+		 * @return the description
+		 */
+		std::string getOptionsDescription();
+
 
 		/** Returns true if the target is to have pipelined design, otherwise false
 		 * @return if the target is pipelined
@@ -184,6 +190,18 @@ namespace flopoco{
 		/** returns the ILP solver timeout in seconds */
 		int getILPTimeout();
 
+		/** sets the number of workers (threads or processes) that parallel parts of the generator may use */
+		void setThreads(int threads);
+
+		/** returns the number of workers that parallel parts of the generator may use */
+		int getThreads();
+
+		/** sets the number of threads of the beam search multiplier tiling. 0 means getThreads() */
+		void setBeamThreads(int beamThreads);
+
+		/** returns the number of threads of the beam search multiplier tiling */
+		int getBeamThreads();
+
 		/** returns the compression method used for multiplier tiling */
 		std::string  getTilingMethod();
 
@@ -470,6 +488,8 @@ namespace flopoco{
 		std::string tiling_; /**< Defines the multiplier tiling method*/
 		std::string ilpSolverName_; /*** Defines the ILP solver for operators optimized by ILP. It has to match a solver name known by the ScaLP library */
 		int ilpTimeout_; /*** Defines the timeout in seconds for the ILP solver for operators optimized by ILP.*/
+		int threads_; /**< Number of workers that parallel parts of the generator may use. 1 means sequential */
+		int beamThreads_; /**< Number of threads of the beam search tiling, 0 to use threads_ */
 	};
 
 }
@@ -40,6 +40,8 @@ namespace flopoco{
 			registerLargeTables_=true; 
 			tableCompression_=true;
 			ilpTimeout_=0;
+			threads_=1;
+			beamThreads_=0;
 			generateFigures_=false;
 		}
 
@@ -60,6 +62,19 @@ namespace flopoco{
 			return vendor_;
 		}
 
+	string Target::getOptionsDescription(){
+		ostringstream s;
+		s << id_ << " pipeline=" << pipeline_ << " frequency=" << frequency_
+			<< " useWriteEnable=" << useWriteEnable_ << " nameSignalByCycle=" << nameSignalByCycle_
+			<< " useHardMult=" << useHardMultipliers_ << " unusedHardMultThreshold=" << unusedHardMultThreshold_
+			<< " plainVHDL=" << plainVHDL_ << " registerLargeTables=" << registerLargeTables_
+			<< " tableCompression=" << tableCompression_ << " generateFigures=" << generateFigures_
+			<< " useTargetOpt=" << useTargetOpt_ << " compression=" << compression_ << " tiling=" << tiling_
+			<< " ilpSolver=" << ilpSolverName_ << " ilpTimeout=" << ilpTimeout_;
+		// threads_ and beamThreads_ only change how fast the operators are generated
+		return s.str();
+	}
+
 
 	bool Target::isPipelined() {
 		return (frequency_!=0);
@@ -186,6 +201,26 @@ namespace flopoco{
 		return ilpTimeout_;
 	}
 
+	void Target::setThreads(int threads)
+	{
+		threads_ = threads;
+	}
+
+	int Target::getThreads()
+	{
+		return threads_;
+	}
+
+	void Target::setBeamThreads(int beamThreads)
+	{
+		beamThreads_ = beamThreads;
+	}
+
+	int Target::getBeamThreads()
+	{
+		return (beamThreads_ > 0 ? beamThreads_ : threads_);
+	}
+
 	void Target::setTilingMethod(string method)
 	{
 		tiling_ = method;
@@ -112,6 +112,10 @@ namespace flopoco{
 		/** A wrapper for Sollya guessdegree
 		 */
 		static	void guessDegree(sollya_obj_t fS, sollya_obj_t rangeS, double targetAccuracy, int* degreeInfP, int* degreeSupP);
+
+		/** The Sollya printout of a function or range, as used in the keys of the approximation cache (see DiskCache).
+				Empty if Sollya cannot print it */
+		static std::string normalizedString(sollya_obj_t S);
 		std::string report();
 	private:
 		/** initialization of various constant objects for Sollya
@@ -127,6 +131,16 @@ namespace flopoco{
 		*/
 		void buildApproxFromDegreeAndLSBs();
 
+		/** the DiskCache key of buildApproxFromDegreeAndLSBs(): the function, its input range, the degree and the LSB.
+				Empty if the function cannot be normalized */
+		std::string cacheKey();
+
+		/** sets polynomialS and approxErrorBound from the cache entry of key, if any */
+		bool loadCachedApprox(const std::string& key);
+
+		/** stores polynomialS and approxErrorBound under key */
+		void storeApprox(const std::string& key);
+
 		/** Build coeff, the vector of coefficients, out of polynomialS, the sollya polynomial
 		 	 Constructor code, factored out
 		 * */
@@ -5,6 +5,7 @@
 #include <iostream>
 #include <sollya.h>
 #include <string>
+#include <vector>
 
 /* Stylistic convention here: all the sollya_obj_t have names that end with a capital S */
 namespace flopoco
@@ -53,9 +54,16 @@ namespace flopoco
 			x as well as the result(s) are given as bit vectors.
 			These bit vectors are held in a mpz_class which is always positive, although it may hold a two's complement value.
 			(this is the usual behaviour of emulate())
+			The evaluation is adaptive: the precision is only increased when the result is close to a rounding boundary.
 	*/
     void eval(mpz_class x, mpz_class& rNorD, mpz_class& ru, bool correctlyRounded = false) const;
 
+    /** Same as eval() above, on all the 2^wIn possible inputs x, the results being stored in rNorD[x] and ru[x] (ru is untouched if correctlyRounded).
+			The input range is split over the given number of worker processes.
+			The results are kept for later calls to eval(), and stored in the disk cache if it is enabled (see DiskCache).
+	*/
+    void evalAll(std::vector<mpz_class>& rNorD, std::vector<mpz_class>& ru, bool correctlyRounded = false, int workers = 1) const;
+
     // All the following public, not good practice I know, but life is complicated enough
     // All these public attributes are read at some point by Operator classes
     std::string sollyaString;
@@ -72,6 +80,14 @@ namespace flopoco
     private:
     void initialize();
     std::string outputDescription;
+
+    /** the key of the results of evalAll() in the disk cache: function, input and output formats, rounding */
+    std::string tableCacheKey(bool correctlyRounded) const;
+    /** true if all the results are in tabulatedRNorD/tabulatedRU. The disk cache is looked up on the first call for each rounding. */
+    bool isTabulated(bool correctlyRounded) const;
+    mutable std::vector<mpz_class> tabulatedRNorD[2]; /**< indexed by correctlyRounded */
+    mutable std::vector<mpz_class> tabulatedRU[2];    /**< indexed by correctlyRounded, only used for index 0 */
+    mutable bool tableLookedUp[2] = {false, false};
   };
 
 }  // namespace flopoco
@@ -54,6 +54,12 @@ namespace flopoco {
 		 */
 		static DifferentialCompression find_differential_compression(vector<mpz_class> const & values, int wIn, int wOut, Target * target);
 
+		/**
+		 * Same as find_differential_compression, but always computed on mpz_class, even when the values fit in machine words.
+		 * The results must be identical: this is only exposed so that the tests can compare both computations.
+		 */
+		static DifferentialCompression find_differential_compression_mpz(vector<mpz_class> const & values, int wIn, int wOut, Target * target, table_cost_function_t cost);
+
 
 		/**
 		 * @brief Uncompress the table
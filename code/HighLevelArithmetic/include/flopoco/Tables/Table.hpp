@@ -14,6 +14,7 @@
 
 #ifndef TABLE_HPP
 #define TABLE_HPP
+#include <cstdint>
 #include <vector>
 #include <gmpxx.h>
 
@@ -68,6 +69,12 @@ namespace flopoco
 		std::vector<mpz_class>
 		    values; /**< the values that fill the table */
 
+		std::vector<uint64_t>
+		    packedValues; /**< the same values as machine words if they all fit in 64 bits (the common case), empty otherwise */
+
+		/** true if packedValues holds the values */
+		bool isPacked() const { return !packedValues.empty(); }
+
 		/** Input width (in bits)*/
 		int wIn;
 
@@ -0,0 +1,70 @@
+#ifndef DISK_CACHE_HPP
+#define DISK_CACHE_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <gmpxx.h>
+
+namespace flopoco {
+
+	/** A persistent cache of generator results, shared by all the FloPoCo processes that use the same directory.
+			The directory is given by the FLOPOCO_CACHE_DIR environment variable: caching is disabled if it is not set.
+			Entries are content-addressed: the file name is a hash of a key string that describes everything the result depends on.
+			The full key is also stored in the entry, so that hash collisions are detected and treated as misses.
+			Each stored entry is also listed, with its key, in the file named index of the directory.
+			The index is only meant for inspection: lookups never read it.
+			Erasing the directory is always harmless.
+			Tables may also be kept in memory, so that the operators built by one process (e.g. in batch mode) share them.
+	*/
+	class DiskCache {
+	public:
+		/** true if FLOPOCO_CACHE_DIR is set, or if the memory cache is enabled */
+		static bool isEnabled();
+
+		/** true if FLOPOCO_CACHE_DIR is set */
+		static bool isPersistent();
+
+		/** keeps the tables in memory, in addition to the directory if any, for the lifetime of the process */
+		static void enableMemoryCache();
+
+		/** the cache directory, created if needed. Empty if the cache is not persistent */
+		static std::string directory();
+
+		/** the path of the entry corresponding to key, with the given extension */
+		static std::string entryPath(const std::string& key, const std::string& extension);
+
+		/** writes contents to path in a temporary file, then renames it, so that concurrent readers never see a partial file.
+				Returns false in case of error, in which case the cache is left unchanged. */
+		static bool writeAtomically(const std::string& path, const std::string& contents);
+
+		/** looks up a table of non-negative integers.
+				On a hit, the entry is memory-mapped and column j is written to *columns[j], and true is returned.
+				On a miss (absent entry, wrong key or wrong number of columns), false is returned and the columns are untouched. */
+		static bool loadTable(const std::string& key, const std::vector<std::vector<mpz_class>*>& columns);
+
+		/** stores a table of non-negative integers. All the columns should have the same size. */
+		static void storeTable(const std::string& key, const std::vector<const std::vector<mpz_class>*>& columns);
+
+		/** looks up an entry of free-form contents (e.g. a solver solution), stored with the given extension.
+				On a hit, contents is set and true is returned. */
+		static bool loadEntry(const std::string& key, const std::string& extension, std::string& contents);
+
+		/** stores an entry of free-form contents with the given extension */
+		static void storeEntry(const std::string& key, const std::string& extension, const std::string& contents);
+
+	private:
+		/** a 64-bit FNV-1a hash */
+		static uint64_t hash(const std::string& s);
+
+		/** appends a line to the index: the file name of the entry stored in path, then its key on one line */
+		static void appendToIndex(const std::string& path, const std::string& key);
+
+		/** keeps a copy of a table in memory, if the memory cache is enabled */
+		static void storeInMemory(const std::string& key, const std::vector<const std::vector<mpz_class>*>& columns);
+	};
+
+} // namespace flopoco
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef PHASE_TRACE_HPP
+#define PHASE_TRACE_HPP
+
+#include <cstdint>
+#include <string>
+
+namespace flopoco {
+
+	/** A trace of the time spent in each phase of the generation (construction, lexing, scheduling, etc.), per operator.
+			It is written when the process exits, as a Chrome trace (to be opened in chrome://tracing or Perfetto),
+			or as CSV if the file name ends with .csv.
+			When the trace is disabled, timing a phase costs a test.
+	*/
+	class PhaseTrace {
+	public:
+		/** starts recording. The trace will be written to fileName when the process exits */
+		static void enable(const std::string& fileName);
+
+		/** true if enable() was called */
+		static bool isEnabled();
+
+		/** microseconds elapsed since enable() */
+		static int64_t now();
+
+		/** records a phase of an object (typically an operator name), that started at start (see now()) */
+		static void record(const char* phase, const std::string& object, int64_t start, int64_t duration);
+
+		/** writes the trace recorded so far */
+		static void write();
+
+		/** Times a phase from its construction to its destruction. Use the TRACE_PHASE macro rather than this class */
+		class Scope {
+		public:
+			Scope(const char* phase);
+			~Scope();
+			bool isActive() const { return active; }
+			void setObject(const std::string& object_) { object = object_; }
+		private:
+			const char* phase;
+			std::string object;
+			int64_t start;
+			bool active;
+		};
+	};
+
+} // namespace flopoco
+
+#define PHASE_TRACE_CONCAT_(a, b) a##b
+#define PHASE_TRACE_CONCAT(a, b) PHASE_TRACE_CONCAT_(a, b)
+#define PHASE_TRACE_SCOPE_(phase, object, scope) \
+	flopoco::PhaseTrace::Scope scope(phase); \
+	if(scope.isActive()) scope.setObject(object)
+
+/** Times the rest of the enclosing block as phase of object. The object expression is only evaluated if the trace is enabled.
+		The scope variable is named after the line, so that a block may trace several phases */
+#define TRACE_PHASE(phase, object) \
+	PHASE_TRACE_SCOPE_(phase, object, PHASE_TRACE_CONCAT(phaseTraceScope, __LINE__))
+
+#endif
@@ -27,6 +27,13 @@ public:
   operator sollya_obj_t() { return manager.get(); }
   operator const sollya_obj_t() const {return manager.get();}
 };
+
+/**
+ * Sets the global Sollya precision, unless it is already the last one set here.
+ * Setting it allocates a Sollya object, which is costly in evaluation loops,
+ * so all the code that changes the Sollya precision should go through this function.
+ */
+void setSollyaPrecision(int precision);
 } // namespace flopoco
 
 #endif
@@ -0,0 +1,27 @@
+#ifndef WORKER_PROCESSES_HPP
+#define WORKER_PROCESSES_HPP
+
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+
+namespace flopoco {
+
+  /** Function computing the slice [begin, end) of a range of independent jobs, and writing its results to out */
+  using slice_producer_t = std::function<void(uint64_t begin, uint64_t end, FILE* out)>;
+  /** Function reading back the results of the slice [begin, end), as written by the corresponding producer */
+  using slice_consumer_t = std::function<void(uint64_t begin, uint64_t end, FILE* in)>;
+
+  /** Evaluates the jobs 0 to n-1 on worker processes.
+      Sollya has global state and is not thread-safe, hence processes rather than threads:
+      each worker is a fork() of the current process, with its own copy of the Sollya state.
+      The range is split into contiguous slices, one per worker.
+      Each worker calls produce() on its slice, writing to a temporary file.
+      Then the calling process calls consume() on each slice, in increasing order.
+      With workers<=1, or if a worker fails, the slice is produced in the calling process.
+  */
+  void runInWorkerProcesses(uint64_t n, int workers, slice_producer_t produce, slice_consumer_t consume);
+
+} // namespace flopoco
+
+#endif
@@ -18,7 +18,14 @@ namespace flopoco {
     FULL = 4
   };
 
-  bool is_log_lvl_enabled(LogLevel lvl);
+  namespace detail {
+    extern LogLevel loglevel;
+  }
+
+  /** inline, so that disabled REPORTs cost a comparison */
+  inline bool is_log_lvl_enabled(LogLevel lvl) {
+    return lvl <= detail::loglevel;
+  }
 
   void set_log_lvl(LogLevel lvl);
 
@@ -42,10 +49,13 @@ namespace flopoco {
   void report(LogLevel lvl, std::string const & message, std::string const & filename, int line, std::string const & funcname);
 }
 
+/** The stream is only formatted if the level is enabled */
 #define REPORT(level, stream) { \
+  if (flopoco::is_log_lvl_enabled(level)) { \
     std::stringstream __OUT_STREAM__; \
     __OUT_STREAM__ << "" << stream; \
     flopoco::report(level, __OUT_STREAM__.str(), __FILE__, __LINE__, __func__); \
+  } \
 }
 
 #endif
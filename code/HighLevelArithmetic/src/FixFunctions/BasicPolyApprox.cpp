@@ -22,6 +22,7 @@
 #include <iostream>
 
 #include "flopoco/FixFunctions/BasicPolyApprox.hpp"
+#include "flopoco/Tools/DiskCache.hpp"
 #include "flopoco/report.hpp"
 #include "flopoco/utils.hpp"
 
@@ -243,6 +244,14 @@ namespace flopoco{
 
 	void BasicPolyApprox::buildApproxFromDegreeAndLSBs()
 	{
+		// fpminimax and supnorm are expensive, other processes may already have done them
+		string key;
+		if(DiskCache::isEnabled()) {
+			key = cacheKey();
+			if(!key.empty() && loadCachedApprox(key))
+				return;
+		}
+
 		sollya_obj_t fS = f->fS; // no need to free this one
 		sollya_obj_t inputRangeS = f->inputRangeS; // no need to free this one
 		sollya_obj_t degreeS = sollya_lib_constant_from_int(degree);
@@ -311,12 +320,100 @@ namespace flopoco{
 		sollya_lib_clear_obj(supNormS);
 
 		REPORT(LogLevel::VERBOSE, "Polynomial accuracy is " << approxErrorBound);
+		if(!key.empty())
+			storeApprox(key);
 		// Please leave the memory in the state you would like to find it when entering
 		sollya_lib_clear_obj(degreeS);
 	}
 
 
 
+	string BasicPolyApprox::normalizedString(sollya_obj_t S)
+	{
+		int size = sollya_lib_snprintf(NULL, 0, "%b", S);
+		if(size <= 0)
+			return "";
+		vector<char> buffer(size+1);
+		sollya_lib_snprintf(buffer.data(), buffer.size(), "%b", S);
+		return string(buffer.data(), size);
+	}
+
+
+	string BasicPolyApprox::cacheKey()
+	{
+		string function = normalizedString(f->fS);
+		string range = normalizedString(f->inputRangeS);
+		if(function.empty() || range.empty())
+			return "";
+		ostringstream key;
+		key << "BasicPolyApprox f=" << function << " range=" << range << " degree=" << degree << " LSB=" << LSB;
+		return key.str();
+	}
+
+
+	bool BasicPolyApprox::loadCachedApprox(const string& key)
+	{
+		string contents;
+		if(!DiskCache::loadEntry(key, ".polyapprox", contents))
+			return false;
+
+		// the coefficients are stored as integer multiples of 2^LSB, in the dyadic notation of Sollya they are exact
+		istringstream in(contents);
+		double error;
+		in >> error;
+		ostringstream polynomial;
+		for (int i=0; i<=degree; i++){
+			mpz_class m;
+			in >> m;
+			if(i>0)
+				polynomial << " + ";
+			polynomial << "(" << m << "b" << LSB << ")*_x_^" << i;
+		}
+		if(!in)
+			return false;
+		sollya_obj_t pS = sollya_lib_parse_string(polynomial.str().c_str());
+		if(sollya_lib_obj_is_error(pS)) {
+			sollya_lib_clear_obj(pS);
+			return false;
+		}
+		polynomialS = pS;
+		approxErrorBound = error;
+		REPORT(LogLevel::VERBOSE, "Polynomial found in the approximation cache, accuracy is " << approxErrorBound);
+		return true;
+	}
+
+
+	void BasicPolyApprox::storeApprox(const string& key)
+	{
+		ostringstream contents;
+		contents << setprecision(17) << approxErrorBound << endl;
+		for (int i=0; i<=degree; i++){
+			sollya_obj_t iS = sollya_lib_constant_from_int(i);
+			sollya_obj_t coeffS = sollya_lib_coeff(polynomialS, iS);
+			sollya_lib_clear_obj(iS);
+			// fpminimax returned a multiple of 2^LSB: get it with enough precision to be exact, as in buildFixFormatVector()
+			mpz_class m = 0;
+			double dcoeff;
+			sollya_lib_get_constant_as_double(&dcoeff, coeffS);
+			if(0.0!=dcoeff) {
+				int prec = floor(log2(fabs(dcoeff))) + 2 - LSB + 3;
+				if(prec < 2)
+					prec = 2;
+				mpfr_t mpcoeff;
+				mpfr_init2(mpcoeff, prec);
+				sollya_lib_get_constant(mpcoeff, coeffS);
+				mpfr_mul_2si(mpcoeff, mpcoeff, -LSB, GMP_RNDN); // exact
+				mpfr_get_z(m.get_mpz_t(), mpcoeff, GMP_RNDN);
+				mpfr_clear(mpcoeff);
+			}
+			sollya_lib_clear_obj(coeffS);
+			contents << m << endl;
+		}
+		DiskCache::storeEntry(key, ".polyapprox", contents.str());
+	}
+
+
+
 	void BasicPolyApprox::buildFixFormatVector()
 	{
 		// compute the MSBs
@@ -16,7 +16,11 @@
 
 #include "flopoco/FixFunctions/FixFunction.hpp"
 #include "flopoco/report.hpp"
+#include "flopoco/Tools/DiskCache.hpp"
+#include "flopoco/Tools/SollyaHandler.hpp"
+#include "flopoco/Tools/WorkerProcesses.hpp"
 
+#include <algorithm>
 #include <cstdio>
 #include <sstream>
 
@@ -206,14 +210,33 @@ namespace flopoco
   }
 
 
+  /** true if the status returned by sollya_lib_evaluate_function_at_point guarantees a faithful result */
+  static bool isFaithfulEvaluation(int status)
+  {
+    return status == SOLLYA_FP_PROVEN_EXACT || status == SOLLYA_FP_CORRECT_ROUNDING_PROVEN_INEXACT || status == SOLLYA_FP_CORRECT_ROUNDING
+           || status == SOLLYA_FP_FAITHFUL_PROVEN_INEXACT || status == SOLLYA_FP_FAITHFUL;
+  }
+
+
   void FixFunction::eval(mpz_class x, mpz_class& rNorD, mpz_class& ru, bool correctlyRounded) const
   {
-    int precision = 100 * (wIn + wOut);
-    sollya_lib_set_prec(sollya_lib_constant_from_int(precision));
+    if(isTabulated(correctlyRounded) && x >= 0 && x < tabulatedRNorD[correctlyRounded].size()) {
+      rNorD = tabulatedRNorD[correctlyRounded][x.get_ui()];
+      if(!correctlyRounded) {
+        ru = tabulatedRU[0][x.get_ui()];
+      }
+      return;
+    }
 
-    mpfr_t mpX, mpR;
+    // This used to be the precision of every evaluation. It is now only the last resort of the adaptive loop below.
+    int maxPrecision = 100 * (wIn + wOut);
+    setSollyaPrecision(maxPrecision);
+
+    mpfr_t mpX, mpR, lo, hi;
     mpfr_init2(mpX, wIn + 2);
-    mpfr_init2(mpR, precision);
+    mpfr_init2(mpR, maxPrecision);
+    mpfr_init2(lo, maxPrecision);
+    mpfr_init2(hi, maxPrecision);
 
     if(signedIn) {
       mpz_class negateBit = mpz_class(1) << (wIn);
@@ -223,12 +246,50 @@ namespace flopoco
     mpfr_set_z(mpX, x.get_mpz_t(), GMP_RNDN);
     mpfr_div_2si(mpX, mpX, -lsbIn, GMP_RNDN);
 
-    /* Compute the function */
-    eval(mpR, mpX);
-    //		REPORT(LogLevel::FULL,"function() input is:"<<sPrintBinary(mpX));
-    //cerr << 100*(wIn+wOut) <<" function("<<mpfr_get_d(mpX, GMP_RNDN)<<") output before rounding is:"<<mpfr_get_d(mpR, GMP_RNDN) << " " ;
-    /* Compute the signal value */
-    mpfr_mul_2si(mpR, mpR, -lsbOut, GMP_RNDN);
+    /* Compute the function, Ziv style: a faithful evaluation at a precision slightly larger than wOut
+       is enough to round it to lsbOut, unless the result is very close to a rounding boundary.
+       In this case, double the precision and retry. */
+    int precision = std::min(wOut + 24, maxPrecision);
+    while(true) {
+      mpfr_set_prec(mpR, precision);
+      int status = sollya_lib_evaluate_function_at_point(mpR, fS, mpX, NULL);
+      //		REPORT(LogLevel::FULL,"function() input is:"<<sPrintBinary(mpX));
+      //cerr << precision <<" function("<<mpfr_get_d(mpX, GMP_RNDN)<<") output before rounding is:"<<mpfr_get_d(mpR, GMP_RNDN) << " " ;
+      /* Compute the signal value */
+      mpfr_mul_2si(mpR, mpR, -lsbOut, GMP_RNDN);
+      if(precision == maxPrecision) {
+        break; // as accurate as we ever were: round whatever we have
+      }
+      if(isFaithfulEvaluation(status)) {
+        // the exact result lies strictly between the neighbours of mpR: check that they round the same way
+        mpfr_set_prec(lo, precision);
+        mpfr_set_prec(hi, precision);
+        mpfr_set(lo, mpR, GMP_RNDN);
+        mpfr_set(hi, mpR, GMP_RNDN);
+        if(status != SOLLYA_FP_PROVEN_EXACT) {
+          mpfr_nextbelow(lo);
+          mpfr_nextabove(hi);
+        }
+        mpz_class loZ, hiZ;
+        bool roundingIsDecided;
+        if(correctlyRounded) {
+          mpfr_get_z(loZ.get_mpz_t(), lo, GMP_RNDN);
+          mpfr_get_z(hiZ.get_mpz_t(), hi, GMP_RNDN);
+          roundingIsDecided = (loZ == hiZ);
+        } else {
+          mpfr_get_z(loZ.get_mpz_t(), lo, GMP_RNDD);
+          mpfr_get_z(hiZ.get_mpz_t(), hi, GMP_RNDD);
+          roundingIsDecided = (loZ == hiZ);
+          mpfr_get_z(loZ.get_mpz_t(), lo, GMP_RNDU);
+          mpfr_get_z(hiZ.get_mpz_t(), hi, GMP_RNDU);
+          roundingIsDecided = roundingIsDecided && (loZ == hiZ);
+        }
+        if(roundingIsDecided) {
+          break;
+        }
+      }
+      precision = std::min(2 * precision, maxPrecision);
+    }
 
     /* So far we have a highly accurate evaluation. Rounding to target size happens only now
 		 */
@@ -251,7 +312,88 @@ namespace flopoco
     }
 
     //		REPORT(LogLevel::FULL,"function() output r = ["<<rd<<", " << ru << "]");
-    mpfr_clear(mpX);
-    mpfr_clear(mpR);
+    mpfr_clears(mpX, mpR, lo, hi, NULL);
+  }
+
+
+  std::string FixFunction::tableCacheKey(bool correctlyRounded) const
+  {
+    std::ostringstream key;
+    // The string as parsed by Sollya, so that formatting differences don't matter.
+    // The original string is kept too, as the parsing of decimal constants depends on the precision.
+    int size = sollya_lib_snprintf(NULL, 0, "%b", fS);
+    std::string parsed(size > 0 ? size + 1 : 1, '\0');
+    if(size > 0) {
+      sollya_lib_snprintf(&parsed[0], size + 1, "%b", fS);
+      parsed.resize(size);
+    }
+    key << "FixFunction f=" << sollyaString << " parsed=" << parsed << " signedIn=" << signedIn << " lsbIn=" << lsbIn
+        << " lsbOut=" << lsbOut << " rounding=" << (correctlyRounded ? "RN" : "RD,RU");
+    return key.str();
+  }
+
+
+  bool FixFunction::isTabulated(bool correctlyRounded) const
+  {
+    if(!tableLookedUp[correctlyRounded]) {
+      tableLookedUp[correctlyRounded] = true;
+      if(wIn > 0 && wIn <= 30 && DiskCache::isEnabled()) {
+        std::vector<std::vector<mpz_class>*> columns = {&tabulatedRNorD[correctlyRounded]};
+        if(!correctlyRounded) {
+          columns.push_back(&tabulatedRU[0]);
+        }
+        if(!DiskCache::loadTable(tableCacheKey(correctlyRounded), columns) || tabulatedRNorD[correctlyRounded].size() != (uint64_t(1) << wIn)) {
+          tabulatedRNorD[correctlyRounded].clear();
+        }
+      }
+    }
+    return !tabulatedRNorD[correctlyRounded].empty();
+  }
+
+
+  void FixFunction::evalAll(std::vector<mpz_class>& rNorD, std::vector<mpz_class>& ru, bool correctlyRounded, int workers) const
+  {
+    if(isTabulated(correctlyRounded)) {
+      rNorD = tabulatedRNorD[correctlyRounded];
+      if(!correctlyRounded) {
+        ru = tabulatedRU[0];
+      }
+      return;
+    }
+
+    uint64_t n = uint64_t(1) << wIn;
+    rNorD.resize(n);
+    if(!correctlyRounded) {
+      ru.resize(n);
+    }
+    runInWorkerProcesses(
+      n,
+      workers,
+      [&](uint64_t begin, uint64_t end, FILE* out) {
+        mpz_class r, u;
+        for(uint64_t i = begin; i < end; i++) {
+          eval(mpz_class((unsigned long)i), r, u, correctlyRounded);
+          mpz_out_raw(out, r.get_mpz_t());
+          if(!correctlyRounded) {
+            mpz_out_raw(out, u.get_mpz_t());
+          }
+        }
+      },
+      [&](uint64_t begin, uint64_t end, FILE* in) {
+        for(uint64_t i = begin; i < end; i++) {
+          mpz_inp_raw(rNorD[i].get_mpz_t(), in);
+          if(!correctlyRounded) {
+            mpz_inp_raw(ru[i].get_mpz_t(), in);
+          }
+        }
+      });
+
+    tabulatedRNorD[correctlyRounded] = rNorD;
+    std::vector<const std::vector<mpz_class>*> columns = {&rNorD};
+    if(!correctlyRounded) {
+      tabulatedRU[0] = ru;
+      columns.push_back(&ru);
+    }
+    DiskCache::storeTable(tableCacheKey(correctlyRounded), columns);
   }
 }  // namespace flopoco
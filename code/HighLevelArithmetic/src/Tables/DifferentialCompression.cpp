@@ -1,40 +1,82 @@
 #include "flopoco/Tables/DifferentialCompression.hpp"
-#include <iostream>
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <iostream>
 
 
 using std::pair;
 using std::make_pair;
 
 namespace flopoco {
-	using min_max_t = pair<mpz_class, mpz_class>;
+	/* The search is written once for two representations of the table values:
+		 machine words when they all fit (wOut < 64, so that no intermediate sum overflows), which is practically always the case,
+		 and mpz_class otherwise. The helpers below give both the same interface. */
+
+	template<typename T> T onesMask(int w);  // 2^w-1
+
+	template<> mpz_class onesMask<mpz_class>(int w)
+	{
+		return (mpz_class(1) << w) - 1;
+	}
+
+	template<> uint64_t onesMask<uint64_t>(int w)
+	{
+		return (w >= 64) ? ~uint64_t(0) : (uint64_t(1) << w) - 1;
+	}
+
+	// same convention as sizeInBits(mpz_class), including its value for 1
+	int bitsOf(mpz_class const & x)
+	{
+		return sizeInBits(x);
+	}
+
+	int bitsOf(uint64_t x)
+	{
+		return (x <= 1) ? 0 : 64 - __builtin_clzll(x);
+	}
+
+	vector<mpz_class> toMpz(vector<mpz_class> && v)
+	{
+		return std::move(v);
+	}
+
+	vector<mpz_class> toMpz(vector<uint64_t> && v)
+	{
+		vector<mpz_class> r(v.size());
+		for (size_t i = 0 ; i < v.size() ; ++i) {
+			mpz_import(r[i].get_mpz_t(), 1, -1, sizeof(v[i]), 0, 0, &v[i]);
+		}
+		return r;
+	}
 
 
 	// groupSlices computes the min and max of each slice.
-	// It is a recursive function 
-	// This is the base case
-	auto groupSlices(vector<mpz_class> const & values)
+	// initialSlices is the base case: each value is a slice
+	template<typename T>
+	auto initialSlices(vector<T> const & values)
 	{
-		vector<min_max_t> minmax(values.size());
+		vector<pair<T, T>> minmax(values.size());
 		for (size_t i = 0 ; i < values.size() ; ++i) {
 			minmax[i] = std::make_pair(values[i], values[i]);
 		}
-		return make_pair(minmax, mpz_class{0});
+		return make_pair(minmax, T{0});
 	}
 
 	// and this is the function that input a vector of minmax for slice parameter s
 	// and returns a vector (twice as small) for slice parameter s+1 
-	auto groupSlices(vector<min_max_t> const & in_minmax)
+	template<typename T>
+	auto groupSlices(vector<pair<T, T>> const & in_minmax)
 	{
 		auto out_minmax_size = in_minmax.size() / 2;
-		vector<min_max_t> out_minmax(out_minmax_size);
-		mpz_class max_dist{0};
+		vector<pair<T, T>> out_minmax(out_minmax_size);
+		T max_dist{0};
 
 		for (size_t i = 0 ; i < out_minmax_size ; i++) {
 			auto& [min_sl1, max_sl1] = in_minmax[i<<1];
 			auto& [min_sl2, max_sl2] = in_minmax[(i<<1) + 1];
-			auto minval = min(min_sl1, min_sl2);
-			auto maxval = max(max_sl1, max_sl2);
+			T minval = std::min<T>(min_sl1, min_sl2);
+			T maxval = std::max<T>(max_sl1, max_sl2);
 			if ((maxval - minval) > max_dist)
 					max_dist = maxval - minval;
 			out_minmax[i] = make_pair(minval, maxval);
@@ -43,7 +85,8 @@ namespace flopoco {
 	}
 
 
-	auto find_best_subconfig(vector<min_max_t> const & min_max, int const wIn, int const wOut, int const split, int const wL, mpz_class const best_cost, table_cost_function_t const cost_model, Target* const target)
+	template<typename T>
+	auto find_best_subconfig(vector<pair<T, T>> const & min_max, int const wIn, int const wOut, int const split, int const wL, mpz_class const best_cost, table_cost_function_t const cost_model, Target* const target)
 	{
 		auto wH_noOverlap = wOut - wL;
 		auto costFunction = [&](int wH)->mpz_class {
@@ -54,14 +97,13 @@ namespace flopoco {
 		auto bestWH = wH_noOverlap;
 		auto estimate = costFunction(wH_noOverlap);
 		bool overlapped = false;
-		mpz_class lowbit_mask{1};
-		lowbit_mask = (mpz_class(1) << wL)-1; 
+		T lowbit_mask = onesMask<T>(wL);
 		
-		mpz_class overflow_detect = lowbit_mask + 1;
+		T overflow_detect = lowbit_mask + 1;
 		for (auto const & [min, max] : min_max) {
-			mpz_class min_low_bits{min & lowbit_mask};
-			mpz_class delta{max - min};
-			mpz_class deltaWithLowBits{delta + min_low_bits};
+			T min_low_bits = min & lowbit_mask;
+			T delta = max - min;
+			T deltaWithLowBits = delta + min_low_bits;
 			// Assuption : increasing one size parameter, everything else constant, can only increase the cost
 			while (deltaWithLowBits >= overflow_detect) {
 				overlapped = true;
@@ -87,17 +129,15 @@ namespace flopoco {
 	 * @param wL Number of bits that are stored in the offset table
 	 * @return fitted wH
 	 */
-	auto compressHighTable(vector<min_max_t> const & min_max, int const wH, int const wL)
+	template<typename T>
+	auto compressHighTable(vector<pair<T, T>> const & min_max, int const wH, int const wL)
 	{
 		// Construct high bit masks with wH ones followed by wL zeroes
-		mpz_class high_bits_mask{1};
-		high_bits_mask <<= wH;
-		high_bits_mask -= 1;
-		high_bits_mask <<= wL;
+		T high_bits_mask = onesMask<T>(wH) << wL;
 
-		mpz_class or_acc{0};
+		T or_acc{0};
 		for (auto const &[min, max] : min_max) {
-			auto high_bits = (min) & high_bits_mask;
+			T high_bits = min & high_bits_mask;
 			assert(high_bits <= high_bits_mask && "There is probably an error on the choice of wH");
 			or_acc |= high_bits;
 		}
@@ -109,33 +149,30 @@ namespace flopoco {
 		return wH - zero_counter;
 	}
 
-	auto buildCompressedTable(vector<mpz_class> const & values, int const wOut, int const s, int const wH, int const wL)
+	template<typename T>
+	auto buildCompressedTable(vector<T> const & values, int const wOut, int const s, int const wH, int const wL)
 	{
 		auto size = values.size();
 		auto sssize = size >> s;
 		auto shift = 1 << s;
 		auto shift_h = wOut - wH;
-		vector<mpz_class> diff_table(size);
-		vector<mpz_class> subsamples_table(sssize);
-
-		mpz_class H_mask{1}, L_mask{1};
-		H_mask <<= wH;
-		H_mask -= 1;
-		H_mask <<= shift_h;
+		vector<T> diff_table(size);
+		vector<T> subsamples_table(sssize);
 
-		L_mask <<= wL;
+		T H_mask = onesMask<T>(wH) << shift_h;
+		T L_mask = onesMask<T>(wL) + 1;
 		for(size_t slice_idx = 0 ; slice_idx < sssize ; ++slice_idx) {
 			size_t val_idx = slice_idx << s;
-			mpz_class min{values[val_idx]};
+			T min{values[val_idx]};
 			for (size_t cur_idx = val_idx + 1 ; cur_idx < val_idx + shift ; cur_idx++) {
 				if (values[cur_idx] < min) {
 					min = values[cur_idx];
 				}
 			}
-			mpz_class high_bits = min & H_mask;
-			mpz_class low_bits = min - high_bits;
+			T high_bits = min & H_mask;
+			T low_bits = min - high_bits;
 			subsamples_table[slice_idx] = high_bits >> shift_h;
-			mpz_class to_sub = min - low_bits;
+			T to_sub = min - low_bits;
 			// cerr << "subsamples_table["<<slice_idx<<"] = \t" <<  subsamples_table[slice_idx]   << " \t\t to_sub=" << to_sub <<endl; 
 			for (size_t cur_idx = val_idx ; cur_idx < val_idx + shift ; cur_idx++) {
 				diff_table[cur_idx] = values[cur_idx] - to_sub;
@@ -147,9 +184,10 @@ namespace flopoco {
 	}
 
 
-	DifferentialCompression DifferentialCompression::find_differential_compression(vector<mpz_class> const & values, int wIn, int wOut, Target * target, table_cost_function_t costModel)
+	template<typename T>
+	DifferentialCompression findCompression(vector<T> const & values, int wIn, int wOut, Target * target, table_cost_function_t costModel)
 	{
-		auto [min_max, max_dist] = groupSlices(values);
+		auto [min_max, max_dist] = initialSlices(values);
 		auto costFunction = [&](int wB, int wH, int wL)->mpz_class{
 			auto costSubSampleSize = costModel(wB, wH, target);
 			auto costDiffTable = costModel(wIn, wL, target);
@@ -164,7 +202,7 @@ namespace flopoco {
 
 		for (int s = 1 ; s < wIn ; s++) {
 			std::tie(min_max, max_dist) = groupSlices(min_max);
-			auto minWL = sizeInBits(max_dist);
+			auto minWL = bitsOf(max_dist);
 			for (auto wL = minWL ; wL < wOut - 1 ; ++wL) {
 				auto [interestingSol, overlapped, costBestSol, bestLocalWH] = find_best_subconfig(
 						min_max,
@@ -196,7 +234,29 @@ namespace flopoco {
 
 		auto bestSS_cost = costModel(wIn-best_split, best_wh, target);
 		auto bestDiffCost = costModel(wIn, best_wl, target);
-		DifferentialCompression difcompress {best_subsampling, best_diff, wIn - best_split, best_wh, best_wl, wIn, wOut, original_cost, bestSS_cost, bestDiffCost};
+		return DifferentialCompression{toMpz(std::move(best_subsampling)), toMpz(std::move(best_diff)), wIn - best_split, best_wh, best_wl, wIn, wOut, original_cost, bestSS_cost, bestDiffCost};
+	}
+
+
+	DifferentialCompression DifferentialCompression::find_differential_compression(vector<mpz_class> const & values, int wIn, int wOut, Target * target, table_cost_function_t costModel)
+	{
+		vector<uint64_t> words;
+		if (wOut < 64) {
+			words.resize(values.size());
+			for (size_t i = 0 ; i < values.size() ; ++i) {
+				mpz_srcptr v = values[i].get_mpz_t();
+				if (mpz_sgn(v) < 0 || mpz_sizeinbase(v, 2) >= 64) {
+					words.clear();
+					break;
+				}
+				words[i] = 0;
+				mpz_export(&words[i], nullptr, -1, sizeof(words[i]), 0, 0, v);
+			}
+		}
+
+		DifferentialCompression difcompress = words.empty() ?
+			findCompression(values, wIn, wOut, target, costModel) :
+			findCompression(words, wIn, wOut, target, costModel);
 		assert(difcompress.getInitialTable() == values);
 		return difcompress;
 	}
@@ -207,6 +267,11 @@ namespace flopoco {
 		return find_differential_compression(values, wIn, wOut, target, cm);
 	}
 
+	DifferentialCompression DifferentialCompression::find_differential_compression_mpz(vector<mpz_class> const & values, int wIn, int wOut, Target * target, table_cost_function_t costModel)
+	{
+		return findCompression(values, wIn, wOut, target, costModel);
+	}
+
 	vector<mpz_class> DifferentialCompression::getInitialTable() const {
 		vector<mpz_class> reconstructedTable(1 << diffIndexSize);
 		int stride = diffIndexSize - subsamplingIndexSize;
@@ -38,7 +38,7 @@ namespace flopoco
 
 	void Table::initialize(std::vector<mpz_class> _values, int _wIn, int _minIn, int _maxIn) {
 		assert(!initialised && "Trying to initialise an already initialized Table");
-		values = _values;
+		values = std::move(_values);
 		wIn = _wIn;
 		minIn = _minIn;
 		maxIn = _maxIn;
@@ -56,23 +56,42 @@ namespace flopoco
 		assert(((unsigned)1 << wIn) >= values.size() &&
 		       "Incoherent wIn / number of values");
 
-		// determine the lowest and highest values stored in the table
-		mpz_class maxValue = values[0], minValue = values[0];
-
+		// determine the highest value stored in the table
 		// this assumes that the values stored in the values array are
 		// all positive
-		for (auto const &value : values) {
-			// TODO Handle the negative case : requires some
-			// rewriting of the VHDL ops counter part
-			assert(value >= 0 && "Tables cannot be initialized with negative values as of now");
-			if (maxValue < value)
-				maxValue = value;
-			if (minValue > value)
-				minValue = value;
+		// TODO Handle the negative case : requires some
+		// rewriting of the VHDL ops counter part
+		packedValues.resize(values.size());
+		uint64_t maxWord = 0;
+		for (size_t i = 0; i < values.size(); i++) {
+			mpz_srcptr v = values[i].get_mpz_t();
+			assert(mpz_sgn(v) >= 0 && "Tables cannot be initialized with negative values as of now");
+			if (mpz_sizeinbase(v, 2) > 64) {
+				packedValues.clear();
+				break;
+			}
+			// the limbs are 64-bit on the targets we support, but mpz_export does not assume it
+			uint64_t w = 0;
+			mpz_export(&w, nullptr, -1, sizeof(w), 0, 0, v);
+			packedValues[i] = w;
+			maxWord = std::max(maxWord, w);
 		}
 
 		// set wOut
-		wOut = sizeInBits(maxValue);
+		if (isPacked()) {
+			mpz_class maxValue;
+			mpz_import(maxValue.get_mpz_t(), 1, -1, sizeof(maxWord), 0, 0, &maxWord);
+			wOut = sizeInBits(maxValue);
+		}
+		else {
+			mpz_class maxValue = values[0];
+			for (auto const &value : values) {
+				assert(value >= 0 && "Tables cannot be initialized with negative values as of now");
+				if (maxValue < value)
+					maxValue = value;
+			}
+			wOut = sizeInBits(maxValue);
+		}
 
 		if (minIn < 0) {
 			minIn = 0;
@@ -0,0 +1,332 @@
+#include "flopoco/Tools/DiskCache.hpp"
+#include "flopoco/report.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace flopoco {
+
+	namespace {
+		const std::string tableMagic = "FloPoCo table cache v1\n";
+		const std::string entryMagic = "FloPoCo entry cache v1\n";
+
+		void appendWord(std::string& s, uint64_t w)
+		{
+			s.append(reinterpret_cast<const char*>(&w), sizeof(w));
+		}
+
+		/** reads a 64-bit word at position pos of a buffer of the given size, returns false if out of bounds */
+		bool readWord(const char* buffer, size_t size, size_t& pos, uint64_t& w)
+		{
+			if(pos + sizeof(w) > size) {
+				return false;
+			}
+			memcpy(&w, buffer + pos, sizeof(w));
+			pos += sizeof(w);
+			return true;
+		}
+
+		std::atomic<bool> memoryCacheEnabled(false);
+		/** guards memoryTables and memoryEntries: the cache is used by the threads of the compression race, the beam search and AutoTest */
+		std::mutex memoryMutex;
+		/** the tables kept in memory, indexed by their key */
+		std::map<std::string, std::vector<std::vector<mpz_class>>> memoryTables;
+		/** the free-form entries kept in memory, indexed by their extension and key */
+		std::map<std::pair<std::string, std::string>, std::string> memoryEntries;
+		/** larger tables are only kept on disk */
+		const uint64_t maxMemoryTableRows = uint64_t(1) << 24;
+		/** longer keys are truncated in the index */
+		const size_t maxIndexKeySize = 256;
+		/** numbers the temporary files of this process, so that its threads do not write to the same one */
+		std::atomic<uint64_t> tmpFileCounter(0);
+	} // namespace
+
+
+	bool DiskCache::isEnabled()
+	{
+		return memoryCacheEnabled || isPersistent();
+	}
+
+
+	bool DiskCache::isPersistent()
+	{
+		const char* dir = getenv("FLOPOCO_CACHE_DIR");
+		return dir != nullptr && dir[0] != 0;
+	}
+
+
+	void DiskCache::enableMemoryCache()
+	{
+		memoryCacheEnabled = true;
+	}
+
+
+	std::string DiskCache::directory()
+	{
+		if(!isPersistent()) {
+			return "";
+		}
+		std::string dir = getenv("FLOPOCO_CACHE_DIR");
+		std::error_code ec;
+		fs::create_directories(dir, ec);
+		return dir;
+	}
+
+
+	uint64_t DiskCache::hash(const std::string& s)
+	{
+		uint64_t h = 0xcbf29ce484222325ULL;
+		for(unsigned char c: s) {
+			h ^= c;
+			h *= 0x100000001b3ULL;
+		}
+		return h;
+	}
+
+
+	std::string DiskCache::entryPath(const std::string& key, const std::string& extension)
+	{
+		std::ostringstream name;
+		name << std::hex;
+		name.width(16);
+		name.fill('0');
+		name << hash(key);
+		return (fs::path(directory()) / (name.str() + extension)).string();
+	}
+
+
+	bool DiskCache::writeAtomically(const std::string& path, const std::string& contents)
+	{
+		std::string tmpPath = path + ".tmp" + std::to_string(getpid()) + "." + std::to_string(tmpFileCounter++);
+		{
+			std::ofstream file(tmpPath, std::ios::out | std::ios::binary | std::ios::trunc);
+			if(!file) {
+				REPORT(LogLevel::DETAIL, "DiskCache: unable to write " << tmpPath);
+				return false;
+			}
+			file.write(contents.data(), contents.size());
+			if(!file) {
+				file.close();
+				std::remove(tmpPath.c_str());
+				return false;
+			}
+		}
+		if(std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+			std::remove(tmpPath.c_str());
+			return false;
+		}
+		return true;
+	}
+
+
+	void DiskCache::appendToIndex(const std::string& path, const std::string& key)
+	{
+		std::string line = fs::path(path).filename().string() + "\t" + key.substr(0, maxIndexKeySize);
+		if(key.size() > maxIndexKeySize) {
+			line += "...";
+		}
+		std::replace(line.begin(), line.end(), '\n', ' ');
+		line += "\n";
+		// a single append, so that the lines of concurrent processes do not interleave
+		int fd = open((fs::path(directory()) / "index").c_str(), O_WRONLY | O_APPEND | O_CREAT, 0644);
+		if(fd < 0) {
+			return;
+		}
+		if(write(fd, line.data(), line.size()) != (ssize_t)line.size()) {
+			REPORT(LogLevel::DETAIL, "DiskCache: unable to update the index");
+		}
+		close(fd);
+	}
+
+
+	void DiskCache::storeInMemory(const std::string& key, const std::vector<const std::vector<mpz_class>*>& columns)
+	{
+		if(!memoryCacheEnabled || columns.empty() || columns[0]->size() > maxMemoryTableRows) {
+			return;
+		}
+		std::lock_guard<std::mutex> lock(memoryMutex);
+		std::vector<std::vector<mpz_class>>& table = memoryTables[key];
+		table.clear();
+		for(auto c: columns) {
+			table.push_back(*c);
+		}
+	}
+
+
+	bool DiskCache::loadTable(const std::string& key, const std::vector<std::vector<mpz_class>*>& columns)
+	{
+		{
+			std::lock_guard<std::mutex> lock(memoryMutex);
+			auto it = memoryTables.find(key);
+			if(it != memoryTables.end() && it->second.size() == columns.size()) {
+				for(size_t j = 0; j < columns.size(); j++) {
+					*columns[j] = it->second[j];
+				}
+				REPORT(LogLevel::DETAIL, "DiskCache: table found in memory");
+				return true;
+			}
+		}
+		if(!isPersistent()) {
+			return false;
+		}
+		std::string path = entryPath(key, ".table");
+		int fd = open(path.c_str(), O_RDONLY);
+		if(fd < 0) {
+			return false;
+		}
+		struct stat st;
+		if(fstat(fd, &st) != 0 || st.st_size == 0) {
+			close(fd);
+			return false;
+		}
+		size_t size = st.st_size;
+		void* map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+		close(fd);
+		if(map == MAP_FAILED) {
+			return false;
+		}
+		const char* buffer = static_cast<const char*>(map);
+
+		bool hit = false;
+		size_t pos = tableMagic.size();
+		uint64_t keySize, rows, numberOfColumns, bytesPerValue;
+		if(size >= pos && memcmp(buffer, tableMagic.data(), pos) == 0 && readWord(buffer, size, pos, keySize) && pos + keySize <= size
+			 && key.compare(0, std::string::npos, buffer + pos, keySize) == 0) {
+			pos += keySize;
+			if(readWord(buffer, size, pos, rows) && readWord(buffer, size, pos, numberOfColumns) && readWord(buffer, size, pos, bytesPerValue)
+				 && numberOfColumns == columns.size() && bytesPerValue > 0 && (size - pos) / bytesPerValue / numberOfColumns >= rows) {
+				for(auto c: columns) {
+					c->resize(rows);
+				}
+				for(uint64_t i = 0; i < rows; i++) {
+					for(auto c: columns) {
+						mpz_import((*c)[i].get_mpz_t(), 1, -1, bytesPerValue, -1, 0, buffer + pos);
+						pos += bytesPerValue;
+					}
+				}
+				hit = true;
+			}
+		}
+		munmap(map, size);
+		if(hit) {
+			REPORT(LogLevel::DETAIL, "DiskCache: table found in " << path);
+			storeInMemory(key, std::vector<const std::vector<mpz_class>*>(columns.begin(), columns.end()));
+		}
+		return hit;
+	}
+
+
+	void DiskCache::storeTable(const std::string& key, const std::vector<const std::vector<mpz_class>*>& columns)
+	{
+		storeInMemory(key, columns);
+		if(!isPersistent() || columns.empty()) {
+			return;
+		}
+		uint64_t rows = columns[0]->size();
+		size_t bits = 1;
+		for(auto c: columns) {
+			for(auto& v: *c) {
+				if(v < 0) {
+					REPORT(LogLevel::DEBUG, "DiskCache: not storing a table with negative values");
+					return;
+				}
+				bits = std::max(bits, mpz_sizeinbase(v.get_mpz_t(), 2));
+			}
+		}
+		uint64_t bytesPerValue = (bits + 7) / 8;
+
+		std::string contents = tableMagic;
+		appendWord(contents, key.size());
+		contents += key;
+		appendWord(contents, rows);
+		appendWord(contents, columns.size());
+		appendWord(contents, bytesPerValue);
+		size_t pos = contents.size();
+		contents.resize(pos + rows * columns.size() * bytesPerValue, 0);
+		for(uint64_t i = 0; i < rows; i++) {
+			for(auto c: columns) {
+				mpz_export(&contents[pos], nullptr, -1, 1, -1, 0, (*c)[i].get_mpz_t());
+				pos += bytesPerValue;
+			}
+		}
+		std::string path = entryPath(key, ".table");
+		if(writeAtomically(path, contents)) {
+			REPORT(LogLevel::DETAIL, "DiskCache: table stored in " << path);
+			appendToIndex(path, key);
+		}
+	}
+
+
+	bool DiskCache::loadEntry(const std::string& key, const std::string& extension, std::string& contents)
+	{
+		{
+			std::lock_guard<std::mutex> lock(memoryMutex);
+			auto it = memoryEntries.find(std::make_pair(extension, key));
+			if(it != memoryEntries.end()) {
+				contents = it->second;
+				REPORT(LogLevel::DETAIL, "DiskCache: " << extension << " entry found in memory");
+				return true;
+			}
+		}
+		if(!isPersistent()) {
+			return false;
+		}
+		std::string path = entryPath(key, extension);
+		std::ifstream file(path, std::ios::in | std::ios::binary);
+		if(!file) {
+			return false;
+		}
+		std::ostringstream buffer;
+		buffer << file.rdbuf();
+		std::string data = buffer.str();
+
+		size_t pos = entryMagic.size();
+		uint64_t keySize;
+		if(data.compare(0, pos, entryMagic) != 0 || !readWord(data.data(), data.size(), pos, keySize) || pos + keySize > data.size()
+			 || data.compare(pos, keySize, key) != 0) {
+			return false;
+		}
+		contents = data.substr(pos + keySize);
+		REPORT(LogLevel::DETAIL, "DiskCache: entry found in " << path);
+		if(memoryCacheEnabled) {
+			std::lock_guard<std::mutex> lock(memoryMutex);
+			memoryEntries[std::make_pair(extension, key)] = contents;
+		}
+		return true;
+	}
+
+
+	void DiskCache::storeEntry(const std::string& key, const std::string& extension, const std::string& contents)
+	{
+		if(memoryCacheEnabled) {
+			std::lock_guard<std::mutex> lock(memoryMutex);
+			memoryEntries[std::make_pair(extension, key)] = contents;
+		}
+		if(!isPersistent()) {
+			return;
+		}
+		std::string data = entryMagic;
+		appendWord(data, key.size());
+		data += key;
+		data += contents;
+		std::string path = entryPath(key, extension);
+		if(writeAtomically(path, data)) {
+			REPORT(LogLevel::DETAIL, "DiskCache: entry stored in " << path);
+			appendToIndex(path, key);
+		}
+	}
+
+} // namespace flopoco
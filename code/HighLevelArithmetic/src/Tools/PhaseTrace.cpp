@@ -0,0 +1,139 @@
+#include "flopoco/Tools/PhaseTrace.hpp"
+#include "flopoco/report.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace flopoco {
+
+	namespace {
+		struct Event {
+			const char* phase;
+			std::string object;
+			int64_t start;
+			int64_t duration;
+			size_t thread;
+		};
+
+		bool traceEnabled = false;
+		std::string traceFileName;
+		pid_t tracePid;                 // forked children do not write the trace of their parent
+		std::chrono::steady_clock::time_point origin;
+		std::vector<Event> events;
+		std::mutex eventsMutex;
+
+		/** escapes a string for a JSON string literal, or a CSV quoted field */
+		std::string escape(const std::string& s, bool json)
+		{
+			std::ostringstream o;
+			for(char c: s) {
+				if(c == '"')
+					o << (json ? "\\\"" : "\"\"");
+				else if(json && c == '\\')
+					o << "\\\\";
+				else if(json && (unsigned char)c < 0x20)
+					o << ' ';
+				else
+					o << c;
+			}
+			return o.str();
+		}
+
+		void writeAtExit()
+		{
+			PhaseTrace::write();
+		}
+	} // namespace
+
+
+	void PhaseTrace::enable(const std::string& fileName)
+	{
+		if(!traceEnabled) {
+			origin = std::chrono::steady_clock::now();
+			tracePid = getpid();
+			std::atexit(writeAtExit);
+		}
+		traceEnabled = true;
+		traceFileName = fileName;
+	}
+
+
+	bool PhaseTrace::isEnabled()
+	{
+		return traceEnabled;
+	}
+
+
+	int64_t PhaseTrace::now()
+	{
+		return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - origin).count();
+	}
+
+
+	void PhaseTrace::record(const char* phase, const std::string& object, int64_t start, int64_t duration)
+	{
+		size_t thread = std::hash<std::thread::id>{}(std::this_thread::get_id());
+		std::lock_guard<std::mutex> lock(eventsMutex);
+		events.push_back({phase, object, start, duration, thread});
+	}
+
+
+	void PhaseTrace::write()
+	{
+		if(!traceEnabled || getpid() != tracePid)
+			return;
+		std::lock_guard<std::mutex> lock(eventsMutex);
+		std::ofstream file(traceFileName);
+		if(!file) {
+			REPORT(LogLevel::ERROR, "Cannot write the phase trace to " << traceFileName);
+			return;
+		}
+		bool csv = traceFileName.size() >= 4 && traceFileName.substr(traceFileName.size()-4) == ".csv";
+		if(csv) {
+			file << "phase,object,start_us,duration_us" << std::endl;
+			for(auto const & e: events)
+				file << e.phase << ",\"" << escape(e.object, false) << "\"," << e.start << "," << e.duration << std::endl;
+		}
+		else {
+			// Chrome trace format: one complete event ("ph":"X") per phase; threads get small ids in order of appearance
+			std::vector<size_t> threads;
+			file << "{\"traceEvents\":[" << std::endl;
+			for(size_t i = 0; i < events.size(); i++) {
+				auto const & e = events[i];
+				size_t tid = 0;
+				while(tid < threads.size() && threads[tid] != e.thread)
+					tid++;
+				if(tid == threads.size())
+					threads.push_back(e.thread);
+				file << "{\"name\":\"" << e.phase << "\",\"cat\":\"flopoco\",\"ph\":\"X\",\"ts\":" << e.start
+						 << ",\"dur\":" << e.duration << ",\"pid\":" << tracePid << ",\"tid\":" << tid
+						 << ",\"args\":{\"object\":\"" << escape(e.object, true) << "\"}}"
+						 << (i + 1 < events.size() ? "," : "") << std::endl;
+			}
+			file << "]}" << std::endl;
+		}
+		REPORT(LogLevel::DETAIL, "Phase trace of " << events.size() << " events written to " << traceFileName);
+	}
+
+
+	PhaseTrace::Scope::Scope(const char* phase_):
+		phase(phase_), start(0), active(traceEnabled)
+	{
+		if(active)
+			start = now();
+	}
+
+
+	PhaseTrace::Scope::~Scope()
+	{
+		if(active)
+			record(phase, object, start, now() - start);
+	}
+
+} // namespace flopoco
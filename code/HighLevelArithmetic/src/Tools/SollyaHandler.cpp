@@ -13,4 +13,14 @@ detail::SollyaLifetimeManager::~SollyaLifetimeManager() { sollya_lib_close(); }
 
 SollyaHandler::SollyaHandler(sollya_obj_t managed)
     : manager{managed, delete_sollya_obj_t} {}
+
+void setSollyaPrecision(int precision) {
+  static int current = 0;
+  if (precision != current) {
+    sollya_obj_t precS = sollya_lib_constant_from_int(precision);
+    sollya_lib_set_prec(precS);
+    sollya_lib_clear_obj(precS);
+    current = precision;
+  }
+}
 } // namespace archgenlib
@@ -0,0 +1,88 @@
+#include "flopoco/Tools/WorkerProcesses.hpp"
+#include "flopoco/report.hpp"
+
+#include <string>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+namespace flopoco {
+
+  namespace {
+    struct Slice {
+      uint64_t begin;
+      uint64_t end;
+      FILE* file;
+      pid_t pid; /**< -1 if the slice was produced by the calling process */
+    };
+
+    FILE* newTemporaryFile()
+    {
+      FILE* f = tmpfile();
+      if(f == nullptr) {
+        throw std::string("runInWorkerProcesses: unable to create a temporary file");
+      }
+      return f;
+    }
+  } // namespace
+
+  void runInWorkerProcesses(uint64_t n, int workers, slice_producer_t produce, slice_consumer_t consume)
+  {
+    if(n == 0) {
+      return;
+    }
+    uint64_t w = (workers > 1 ? workers : 1);
+    if(w > n) {
+      w = n;
+    }
+    // Otherwise buffered output would be written once by each worker
+    std::cout.flush();
+    std::cerr.flush();
+    fflush(nullptr);
+
+    std::vector<Slice> slices;
+    for(uint64_t k = 0; k < w; k++) {
+      Slice s{n * k / w, n * (k + 1) / w, newTemporaryFile(), -1};
+      if(w > 1) {
+        s.pid = fork();
+      }
+      if(s.pid == 0) {
+        // In the worker. _exit() skips the atexit handlers (sollya_lib_close etc.) of the parent
+        int status = 0;
+        try {
+          produce(s.begin, s.end, s.file);
+          if(fflush(s.file) != 0) {
+            status = 1;
+          }
+        } catch(...) {
+          status = 1;
+        }
+        _exit(status);
+      }
+      if(s.pid < 0) {
+        if(w > 1) {
+          REPORT(LogLevel::DETAIL, "runInWorkerProcesses: fork() failed, computing slice [" << s.begin << ", " << s.end << ") sequentially");
+        }
+        produce(s.begin, s.end, s.file);
+      }
+      slices.push_back(s);
+    }
+
+    for(auto& s: slices) {
+      if(s.pid > 0) {
+        int status;
+        if(waitpid(s.pid, &status, 0) != s.pid || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+          REPORT(LogLevel::DETAIL, "runInWorkerProcesses: worker " << s.pid << " failed, computing slice [" << s.begin << ", " << s.end << ") sequentially");
+          fclose(s.file);
+          s.file = newTemporaryFile();
+          produce(s.begin, s.end, s.file);
+        }
+      }
+      rewind(s.file);
+      consume(s.begin, s.end, s.file);
+      fclose(s.file);
+    }
+  }
+
+} // namespace flopoco
@@ -6,23 +6,18 @@
 
 namespace fs = std::filesystem;
 
-namespace {
-    flopoco::LogLevel loglevel{flopoco::MESSAGE};
+namespace flopoco::detail {
+    LogLevel loglevel{MESSAGE};
 }
 
 namespace flopoco {
 
-  bool is_log_lvl_enabled(LogLevel lvl) {
-    return lvl <= loglevel;
-  }
-
-
   void set_log_lvl(LogLevel lvl) {
-    loglevel = lvl;
+    detail::loglevel = lvl;
   }
 
   LogLevel get_log_lvl() {
-    return loglevel;
+    return detail::loglevel;
   }
 
     void report (LogLevel lvl, std::string const & message, std::string const & filename, int line, std::string const & funcname) {
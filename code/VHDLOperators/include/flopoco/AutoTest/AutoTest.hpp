@@ -26,8 +26,10 @@ public:
      * @brief AutoTest
      * @param opName
      * @param testLevel
+     * @param output
+     * @param jobs number of tests run concurrently
      */
-    AutoTest(std::string opName, const int testLevel, string output);
+    AutoTest(std::string opName, const int testLevel, string output, int jobs = 1);
     /**
      * @brief parseArguments
      * @param parentOp
@@ -54,6 +54,8 @@ enum BitType : unsigned;
 		friend class ParandehAfsharCompressionStrategy;
 		friend class MaxEfficiencyCompressionStrategy;
 		friend class OptimalCompressionStrategy;
+		//bits are allocated in the arena of their bitheap
+		friend class Bit;
 		/**
 		 * @brief The constructor for an signed/unsigned integer bitheap
 		 * @param op                the operator in which the bitheap is being built
@@ -399,6 +401,21 @@ enum BitType : unsigned;
 		 */
 		static bool lexicographicOrdering(const Bit* bit1, const Bit* bit2);
 
+		/**
+		 * @brief allocates a new bit in the arena of this bitheap. The bit's constructor declares its signal
+		 */
+		Bit* newBit(string rhsAssignment, int weight, BitType type);
+
+		/**
+		 * @brief allocates a copy of a bit in the arena of this bitheap (see Bit::clone())
+		 */
+		Bit* newBit(const Bit& bit);
+
+		/**
+		 * @brief returns the chunk of the arena in which the next bit is allocated
+		 */
+		vector<Bit>& arenaChunk();
+
 
 	public:
 		int msb;                                    /**< The maximum position a bit can have inside the bitheap */
@@ -417,6 +434,8 @@ enum BitType : unsigned;
 																									 ordered into columns by position in the bitheap (vector[0] corresponds to lsb),
 														 and ordered in each column by arrival time of the bits, i.e. lexicographic order on (cycle, cp). */
 		vector<vector<Bit*> > history;              /**< All the bits that have been added (and possibly removed at some point) to the bitheap. */
+		vector<vector<Bit> > bitArena;              /**< The storage of all the bits of this bitheap, freed with it. Each chunk is allocated once with its final capacity,
+														 so that the pointers to its bits stay valid; chunks grow geometrically with the size of the bitheap */
 		mpz_class constantBits;						          /**< The sum of all the constant bits that need to be added to the bit heap
 												   (constants added to the bitheap, for rounding, two's complement etc)
 												   It is stored as an integer, whose LSB corresponds to the position lsb of the bitheap */
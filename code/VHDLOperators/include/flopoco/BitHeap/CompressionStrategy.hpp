@@ -4,6 +4,7 @@
 
 #include <vector>
 #include <sstream>
+#include <functional>
 
 #include "flopoco/Operator.hpp"
 
@@ -25,6 +26,8 @@ class BitheapPlotter;
 
 	class CompressionStrategy
 	{
+		friend class RaceCompressionStrategy;
+
 	public:
 
 		/**
@@ -35,7 +38,7 @@ class BitheapPlotter;
 		/**
 		 * Destructor
 		 */
-		~CompressionStrategy();
+		virtual ~CompressionStrategy();
 
 
 		/**
@@ -52,6 +55,17 @@ class BitheapPlotter;
 		 */
 		virtual void compressionAlgorithm() = 0;
 
+		/**
+		 * @brief generates the compressor tree on bitAmount and fills solution, without writing VHDL.
+		 * Only the strategies working on bitAmount implement it, and may then take part in a compression race
+		 */
+		virtual void buildSolution();
+
+		/**
+		 * @brief throws if outOfBudget is set and returns true. Called by buildSolution() at the start of each stage
+		 */
+		void checkBudget();
+
 		/**
 		 * @brief start a new round of compression of the bitheap using compressors
 		 *        only bits that are within at most a given delay from the soonest
@@ -228,6 +242,11 @@ class BitheapPlotter;
           */
         void printSolutionStatistics();
 
+        /**
+          * @brief returns the area of the compressors of solution, in LUT-equivalents
+          */
+        unsigned int getSolutionArea();
+
         /**
           * @brief Check, if the stage of the BitHeap before the final adder has a height <= adderHeight
           * except the LSB column, where one additional bit can be processed due to the Cin input
@@ -259,6 +278,7 @@ class BitheapPlotter;
 		vector<vector<vector<Bit*> > > orderedBits; /**< The bits of the bitheap ordered by stages. First dimension is the stage, second the column */
 
 		vector<vector<int> > bitAmount; 			/**< Amount of bits in each stage and column. The compression strategies (currently FirstFitting does not) work on this bitAmount, and if a solution is finished, the compressors will be used. */
+		std::function<bool()> outOfBudget;           /**< When set, buildSolution() gives up as soon as it returns true (used by the compression race) */
 
 		BitHeapSolution solution;
 
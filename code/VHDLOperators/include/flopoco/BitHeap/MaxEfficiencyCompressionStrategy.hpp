@@ -25,6 +25,11 @@ class BitHeap;
 		 */
 		void compressionAlgorithm();
 
+		/**
+		 *	@brief orders the compressors and fills solution from bitAmount. No VHDL-Code is written here.
+		 */
+		void buildSolution();
+
 		/**
 		 * generates the compressor tree
 		 */
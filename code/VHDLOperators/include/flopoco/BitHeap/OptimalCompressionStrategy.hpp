@@ -37,12 +37,31 @@ class BitHeap;
 		 */
 		void compressionAlgorithm();
 
+		void resizeBitAmount(unsigned int stages);
+
+		/**
+		 *	@brief returns the DiskCache key of the compression problem: the bits of the bitheap, the compressors and the target
+		 */
+		string cacheKey();
+
+		/**
+		 *	@brief replays the compressor tree stored under key in the DiskCache, if any, without building the ILP model
+		 */
+		bool loadCachedSolution(const string& key);
+
+		/**
+		 *	@brief stores the solution filled by fillSolutionFromILP() under key in the DiskCache
+		 */
+		void storeSolution(const string& key);
+
+		vector<vector<unsigned int> > compressorCounts; /* the compressors of the solution as {stage, compressor index, column, amount}, as stored in the DiskCache */
+
+		vector<vector<int> > emptyInputs; /* the empty inputs of the solution per stage, as passed to setEmptyInputsByRemainingBits() */
+
 #ifdef HAVE_SCALP
 
 		bool optimalGeneration(unsigned int stages = 0, bool optimalMinStages = false);
 
-		void resizeBitAmount(unsigned int stages);
-
 		void initializeSolver();
 
 		/**
@@ -117,6 +136,8 @@ class BitHeap;
 
 		BasicCompressor* flipflop;
 
+		bool solutionIsOptimal; /* true if the last solve() proved the optimality of its solution */
+
 #endif //HAVE_SCALP
 
 	};
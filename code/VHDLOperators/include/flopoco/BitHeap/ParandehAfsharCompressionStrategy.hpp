@@ -24,6 +24,11 @@ class BitHeap;
 		 */
 		void compressionAlgorithm();
 
+		/**
+		 *	@brief orders the compressors and fills solution from bitAmount. No VHDL-Code is written here.
+		 */
+		void buildSolution();
+
 		/**
 		 *	@brief returns the compressor to be used in a given stage and column. Returns nullptr,
 		 * 		if there is no suitable compressor. Second argueent of the pair is the column, where
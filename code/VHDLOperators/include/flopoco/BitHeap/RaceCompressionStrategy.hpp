@@ -0,0 +1,43 @@
+#ifndef RACECOMPRESSIONSTRATEGY_HPP
+#define RACECOMPRESSIONSTRATEGY_HPP
+
+#include "flopoco/BitHeap/CompressionStrategy.hpp"
+#include "flopoco/BitHeap/BitHeap.hpp"
+
+namespace flopoco
+{
+
+class BitHeap;
+
+	/**
+	 * Runs the strategies working on bitAmount concurrently, each on its own copy of bitAmount,
+	 * and applies to the bitheap only the solution with the smallest area (then the fewest stages).
+	 * Once the time budget is spent, the candidates still running give up, unless none has finished yet.
+	 */
+	class RaceCompressionStrategy : public CompressionStrategy
+	{
+	public:
+
+		/**
+		 * A basic constructor for a compression strategy
+		 */
+		RaceCompressionStrategy(BitHeap *bitheap);
+
+		/**
+		 * Destructor, deletes the candidates
+		 */
+		~RaceCompressionStrategy();
+
+		static const int budget = 10; /**< The wall-clock time budget of the race, in seconds */
+
+	private:
+		/**
+		 *	@brief starts the compression algorithm. It will call buildSolution() of each candidate strategy
+		 */
+		void compressionAlgorithm();
+
+		vector<CompressionStrategy*> candidates; /**< The competing strategies. The solution of the winner points to its compressors, so they live as long as this strategy */
+	};
+
+}
+#endif
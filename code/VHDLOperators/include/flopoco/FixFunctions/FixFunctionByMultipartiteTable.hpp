@@ -96,6 +96,20 @@ namespace flopoco
 		vector<Multipartite*> topTen; /**< the top 10 best candidates (for some value of ten), sorted by size */ 
 		int guardBitsSlack; /* this allows first to try the exploration with one guard bit less than the safe value */ 
 		void insertInTopTen(Multipartite* mp);
+
+		/**
+		 * @brief firstValidCandidate : runs the exhaustive tests of the candidates of topTen, in parallel on worker processes.
+		 * A worker skips the candidates ranked after one that already passed.
+		 * @return the rank of the best candidate that passes its exhaustive test, or ten if none does
+		 */
+		int firstValidCandidate();
+
+		/**
+		 * @brief buildExhaustiveTestReference : evaluates f on every input, in parallel on worker processes.
+		 * Done once, before the exhaustive tests, which all compare to these values
+		 */
+		void buildExhaustiveTestReference();
+		vector<double> exhaustiveTestReference; /**< f(x) for every input x, as needed by Multipartite::exhaustiveTest() */
 	};
 
 }
@@ -2,6 +2,7 @@
 #define _PIECEWISEPOLYAPPROX_HPP_
 
 #include <iostream>
+#include <map>
 #include <string>
 
 #include <gmpxx.h>
@@ -28,13 +29,14 @@ namespace flopoco{
 
 		/**
 		 * A minimal constructor
+		 * @param workers the number of worker processes computing the polynomials of the subintervals
 		 */
-		UniformPiecewisePolyApprox(FixFunction* f, double targetAccuracy, int degree);
+		UniformPiecewisePolyApprox(FixFunction* f, double targetAccuracy, int degree, int workers=1);
 
 		/**
 		 * A minimal constructor that parses a sollya string
 		 */
-		UniformPiecewisePolyApprox(string sollyaString, double targetAccuracy, int degree);
+		UniformPiecewisePolyApprox(string sollyaString, double targetAccuracy, int degree, int workers=1);
 
 		virtual ~UniformPiecewisePolyApprox();
 
@@ -65,23 +67,41 @@ namespace flopoco{
 		sollya_obj_t buildSubIntervalFunction(sollya_obj_t fS, int alpha, int i);
 
 		/**
-		 * a local function to open the cache file, and create it if necessary
-		 * @param cacheFileName the name of the cache file
+		 * does guessDegree find that the subinterval i of 2^alpha can be approximated with a polynomial of degree degree?
+		 * The answers are memoized, so that the alpha search never asks twice
 		 */
-		void openCacheFile(string cacheFileName);
+		bool subIntervalFits(sollya_obj_t rangeS, int alpha, int i);
 
 		/**
-		 * a local function to write the polynomials' parameters to the cache file
-		 * @param cacheFileName the name of the cache file
+		 * the smallest alpha such that all the subintervals fit, according to subIntervalFits().
+		 * An exponential then binary search on the two extreme subintervals, where the worst case typically is,
+		 * then all the subintervals are checked, increasing alpha as long as one of them does not fit
 		 */
-		void writeToCacheFile(string cacheFileName);
+		int searchAlpha(sollya_obj_t rangeS);
 
 		/**
-		 * a local function to read the polynomials' parameters from the cache file
-		 * @param cacheFileName the number of intervals the domain is split into
-		 * @nbIntervals number of intervals, used in build() function
+		 * computes the polynomials of all the subintervals for the current alpha and LSB, on worker processes.
+		 * On success, fills poly and MSB. Otherwise returns false, after computing as few polynomials as possible
 		 */
-		void readFromCacheFile(string cacheFileName);
+		bool computePolynomials();
+
+		/**
+		 * the DiskCache key of the approximation: the normalized function, its interval, the degree and the target accuracy
+		 */
+		string cacheKey();
+
+		/**
+		 * a local function to write the polynomials' parameters to the cache
+		 * @param key the cache key
+		 */
+		void writeToCache(string key);
+
+		/**
+		 * a local function to read the polynomials' parameters from the cache
+		 * @param key the cache key
+		 * @return false if there is no such entry
+		 */
+		bool readFromCache(string key);
 
 		/**
 		 * check whether all the coefficients of a given degree are of the same sign
@@ -102,8 +122,9 @@ namespace flopoco{
 		string uniqueName_;                /**< useful only to enable same kind of reporting as for FloPoCo operators. */
 		bool needToFreeF;                  /**< in an ideal world, this should not be needed */
 
-		fstream cacheFile;                 /**< file storing the cached parameters for the polynomials */
 		int nbIntervals;                   /**< the total number of intervals the domain is split into */
+		int workers;                       /**< the number of worker processes for fpminimax */
+		map<pair<int,int>, bool> subIntervalFitsCache; /**< the memoized answers of subIntervalFits(), indexed by (alpha, i) */
 	};
 
 }
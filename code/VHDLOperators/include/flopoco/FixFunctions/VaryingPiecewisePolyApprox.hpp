@@ -68,23 +68,22 @@ namespace flopoco{
 	        sollya_obj_t buildFinalSubIntervalFunction(sollya_obj_t fS, int i);
 
 		/**
-		 * a local function to open the cache file, and create it if necessary
-		 * @param cacheFileName the name of the cache file
+		 * the DiskCache key of the approximation: the normalized function, its interval, lsbIn, lsbOut and the target accuracy
 		 */
-		void openCacheFile(string cacheFileName);
+		string cacheKey();
 
 		/**
-		 * a local function to write the polynomials' parameters to the cache file
-		 * @param cacheFileName the name of the cache file
+		 * a local function to write the polynomials' parameters to the cache
+		 * @param key the cache key
 		 */
-		void writeToCacheFile(string cacheFileName);
+		void writeToCache(string key);
 
 		/**
-		 * a local function to read the polynomials' parameters from the cache file
-		 * @param cacheFileName the number of intervals the domain is split into
-		 * @nbIntervals number of intervals, used in build() function
+		 * a local function to read the polynomials' parameters from the cache
+		 * @param key the cache key
+		 * @return false if there is no such entry
 		 */
-		void readFromCacheFile(string cacheFileName);
+		bool readFromCache(string key);
 
 		/**
 		 * check whether all the coefficients of a given degree are of the same sign
@@ -107,7 +106,6 @@ namespace flopoco{
 		string uniqueName_;                /**< useful only to enable same kind of reporting as for FloPoCo operators. */
 		bool needToFreeF;                  /**< in an ideal world, this should not be needed */
 
-		fstream cacheFile;                 /**< file storing the cached parameters for the polynomials */
 	       
 	};
 
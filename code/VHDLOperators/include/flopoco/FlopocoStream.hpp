@@ -186,6 +186,7 @@ namespace flopoco{
 		protected:
 
 			Operator *op=0;
+			LexerContext *lexer=nullptr;                            /**< the lexer, built on the first flush and reused afterwards */
 			bool codeParsed;
 	};
 }
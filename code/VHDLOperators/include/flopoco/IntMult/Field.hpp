@@ -1,6 +1,9 @@
 #ifndef FLOPOCO_FIELD_HPP
 #define FLOPOCO_FIELD_HPP
 
+#include <cstdint>
+#include <map>
+#include <tuple>
 #include <utility>
 #include <vector>
 #include "BaseMultiplierCategory.hpp"
@@ -73,15 +76,25 @@ namespace flopoco {
         unsigned int getWidth();
         unsigned int getHeight();
         void reset();
-        void reset(Field& target);
         bool checkPosition(unsigned int x, unsigned int y, FieldState& fieldState);
         void printField();
         void setTruncated(unsigned int range, FieldState& fieldState);
-        void setTruncated(unsigned int wOut, unsigned int prodWidth, unsigned int guardBits, unsigned int keepBits, FieldState &fieldState);
+        /** marks as covered the bits that a truncated multiplier drops: all the columns lower than actualLSB, and all but keepBits bits of column actualLSB */
+        void setTruncated(unsigned int actualLSB, unsigned int keepBits, FieldState &fieldState);
         void printField(FieldState& fieldState);
 
     protected:
-        vector<vector<ID>> field_;
+        /*
+         * The occupancy is stored as one bitset per row, of words_ 64-bit words, bit x of row y being cell (x,y).
+         * The cells covered by the base state are in baseBits_, and are covered for all the states.
+         * The cells covered by another state are in stateBits_, for the rows whose rowOwner_ is the ID of this state:
+         * as a state gets a new ID when it is reset, resetting it costs nothing, and its rows are cleared when it next writes to them.
+         * Only one state besides the base state can have cells at a time, which is how the tiling strategies use a field.
+         */
+        vector<uint64_t> baseBits_;
+        vector<uint64_t> stateBits_;
+        vector<ID> rowOwner_;
+        unsigned int words_;
         unsigned int wX_;
         unsigned int wY_;
         bool signedIO_;
@@ -89,6 +102,20 @@ namespace flopoco {
         ID currentStateID_;
         FieldState* baseState_;
         ID baseID_;
+
+        /** row masks of irregular tiles, per tile, anchor and clipped extent, computed from shape_contribution() on first use */
+        map<tuple<BaseMultiplierCategory*, unsigned int, unsigned int, unsigned int, unsigned int>, vector<uint64_t>> shapeMasks_;
+
+        /** the word w of row y as seen by the state of ID id */
+        uint64_t occupied(unsigned int y, unsigned int w, ID id) const {
+            return baseBits_[y * words_ + w] | (rowOwner_[y] == id ? stateBits_[y * words_ + w] : 0);
+        }
+        /** marks the cells of mask in the word w of row y as covered by the state of ID id, and returns how many were free */
+        unsigned int cover(unsigned int y, unsigned int w, uint64_t mask, ID id);
+        /** the bits of columns [x0, x1) in word w */
+        static uint64_t columnMask(unsigned int w, unsigned int x0, unsigned int x1);
+        /** the masks of the rows [coord.second, y1) of an irregular tile anchored at coord and clipped to column x1, words_ words per row */
+        const vector<uint64_t>& shapeMask(const Cursor coord, BaseMultiplierCategory* tile, unsigned int x1, unsigned int y1);
     };
 
     typedef Field::FieldState BaseFieldState;
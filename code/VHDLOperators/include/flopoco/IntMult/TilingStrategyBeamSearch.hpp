@@ -15,8 +15,8 @@ namespace flopoco {
         TilingStrategyBeamSearch(
                 unsigned int wX,
                 unsigned int wY,
-                unsigned int wOut,
                 bool signedIO,
+                mpz_class errorBudget,
                 BaseMultiplierCollection* bmc,
                 base_multiplier_id_t prefered_multiplier,
                 float occupation_threshold,
@@ -27,12 +27,12 @@ namespace flopoco {
                 bool useKaratsuba,
                 MultiplierTileCollection& tiles,
                 unsigned int beamRange,
-                unsigned guardBits,
-                unsigned keepBits);
+                unsigned int beamThreads = 1);
         void solve();
 
     private:
         unsigned int beamRange_;
+        unsigned int beamThreads_;   /**< the alternatives of each beam step are evaluated on this many threads, each with its own copy of the field */
         bool placeSingleTile(BaseFieldState& fieldState, unsigned int& usedDSPBlocks, list<mult_tile_t>* solution, const unsigned int neededX, const unsigned int neededY, BaseMultiplierCategory* tile, double& cost, unsigned int& area, double cmpCost, vector<tuple<BaseMultiplierCategory*, BaseMultiplierParametrization, multiplier_coordinates_t>>& dspBlocks);
     };
 }
@@ -13,8 +13,8 @@ namespace flopoco {
         TilingStrategyCSV(
                 unsigned int wX,
                 unsigned int wY,
-                unsigned int wOut,
                 bool signedIO,
+                mpz_class errorBudget,
                 BaseMultiplierCollection* bmc,
                 base_multiplier_id_t prefered_multiplier,
                 float occupation_threshold,
@@ -23,9 +23,7 @@ namespace flopoco {
                 bool use2xk,
                 bool useSuperTiles,
                 bool useKaratsuba,
-                MultiplierTileCollection tiles,
-                unsigned guardBits,
-                unsigned keepBits);
+                MultiplierTileCollection tiles);
         virtual ~TilingStrategyCSV() { }
 
         virtual void solve();
@@ -44,8 +42,6 @@ namespace flopoco {
         bool truncated_;
         //unsigned int truncatedRange_;
         unsigned prodsize_;
-        unsigned guardBits_;
-        unsigned keepBits_;
 
         
     };
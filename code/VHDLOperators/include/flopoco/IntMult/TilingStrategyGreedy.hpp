@@ -13,8 +13,8 @@ namespace flopoco {
         TilingStrategyGreedy(
                 unsigned int wX,
                 unsigned int wY,
-                unsigned int wOut,
                 bool signedIO,
+                mpz_class errorBudget,
                 BaseMultiplierCollection* bmc,
                 base_multiplier_id_t prefered_multiplier,
                 float occupation_threshold,
@@ -23,9 +23,7 @@ namespace flopoco {
                 bool use2xk,
                 bool useSuperTiles,
                 bool useKaratsuba,
-                MultiplierTileCollection& tiles,
-                unsigned guardBits,
-                unsigned keepBits);
+                MultiplierTileCollection& tiles);
         virtual ~TilingStrategyGreedy() { }
 
         virtual void solve();
@@ -44,9 +42,9 @@ namespace flopoco {
         bool truncated_;
         //unsigned int truncatedRange_;
         unsigned prodsize_;
-        unsigned guardBits_;
-        unsigned keepBits_;
 
+        /** computes actualLSB and the error correction constant from the error budget, and marks the truncated bits as covered in the field */
+        void truncateField(Field& field, BaseFieldState& fieldState);
         bool greedySolution(BaseFieldState& fieldState, list<mult_tile_t>* solution, queue<unsigned int>* path, double& cost, unsigned int& area, unsigned int& usedDSPBlocks, double cmpCost = DBL_MAX, vector<tuple<BaseMultiplierCategory*, BaseMultiplierParametrization, multiplier_coordinates_t>>* dspBlocks = nullptr);
         bool performSuperTilePass(vector<tuple<BaseMultiplierCategory*, BaseMultiplierParametrization, multiplier_coordinates_t>>* dspBlocks, list<mult_tile_t>* solution, double& cost, double cmpCost = DBL_MAX);
     };
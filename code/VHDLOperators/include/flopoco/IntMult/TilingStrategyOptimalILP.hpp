@@ -8,6 +8,7 @@
 #include <ScaLP/SolverDynamic.h> // ScaLP::newSolverDynamic
 #endif //HAVE_SCALP
 #include <iomanip>
+#include <tuple>
 #include "BaseMultiplier.hpp"
 #include "BaseMultiplierDSPSuperTilesXilinx.hpp"
 #include "BaseMultiplierIrregularLUTXilinx.hpp"
@@ -26,19 +27,18 @@ public:
     TilingStrategyOptimalILP(
         unsigned int wX,
         unsigned int wY,
-        unsigned int wOut,
         bool signedIO,
+        mpz_class errorBudget,
         BaseMultiplierCollection* bmc,
 		base_multiplier_id_t prefered_multiplier,
 		float occupation_threshold,
 		int maxPrefMult,
         MultiplierTileCollection tiles_,
-        unsigned guardBits,
-        unsigned keepBits,
-        mpz_class errorBudget,
-        mpz_class &centerErrConstant,
         bool performOptimalTruncation,
-        bool squarer);
+        bool squarer,
+        TilingStrategy* warmStart = nullptr);
+
+    ~TilingStrategyOptimalILP() override;
 
     void solve() override;
 
@@ -46,14 +46,36 @@ private:
     float occupation_threshold_;
     int dpX, dpY, dpS, dpC, wS, max_pref_mult_;
     vector<BaseMultiplierCategory*> tiles;
+    int wOut;                           /**< the output width and guard bits that correspond to the error budget */
     unsigned prodWidth, guardBits, keepBits;
     mpz_class eBudget, &centerErrConstant;
     unsigned long long  errorBudget;
     bool performOptimalTruncation, squarer;
+    vector<tuple<int, int, int>> placements;      /**< the solution as (tile index, x, y), as stored in the DiskCache */
+    TilingStrategy* warmStart;                    /**< a heuristic whose tiling is the incumbent of the solver (owned), or nullptr */
+    vector<tuple<int, int, int>> warmStartPlacements;
+    double warmStartCost;                         /**< the value of the ILP objective for the heuristic tiling. Negative if there is no usable incumbent */
+    static constexpr double constantBitCost = 0.65; /**< the cost in the ILP objective of a constant bit added to the bitheap */
+
+    /** the DiskCache key of this tiling problem: everything the ILP model depends on */
+    string cacheKey();
+
+    /** replays the tiling stored under key in the DiskCache, if any, without calling the solver */
+    bool loadCachedSolution(const string& key);
+
+    /** stores the current solution under key in the DiskCache */
+    void storeSolution(const string& key);
+    /** solves the warm start heuristic and maps its tiling to the tiles of the ILP model. Returns false if it is not a solution of the model */
+    bool solveWarmStart();
 #ifdef HAVE_SCALP
     void constructProblem();
 
+    /** gives the warm start tiling to the solver as a MIP start */
+    void setStartValues();
+
         ScaLP::Solver *solver;
+        vector<vector<vector<ScaLP::Variable>>> solve_Vars;
+        int x_neg, y_neg;
 #endif
 };
 
@@ -9,8 +9,8 @@ namespace flopoco {
         TilingStrategyXGreedy(
                 unsigned int wX,
                 unsigned int wY,
-                unsigned int wOut,
                 bool signedIO,
+                mpz_class errorBudget,
                 BaseMultiplierCollection* bmc,
                 base_multiplier_id_t prefered_multiplier,
                 float occupation_threshold,
@@ -19,9 +19,7 @@ namespace flopoco {
                 bool use2xk,
                 bool useSuperTiles,
                 bool useKaratsuba,
-                MultiplierTileCollection& tiles,
-                unsigned guardBits,
-                unsigned keepBits);
+                MultiplierTileCollection& tiles);
         void solve() override;
 
     private:
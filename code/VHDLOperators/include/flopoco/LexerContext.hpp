@@ -63,8 +63,14 @@ public:
 
 	//these methods are generated in VHDLLexer.cpp 
 
+	/** lex the istream is, reading it block by block */
 	void lex();
 
+	/** lex code in place, without copying it to a flex buffer.
+	 * code is temporarily extended with the two end-of-buffer characters flex requires, and restored on return.
+	 * The scanner is kept, so the same LexerContext may be reused for successive calls. */
+	void lex(string& code);
+
 	virtual ~LexerContext() { destroy_scanner();}
 
 protected:
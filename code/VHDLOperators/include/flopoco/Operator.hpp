@@ -9,6 +9,8 @@
 #include <set>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <functional>
 #include <iostream>
 #include <fstream>
 #include <string>
@@ -78,6 +80,8 @@ namespace flopoco {
 
 
 		static int uid;                  /**< The counter holding a unique id */
+		static map<string, Operator*> sharedOperatorCache_; /**< The shared operators built so far, indexed by their description, see findSharedOperator() */
+		static std::recursive_mutex sharedOperatorMutex_;    /**< Guards sharedOperatorCache_, which compression and tiling threads reach through BasicCompressor::getCompressor() */
 
 	public:
 
@@ -696,6 +700,40 @@ namespace flopoco {
 		 */
 		void newSharedInstance(OperatorPtr op, string instanceName, string inPortMaps, string outPortMaps, string inPortMapsCst = "");
 
+		/**
+		 * Look up a shared operator previously recorded with recordSharedOperator()
+		 * @param description the description of the operator, which must include everything it depends on, including its Target
+		 * @return the operator, or nullptr if none was recorded with this description
+		 */
+		static Operator* findSharedOperator(string description);
+
+		/**
+		 * Record a shared operator, so that identical requests reuse it instead of building it again.
+		 * Only shared operators may be recorded: the schedule of the others depends on the context of their instance.
+		 * @param description the description of the operator, which must include everything it depends on, including its Target
+		 * @param op the shared operator
+		 */
+		static void recordSharedOperator(string description, Operator* op);
+
+		/**
+		 * Look up a shared operator, and build it if it was not recorded yet.
+		 * The lookup, the construction and the recording are atomic with respect to the other threads,
+		 * so that two threads asking for the same operator do not build it twice.
+		 * A shared operator is combinatorial and scheduled on its own, from the input delays set by its constructor:
+		 * the timing of the context of its instances never changes it, and the description need not include it.
+		 * @param description the description of the operator, which must include everything it depends on, including its Target
+		 * @param build builds the operator. It is recorded only if it is a shared operator
+		 * @param built if not nullptr, set to true if build() was called
+		 * @return the recorded or built operator
+		 */
+		static Operator* findOrBuildSharedOperator(string description, std::function<Operator*()> build, bool* built = nullptr);
+
+		/**
+		 * Forget all the shared operators recorded so far.
+		 * To be called whenever the operators they belong to are discarded, e.g. between two batch jobs.
+		 */
+		static void clearSharedOperatorCache();
+
 	private:
 		/**
 		 * Parse a string containing port mappings for a new instance of an operator
@@ -879,6 +917,13 @@ namespace flopoco {
 		 */
 		void outputVHDL(std::ostream& o);
 
+		/**
+		 * Output the architecture body (the statements between begin and end),
+		 * substituting the opaque VHDL blocks for their placeholders.
+		 * @param o the stream where the body will be output
+		 */
+		void outputArchitectureBody(std::ostream& o);
+
 
 
 		/**
@@ -1194,8 +1239,17 @@ namespace flopoco {
 		 */
 		void moveDependenciesToSignalGraph();
 
-		/* auxillary recursive function */
-		void buildAlreadyScheduledList(set<Signal*> & alreadyScheduled);
+		/* auxillary recursive function: signals without predecessors (constants, functional register outputs, etc) are scheduled */
+		void markSourceSignalsScheduled();
+
+		/* auxillary recursive function: moves the scheduling candidates of this operator and its subcomponents to candidates */
+		void collectSchedulingCandidates(vector<Signal*> & candidates);
+
+		/**
+		 * Records that a signal of this operator gained a predecessor, so the next schedule() will try to schedule it.
+		 * Called by Signal::addPredecessor().
+		 */
+		void addSchedulingCandidate(Signal* s);
 
 		/**
 		 * Performs as much as possible of an ASAP scheduling for the root operator of this operator.
@@ -1274,6 +1328,16 @@ namespace flopoco {
 		 */
 		void addFullComment(string comment, int lineLength = 80);
 
+		/**
+		 * Keep aside a block of VHDL code that will be neither lexed nor rewritten by the scheduler.
+		 * The returned placeholder is what should be sent to the vhdl stream: it is replaced with code, verbatim, when the VHDL is output.
+		 * The block must therefore not refer to any signal: it is meant for the bulk of a statement whose signals appear in the lexed code around it,
+		 * typically the choices of a "with X select Y <=" table, so that the dependencies and pipeline delays are still handled by the lexer and scheduler.
+		 * @param code the VHDL code, including its final newline
+		 * @return the placeholder, a one-line VHDL comment
+		 */
+		string opaqueVHDL(string code);
+
 
 		/**
 		 * Completely replace "this" with a copy of another operator.
@@ -1399,11 +1463,12 @@ private:
 
 	vector<triplet<string, string, int>> unresolvedDependenceTable;   /**< The list of dependence relations which contain on either the lhs or rhs an (still) unknown name */
 	std::ostringstream     dotDiagram;                          /**< The internal stream to which the drawing methods will output */
-	set<Signal*> alreadyScheduled;                          /**< only used by a top-level operator: the set of signals that are already scheduled. */
+	vector<Signal*> schedulingCandidates_;                  /**< Signals of this operator that gained predecessors, or that are waiting for some, since the last schedule(). */
 
 	map<string, string>  tmpInPortMap_;                    /**< Input port map for the instance of this operator currently being built. Temporary variable, that will be pushed into portMaps_. Strings are used to allow to connect with ranges of a signal like, e.g., A => B(7) */
 	map<string, string>  tmpOutPortMap_;                   /**< Output port map for the instance of this operator currently being built. Temporary variable, that will be pushed into portMaps_ Strings are used to allow to connect with ranges of a signal like, e.g., A => B(7) */
 	map<std::string, std::string> generics_;               /**< A map for generics, this is required to include library elements like primitives */
+	vector<string>       opaqueVHDLBlocks_;                /**< The blocks of VHDL code kept aside by opaqueVHDL(), in the order of their placeholders */
 
 
 };
@@ -0,0 +1,70 @@
+#ifndef __BITACCURATESIMULATOR_HPP
+#define __BITACCURATESIMULATOR_HPP
+
+/**
+ * An in-process, cycle-accurate simulator of the VHDL generated by an operator.
+ * It compiles the subset of VHDL that FloPoCo generates for datapaths
+ * (concurrent assignments, selected assignments and instances of sub-components)
+ * once into word-level instructions, ordered along the scheduled signal graph of the operator.
+ * The delayed signals (X_dN, X_cN) are registers, shifted at each clock cycle,
+ * and the outputs are checked pipelineDepth cycles after the inputs, like the VHDL TestBench does.
+ * The constructor throws a string on any other VHDL construct (process, if, case...).
+ */
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "flopoco/InterfacedOperator.hpp"
+#include "flopoco/TestBenches/TestCase.hpp"
+
+namespace flopoco{
+
+	class SimulationModel;
+
+	class BitAccurateSimulator
+	{
+	public:
+		/**
+		 * Builds the simulation model of an operator and of all its sub-components.
+		 * @param op The operator to simulate. It must have been scheduled.
+		 */
+		BitAccurateSimulator(Operator *op);
+
+		/** Destructor */
+		~BitAccurateSimulator();
+
+		/**
+		 * Computes the outputs of the operator for the given inputs, held during pipelineDepth cycles.
+		 * @param inputs the values of the inputs, indexed by input name, as non-negative integers
+		 * @return the values of the outputs, indexed by output name, as non-negative integers
+		 */
+		std::map<std::string, mpz_class> simulate(std::map<std::string, mpz_class> inputs);
+
+		/**
+		 * Simulates one test case and compares the outputs with its expected outputs.
+		 * @param tc the test case
+		 * @param report if not empty on failure, receives a description of the mismatches
+		 * @return true if all the outputs are acceptable
+		 */
+		bool check(TestCase* tc, std::string& report);
+
+		/**
+		 * Builds the test cases like TestBench does, and checks them all.
+		 * @param n Number of tests, with the same meaning as in TestBench
+		 * @return the number of failed tests
+		 */
+		int64_t run(int64_t n);
+
+		/** Factory method that parses arguments and runs the simulation, or returns a TestBench if the operator cannot be simulated */
+		static OperatorPtr parseArguments(OperatorPtr parentOp, Target *target, vector<string> &args, UserInterface& ui);
+
+	private:
+		Operator *op;                                    /**< The operator under test */
+		std::map<Operator*, SimulationModel*> models;    /**< The models of the operator and of its sub-components */
+		SimulationModel *model;                          /**< The model of op */
+	};
+
+}
+
+#endif
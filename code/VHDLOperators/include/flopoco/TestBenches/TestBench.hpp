@@ -17,8 +17,9 @@ namespace flopoco{
 		 * @param target The target architecture
 		 * @param op The operator which is the UUT
 		 * @param n Number of tests
+		 * @param hexFile if true, test.input holds one compact line per test, in hexadecimal
 		 */
-		TestBench(Target *target, Operator *op, int64_t n);
+		TestBench(Target *target, Operator *op, int64_t n, bool hexFile=false);
 
 		/** Destructor */
 		~TestBench();
@@ -48,9 +49,17 @@ namespace flopoco{
 		static OperatorPtr parseArguments(OperatorPtr parentOp, Target *target, vector<string> &args, UserInterface& ui);
 		
 	private:
+		/** Open test.input and write its header line */
+		void openTestInputFile();
+
+		/** The number of hexadecimal digits of a value of s in a hex test file */
+		static int hexDigits(Signal* s);
+
 		Operator *op; /**< The unit under test UUT */
 		int64_t       n;   /**< The parameter from the constructor */
+		bool hexFile;      /**< If true, test.input is in the compact hexadecimal format */
 		TestCaseList tcl; /**< Test case list */
+		ofstream testInputFile; /**< The test.input file */
 		int simulationTime; /**< Total simulation time */
 		bool hasFPOutputs;
 		bool hasIEEEOutputs;
@@ -1,6 +1,8 @@
 #ifndef __TESTCASE_HPP
 #define __TESTCASE_HPP
 
+#include <cstdio>
+#include <functional>
 #include <list>
 #include <map>
 #include <ostream>
@@ -122,6 +124,12 @@ namespace flopoco{
 		 * @param s The name of the output
 		 */
 		std::vector<mpz_class> getExpectedOutputValues(std::string s);
+
+		/**
+		 * returns the type of the expected outputs of a signal: a list of values, or an interval
+		 * @param s The name of the output
+		 */
+		OutputType getOutputType(std::string s);
 		
 
 		/**
@@ -155,9 +163,27 @@ namespace flopoco{
 		 */
 		std::string testFileString(std::list<std::string> inputSignalNames, std::list<std::string> outputSignalNames);
 
+		/**
+		 * generate the same information as testFileString as a single compact line, with all the values in hexadecimal:
+		 * each input on ceil(width/4) digits followed by a space, then for each output the integer n, then
+		 * its values, each preceded by one space. The inputs thus have a fixed layout.
+		 */
+		std::string testFileHexString(std::list<std::string> inputSignalNames, std::list<std::string> outputSignalNames);
+
 
 		std::string getDescription();
 
+		/**
+		 * Write the inputs, expected outputs and comment of this test case to a file, in a raw binary format.
+		 * Used to emulate test cases in worker processes.
+		 */
+		void writeRaw(FILE* f);
+
+		/**
+		 * Read back what writeRaw() wrote
+		 */
+		void readRaw(FILE* f);
+
 	private:
 
 		Operator *op_;                       /**< The operator for which this test case is being built */
@@ -210,12 +236,31 @@ namespace flopoco{
 		 */
 		TestCase * getTestCase(int i);
 
+		/**
+		 * Switch this TestCaseList to streaming mode: from now on, the added TestCases are written to o
+		 * (as formatted by format, typically TestCase::testFileString) by batches of batchSize, then deleted.
+		 * Only their number is kept, so the memory footprint no longer depends on the number of tests.
+		 * getTestCase() may no longer be used.
+		 */
+		void streamTo(std::ostream* o, std::function<std::string(TestCase*)> format, int batchSize=4096);
+
+		/** In streaming mode, write and delete the pending TestCases */
+		void flush();
+
+		/** True if this TestCaseList writes its TestCases out instead of storing them */
+		bool isStreaming();
+
 	private:
 		/** Stores the TestCase */
 		std::vector<TestCase*>  v;
 		std::map<int,TestCase*> mapCase;
 		/* id given to the last registered test case*/
 
+		std::ostream* streamOut = nullptr;              /**< In streaming mode, where the TestCases are written */
+		std::function<std::string(TestCase*)> streamFormat; /**< In streaming mode, how a TestCase is written */
+		int streamBatchSize = 0;
+		int numberOfStreamedTestCases = 0;              /**< In streaming mode, the number of TestCases added so far */
+
 	};
 
 }
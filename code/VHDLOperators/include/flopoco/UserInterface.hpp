@@ -60,6 +60,36 @@ namespace flopoco
 		/** parse all the operators passed on the command-line */
 		void buildAll(int argc, char* argv[]);
 
+		/** split a command line into the leading options and the operator specifications */
+		static void splitCommandLine(std::vector<std::string> args, std::vector<std::string>& initialOptions, std::vector<std::vector<std::string>>& operatorSpecs);
+
+		/** build the operators of a list of operator specifications, and add them to globalOpList */
+		void buildOperators(std::vector<std::vector<std::string>>& operatorSpecs);
+
+		/** build a new Target corresponding to the current options. Each operator gets its own, since some operators modify their Target */
+		Target* getTarget();
+
+		/** forget the operators of globalOpList and the shared operators, between two batch jobs.
+				They are not deleted: like in a single run, their destructors never run, as the ownership of BitHeaps and sub-components was not designed for it */
+		void clearOperators();
+
+		/** set all the options to their default values */
+		void setDefaultOptions();
+
+		/** run the jobs of batchFileName, one per line, each written to its own VHDL file.
+				@param globalOptions the options of the command line, applied before those of each job
+				@return the number of jobs that failed */
+		int runBatch(std::vector<std::string> const & globalOptions);
+
+		/** split a line of a batch file into words, as a shell would, honoring quotes */
+		static std::vector<std::string> splitBatchLine(std::string const & line);
+
+		/** build the operators of one batch job and write them to their VHDL file, throws on errors
+				@param words the words of the line of the job
+				@param globalOptions the options of the command line, applied before those of the job
+				@param job the number of the job, which names its default output file */
+		void runBatchJob(std::vector<std::string> const & words, std::vector<std::string> const & globalOptions, int job);
+
 		/** starts the dot diagram plotter on the operators */
 		void drawDotDiagram(std::vector<OperatorPtr> &oplist);
 
@@ -139,6 +169,7 @@ namespace flopoco
 		std::string entityName;
 		std::string targetFPGA;
 		std::string programName;
+		std::string batchFileName;                 /**< if not empty, the file (or - for stdin) of operator specifications to build in one process */
 		FactoryRegistry const & factRegistry;
 		double targetFrequencyMHz;
 //		bool   pipeline; //not used at all, uncomment for now, remove this later!
@@ -155,6 +186,8 @@ namespace flopoco
 		std::string tiling;
 		std::string ilpSolver;
 		int    ilpTimeout;
+		int    threads;
+		int    beamThreads;
 #if 0 // Shall we resurrect all this some day?
 		static int    resourceEstimation;
 		static bool   floorplanning;
@@ -1,16 +1,19 @@
 #include <algorithm>
+#include <atomic>
 #include <cstdlib>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <istream>
 #include <map>
+#include <mutex>
 #include <optional>
 #include <random>
 #include <set>
 #include <sstream>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <vector>
 
 #include <boost/process.hpp>
@@ -22,6 +25,8 @@
 
 namespace {
 namespace fs =  std::filesystem;
+/** Serializes the console output of concurrent tests */
+std::mutex coutMutex;
 /**
  * @brief The TempDirectoryManager class
  * Manages all temporary directories created for the purpose
@@ -117,6 +122,9 @@ private:
     OperatorFactory const *const opFact;
     fs::path testRoot;
     int testLevel;
+    std::string execName;
+    std::string nvcPath;
+    std::ofstream detailedFile;
     /**
      * @brief commandLineForTestCase
      * @param testcase
@@ -228,25 +236,41 @@ public:
         return res;
     }
     /**
-     * @brief runTests
+     * @brief prepareRun creates the result directory of this operator
+     * and opens detailed.txt. Must be called before runTest()
      */
-    void runTests() {
+    void prepareRun() {
         std::cout << endl << "Running tests for " << opFact->name() << ":\n";
         namespace bp = boost::process;
         if (!fs::create_directory(testRoot)) {
              fs::remove_all(testRoot);
              fs::create_directory(testRoot);
         }
-        auto name = fs::absolute(UserInterface::getUserInterface().getExecName()).string();
-        if (!fs::exists(name)) {
+        execName = fs::absolute(UserInterface::getUserInterface().getExecName()).string();
+        if (!fs::exists(execName)) {
             // This is required when installing flopoco system-wide (e.g. /usr/local/bin):
-            name = UserInterface::getUserInterface().getExecName();
+            execName = UserInterface::getUserInterface().getExecName();
         }
-        auto detailed = testRoot / "detailed.txt";
-        std::ofstream detailedFile{detailed, std::ios::out};
-        auto bufferOut = testRoot / "buffer.txt";
-        int id = 0;
+        nvcPath = bp::search_path("nvc").string();
+        detailedFile.open(testRoot / "detailed.txt", std::ios::out);
         detailedFile << "TestID, Command line, VHDL Generation status, Simulation status\n";
+    }
+    /**
+     * @brief runTest runs flopoco then nvc for one test, in workDir.
+     * The outcome is only recorded in the test, reportTest() outputs it.
+     * Tests of the same or different OperatorTesters may be run concurrently in distinct directories.
+     * @param id the index of the test
+     * @param workDir the directory where flopoco and nvc are run
+     */
+    void runTest(size_t id, fs::path const & workDir) {
+        namespace bp = boost::process;
+        auto & testCase = tests[id];
+        auto command = commandLineForTestCase(testCase);
+        {
+            std::lock_guard<std::mutex> lock(coutMutex);
+            std::cout << "Running test " << (id + 1) << " / " << tests.size() << "    "   << " " << command << endl;
+        }
+        auto bufferOut = workDir / "buffer.txt";
         auto getLines = [&bufferOut](std::vector<std::string> & out) {
             std::ifstream in{bufferOut.string()};
             std::string line;
@@ -254,93 +278,114 @@ public:
             	out.emplace_back(line);
             }
         };
-        auto nvcPath = bp::search_path("nvc");
-        auto nbTests = tests.size();
-        for (auto & testCase : tests) {
-             auto command = commandLineForTestCase(testCase);
-        #if 0  // nice but I had rather see the command line
-             std::cout << "\33[2K\rRunning test " << (id + 1) << " / " << nbTests;
-             std::cout.flush();
-             fs::remove(bufferOut);
-        #else
-            std::cout << "Running test " << (id + 1) << " / " << nbTests << "    "   << " " << command << endl;
-        #endif
-            detailedFile << id << ", " << name << " " << command << ", ";
-            auto flopocoStatus = bp::system(
-                name + " " + command,
-                (bp::std_out & bp::std_err) > bufferOut.string(),
-                bp::start_dir(testRoot.string())
-            );
-            std::string nvcLine;
-            getLines(testCase.flopocoOut);
-            for (auto const & line : testCase.flopocoOut) {
-                if (line.rfind("nvc", 0) == 0) {
-                    nvcLine = line;
-                }
+        auto flopocoStatus = bp::system(
+            execName + " " + command,
+            (bp::std_out & bp::std_err) > bufferOut.string(),
+            bp::start_dir(workDir.string())
+        );
+        std::string nvcLine;
+        getLines(testCase.flopocoOut);
+        for (auto const & line : testCase.flopocoOut) {
+            if (line.rfind("nvc", 0) == 0) {
+                nvcLine = line;
             }
-            // We managed to launch flopoco and it did execute properly
-            if (flopocoStatus == 0 && nvcLine != ""
-             && fs::exists(testRoot / "flopoco.vhdl"))
-            {
-                nvcLine.replace(0, 3, nvcPath.c_str());
-                detailedFile << "1, ";
-                testCase.status |= HDLGenerationOK;
-                // Try to run nvc
-                fs::remove(bufferOut);
-                int nvcStatus;
-                try {
-                    nvcStatus = bp::system(
-                        nvcLine,
-                        (bp::std_err & bp::std_out) > bufferOut.string(),
-                         bp::start_dir(testRoot.string()),
-                         bp::throw_on_error
-                    );
-                } catch (bp::process_error &pe) {
-                    std::cerr << "There is an issue with your nvc installation. "
-                                 "Please fix it before running AutoTest." << endl
-                              << "nvc command was: " << nvcLine << endl
-                              << "Error: " << pe.what() << endl
-                              << "FloPoCo will now graciously crash" << endl
-                              << endl
-                    ;
-                    exit(EXIT_FAILURE);
-                }
-                getLines(testCase.nvcOut);
-                if (nvcStatus == 0) {
-                    testCase.status |= SimulationOK;
-                    detailedFile << "1\n";
-                } else {
-                    detailedFile << "0\n";
-                    std::stringstream errname;
-                    errname << "nvc_err_" << id;
-                    auto dest = testRoot / errname.str();
-                    testCase.dumpnvcOut(dest.string());
-                    std::cout << endl << "Failed at simulation step. "
-                              << endl << "Log can be found in "
-                              << dest.string()
-                              << endl;
-                    std::cout << "Command was:" << endl
-                              << name << " "
-                              << commandLineForTestCase(testCase) /*nvcLine*/
-                              << endl;
-                }
+        }
+        // We managed to launch flopoco and it did execute properly
+        if (flopocoStatus == 0 && nvcLine != ""
+         && fs::exists(workDir / "flopoco.vhdl"))
+        {
+            nvcLine.replace(0, 3, nvcPath);
+            testCase.status |= HDLGenerationOK;
+            // Try to run nvc
+            fs::remove(bufferOut);
+            int nvcStatus;
+            try {
+                nvcStatus = bp::system(
+                    nvcLine,
+                    (bp::std_err & bp::std_out) > bufferOut.string(),
+                     bp::start_dir(workDir.string()),
+                     bp::throw_on_error
+                );
+            } catch (bp::process_error &pe) {
+                std::lock_guard<std::mutex> lock(coutMutex);
+                std::cerr << "There is an issue with your nvc installation. "
+                             "Please fix it before running AutoTest." << endl
+                          << "nvc command was: " << nvcLine << endl
+                          << "Error: " << pe.what() << endl
+                          << "FloPoCo will now graciously crash" << endl
+                          << endl
+                ;
+                exit(EXIT_FAILURE);
+            }
+            getLines(testCase.nvcOut);
+            if (nvcStatus == 0) {
+                testCase.status |= SimulationOK;
+            }
+        }
+    }
+    /**
+     * @brief reportTest writes the outcome of a test that has been run
+     * to detailed.txt, and dumps the logs of a failed test
+     * @param id the index of the test
+     */
+    void reportTest(size_t id) {
+        auto & testCase = tests[id];
+        detailedFile << id << ", " << execName << " " << commandLineForTestCase(testCase) << ", ";
+        if (testCase.status & HDLGenerationOK) {
+            detailedFile << "1, ";
+            if (testCase.status & SimulationOK) {
+                detailedFile << "1\n";
             } else {
-                  detailedFile << "0, 0\n";
-                  std::stringstream errname;
-                  errname << "flopoco_err_" << id;
-                  auto dest = testRoot / errname.str();
-                  testCase.dumpFlopocoOut(dest.string());
-                  std::cout << endl << "Failed at generation step. "
-                            << endl << "Log can be found in "
-                            << dest.string()
-                            << endl;
-                  std::cout << "Command was:" << endl
-                            << name << " "
-                            << commandLineForTestCase(testCase)
-                            << endl;
+                detailedFile << "0\n";
+                std::stringstream errname;
+                errname << "nvc_err_" << id;
+                auto dest = testRoot / errname.str();
+                testCase.dumpnvcOut(dest.string());
+                std::cout << endl << "Failed at simulation step. "
+                          << endl << "Log can be found in "
+                          << dest.string()
+                          << endl;
+                std::cout << "Command was:" << endl
+                          << execName << " "
+                          << commandLineForTestCase(testCase) /*nvcLine*/
+                          << endl;
             }
-            ++id;
+        } else {
+              detailedFile << "0, 0\n";
+              std::stringstream errname;
+              errname << "flopoco_err_" << id;
+              auto dest = testRoot / errname.str();
+              testCase.dumpFlopocoOut(dest.string());
+              std::cout << endl << "Failed at generation step. "
+                        << endl << "Log can be found in "
+                        << dest.string()
+                        << endl;
+              std::cout << "Command was:" << endl
+                        << execName << " "
+                        << commandLineForTestCase(testCase)
+                        << endl;
         }
+    }
+    /**
+     * @brief reportTests reports all the tests, once they have been run
+     */
+    void reportTests() {
+        for (size_t id = 0; id < tests.size(); ++id) {
+            reportTest(id);
+        }
+        detailedFile.close();
+        hasRun = true;
+    }
+    /**
+     * @brief runTests runs the tests one after the other, in the result directory
+     */
+    void runTests() {
+        prepareRun();
+        for (size_t id = 0; id < tests.size(); ++id) {
+            runTest(id, testRoot);
+            reportTest(id);
+        }
+        detailedFile.close();
         hasRun = true;
     }
     /**
@@ -405,7 +450,9 @@ OperatorPtr AutoTest::parseArguments(
     int testLevel;
     ui.parseInt(args, "testLevel", &testLevel);
     ui.parseString(args, "output", &output);
-    AutoTest AutoTest(opName, testLevel, output);
+    int jobs;
+    ui.parseStrictlyPositiveInt(args, "jobs", &jobs);
+    AutoTest AutoTest(opName, testLevel, output, jobs);
     return nullptr;
 }
 
@@ -424,7 +471,8 @@ const OperatorDescription<AutoTest> op_descriptor<AutoTest> {
       "1=substantial tests, "
       "2=exhaustive tests, "
       "3=infinite tests (which produce random parameter combinations which may take forever);"
-  "output(string)=random: explicit path for .csv generation output (otherwise random)",
+  "output(string)=random: explicit path for .csv generation output (otherwise random);"
+  "jobs(int)=1: number of tests run concurrently, each in its own temporary directory",
     ""                        // Extra HTML Doc
 };
 
@@ -433,7 +481,7 @@ const OperatorDescription<AutoTest> op_descriptor<AutoTest> {
  * @param opName
  * @param testLevel
  */
-AutoTest::AutoTest(string opName, const int testLevel, string output) : testLevel(testLevel) {
+AutoTest::AutoTest(string opName, const int testLevel, string output, int jobs) : testLevel(testLevel) {
     fs::path path(output);
     if (output == "random") {
         TempDirectoryManager tmpDirHolder;
@@ -482,6 +530,8 @@ AutoTest::AutoTest(string opName, const int testLevel, string output) : testLeve
         // Do we check for dependences ? No point really
     }
     // For each tested Operator, we run a number of tests defined in the Operator's unitTest method
+    // With several jobs, the tests of all the operators are put in a common pool
+    std::vector<std::pair<OperatorTester*, size_t>> pool;
     for (auto op: testedOperator) {
     	auto iter = testerMap.emplace(
             op, OperatorTester {
@@ -498,10 +548,44 @@ AutoTest::AutoTest(string opName, const int testLevel, string output) : testLeve
     	// Then we register random Tests for each tested Operator
     	if(doRandomTest) tester.registerRandomTests();
 */
+    	if (jobs > 1) {
+            tester.prepareRun();
+            for (size_t id = 0; id < tester.getNbTests(); ++id) {
+                pool.emplace_back(&tester, id);
+            }
+            continue;
+    	}
     	// Real run of the tests
     	tester.runTests();
     	tester.printStats(cout);
     }
+    if (jobs > 1) {
+        std::cout << endl << "Running " << pool.size() << " tests with " << jobs << " jobs" << endl;
+        std::atomic<size_t> next {0};
+        auto worker = [&pool, &next]() {
+            for (size_t i = next++; i < pool.size(); i = next++) {
+                // flopoco and nvc write their files in the current directory
+                TempDirectoryManager jobDir {true};
+                if (!jobDir.inGoodState()) {
+                    std::lock_guard<std::mutex> lock(coutMutex);
+                    std::cerr << "Creation of temporary directory is impossible, test skipped" << endl;
+                    continue;
+                }
+                pool[i].first->runTest(pool[i].second, jobDir.tmpPath.value());
+            }
+        };
+        std::vector<std::thread> workers;
+        for (int j = 0; j < jobs; ++j) {
+            workers.emplace_back(worker);
+        }
+        for (auto & w : workers) {
+            w.join();
+        }
+        for (auto& [opName, tester] : testerMap) {
+            tester.reportTests();
+            tester.printStats(cout);
+        }
+    }
     // Build summary.csv and a few global stats
     fs::path summaryFilePath = path / "summary.csv";
     ofstream outputSummary(summaryFilePath);
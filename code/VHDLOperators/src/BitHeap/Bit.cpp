@@ -95,6 +95,10 @@ namespace flopoco
 
 	Bit* Bit::clone()
 	{
+		// the clones of the bits of a bitheap (e.g. in the snapshots of its plotter) are freed with it
+		if(bitheap != nullptr)
+			return bitheap->newBit(*this);
+
 		Bit* newBit = new Bit();
 
 		newBit->weight = weight;
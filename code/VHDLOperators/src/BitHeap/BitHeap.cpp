@@ -26,6 +26,7 @@
 #include "flopoco/BitHeap/MaxEfficiencyCompressionStrategy.hpp"
 #include "flopoco/BitHeap/OptimalCompressionStrategy.hpp"
 #include "flopoco/BitHeap/CompressionStrategyOptILP.hpp"
+#include "flopoco/BitHeap/RaceCompressionStrategy.hpp"
 namespace flopoco {
 
 	BitHeap::BitHeap(Operator* op_, unsigned width_, string name_) :
@@ -114,7 +115,7 @@ namespace flopoco {
 
 		//create a new bit
 		//  the bit's constructor also declares the signal
-		Bit* bit = new Bit(this, name, weight, BitType::free);
+		Bit* bit = newBit(name, weight, BitType::free);
 
 		//insert the new bit so that the vector is sorted by bit (cycle, delay)
 		insertBitInColumn(bit, weight - lsb);
@@ -130,6 +131,34 @@ namespace flopoco {
 	}
 
 
+	vector<Bit>& BitHeap::arenaChunk()
+	{
+		// a full chunk is never reallocated, as this would invalidate the pointers to its bits: a larger one is started
+		if(bitArena.empty() || bitArena.back().size() == bitArena.back().capacity())
+		{
+			bitArena.emplace_back();
+			bitArena.back().reserve(size_t(64) << std::min<size_t>(bitArena.size() - 1, 10));
+		}
+		return bitArena.back();
+	}
+
+
+	Bit* BitHeap::newBit(string rhsAssignment, int weight, BitType type)
+	{
+		vector<Bit>& chunk = arenaChunk();
+		chunk.emplace_back(this, rhsAssignment, weight, type);
+		return &chunk.back();
+	}
+
+
+	Bit* BitHeap::newBit(const Bit& bit)
+	{
+		vector<Bit>& chunk = arenaChunk();
+		chunk.push_back(bit);
+		return &chunk.back();
+	}
+
+
 #if 0 // don't see where it is used
 
 	void BitHeap::addBit(int weight, Signal *signal, int index)
@@ -783,6 +812,10 @@ namespace flopoco {
 		{
 			compressionStrategy = new FirstFittingCompressionStrategy(this);
 		}
+		else if(op->getTarget()->getCompressionMethod().compare("race") == 0)
+		{
+			compressionStrategy = new RaceCompressionStrategy(this);
+		}
 		else if(op->getTarget()->getCompressionMethod().compare("optimal") == 0)
 		{
 			compressionStrategy = new OptimalCompressionStrategy(this,false);
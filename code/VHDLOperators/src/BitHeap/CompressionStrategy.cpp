@@ -48,6 +48,13 @@ namespace flopoco{
 	CompressionStrategy::~CompressionStrategy(){
 	}
 
+	void CompressionStrategy::checkBudget()
+	{
+		if(outOfBudget && outOfBudget()){
+			THROWERROR("out of time budget after " << bitAmount.size() << " stages");
+		}
+	}
+
 	void CompressionStrategy::orderBitsByColumnAndStage()
 	{
 		REPORT(LogLevel::DEBUG, "in orderBitsByColumnAndStage")
@@ -252,7 +259,16 @@ namespace flopoco{
 		}
 	}
 
+	void CompressionStrategy::buildSolution(){
+		THROWERROR("this compression strategy does not work on bitAmount");
+	}
+
 	void CompressionStrategy::printSolutionStatistics(){
+		REPORT(LogLevel::VERBOSE, "total area of the compression is equivalent to " << getSolutionArea() << " LUTs");
+		REPORT(LogLevel::VERBOSE, "total number of stages is " << bitAmount.size()-1);
+	}
+
+	unsigned int CompressionStrategy::getSolutionArea(){
 		REPORT(LogLevel::DEBUG, "calculating compression area");
 		unsigned int totalArea = 0;  //area in Compressor.hpp
 		for(unsigned int s = 0; s < bitAmount.size() - 1; s++) {
@@ -277,8 +293,7 @@ namespace flopoco{
 				}
 			}
 		}
-		REPORT(LogLevel::VERBOSE, "total area of the compression is equivalent to " << totalArea << " LUTs");
-		REPORT(LogLevel::VERBOSE, "total number of stages is " << bitAmount.size()-1);
+		return totalArea;
 	}
 
 
@@ -2,6 +2,7 @@
 #include "flopoco/BitHeap/Compressor.hpp"
 #include "flopoco/InterfacedOperator.hpp"
 #include "flopoco/UserInterface.hpp"
+#include <sstream>
 #include <string>
 
 using namespace std;
@@ -45,7 +46,15 @@ namespace flopoco{
 				return compressor;
 			}
 			else{
-				compressor = new Compressor(parentOp, target, heights, area, compactView);
+				// compressors are shared: all the bit heaps of the run may use the same one
+				ostringstream description;
+				description << "Compressor target=" << target->getOptionsDescription() << " heights=";
+				for(unsigned int i=0; i<heights.size(); i++)
+					description << heights[i] << ",";
+				description << " area=" << area << " compactView=" << compactView;
+				compressor = dynamic_cast<Compressor*>(Operator::findOrBuildSharedOperator(description.str(), [this]() {
+						return new Compressor(parentOp, target, heights, area, compactView);
+					}));
 				return compressor;
 			}
 		}
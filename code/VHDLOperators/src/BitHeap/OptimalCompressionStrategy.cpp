@@ -1,5 +1,6 @@
 
 #include "flopoco/BitHeap/OptimalCompressionStrategy.hpp"
+#include "flopoco/Tools/DiskCache.hpp"
 
 
 
@@ -21,10 +22,6 @@ namespace flopoco{
 	{
 		REPORT(LogLevel::DEBUG, "compressionAlgorithm is optimal");
 
-#ifndef HAVE_SCALP
-		THROWERROR("For the optimal compressor tree generation scalp is needed");
-#else
-
 		//for debugging it might be better to order the compressors by efficiency
 		orderCompressorsByCompressionEfficiency();
 
@@ -41,24 +38,37 @@ namespace flopoco{
 		solution = BitHeapSolution();
 		solution.setSolutionStatus(BitheapSolutionStatus::OPTIMAL_PARTIAL);
 
-		//generates the compressor tree but only works one the bitAmount datastructure. Fills the solution. No VHDL-Code is written here.
+		//a compressor tree found by a previous run for the same bits and compressors is replayed without calling the solver
+		string key = cacheKey();
+		if(!DiskCache::isEnabled() || !loadCachedSolution(key)){
+#ifndef HAVE_SCALP
+			THROWERROR("For the optimal compressor tree generation scalp is needed");
+#else
+			//generates the compressor tree but only works one the bitAmount datastructure. Fills the solution. No VHDL-Code is written here.
 
-		bool foundSolution = false;
-		if(!optimalMinStages){
-			foundSolution = optimalGeneration();
-			if(foundSolution == false){
-				THROWERROR("wasn't able to find a solution within the given timelimit");
-			}
-		}
-		else{
-			unsigned int stages = getMinAmountOfStages();
-			REPORT(LogLevel::DEBUG, "after getMinAmountOfStages stages = " << stages);
 			bool foundSolution = false;
-			while(!foundSolution){
-				foundSolution = optimalGeneration(stages, true);
-				stages++;
+			if(!optimalMinStages){
+				foundSolution = optimalGeneration();
+				if(foundSolution == false){
+					THROWERROR("wasn't able to find a solution within the given timelimit");
+				}
+			}
+			else{
+				unsigned int stages = getMinAmountOfStages();
+				REPORT(LogLevel::DEBUG, "after getMinAmountOfStages stages = " << stages);
+				bool foundSolution = false;
+				while(!foundSolution){
+					foundSolution = optimalGeneration(stages, true);
+					stages++;
+				}
+
 			}
 
+			//a solution found before a timeout may be improved by a later run with a larger timeout, so only optimal ones are cached
+			if(DiskCache::isEnabled() && solutionIsOptimal){
+				storeSolution(key);
+			}
+#endif //HAVE_SCALP
 		}
 
         //reports the area in LUT-equivalents
@@ -66,9 +76,101 @@ namespace flopoco{
 
 		//here the VHDL-Code for the compressors as well as the bits->compressors->bits are being written.
 		applyAllCompressorsFromSolution();
-#endif //HAVE_SCALP
 	}
 
+	string OptimalCompressionStrategy::cacheKey(){
+		ostringstream key;
+		key << "OptimalCompressionStrategy minStages=" << optimalMinStages << " finalAdd=" << bitheap->final_add_height
+			<< " target=" << bitheap->getOp()->getTarget()->getID() << " compressors:";
+		for(auto c : possibleCompressors){
+			key << " " << c->getStringOfIO() << ":" << c->area << ":" << (int)c->type << ":" << c->rcType;
+		}
+		key << " bits:";
+		for(auto const& stage : bitAmount){
+			key << " [";
+			for(auto b : stage){
+				key << " " << b;
+			}
+			key << " ]";
+		}
+		return key.str();
+	}
+
+	bool OptimalCompressionStrategy::loadCachedSolution(const string& key){
+		string contents;
+		if(!DiskCache::loadEntry(key, ".compression", contents)){
+			return false;
+		}
+
+		istringstream in(contents);
+		string tag;
+		unsigned int stages;
+		if(!(in >> tag >> stages) || tag != "stages"){
+			return false;
+		}
+		BitHeapSolution cachedSolution;
+		cachedSolution.setSolutionStatus(BitheapSolutionStatus::OPTIMAL_PARTIAL);
+		string line;
+		while(getline(in, line)){
+			istringstream entry(line);
+			unsigned int s, e, c, amount;
+			if(!(entry >> tag)){
+				continue;
+			}
+			if(tag == "k" && entry >> s >> e >> c >> amount && e < possibleCompressors.size()){
+				for(unsigned int k = 0; k < amount; k++){
+					cachedSolution.addCompressor(s, c, possibleCompressors[e]);
+				}
+			}
+			else if(tag == "z" && entry >> s){
+				vector<int> remainingBits;
+				int value;
+				while(entry >> value){
+					remainingBits.push_back(value);
+				}
+				cachedSolution.setEmptyInputsByRemainingBits(s, remainingBits);
+			}
+			else{
+				REPORT(LogLevel::DETAIL, "ignoring an invalid cached compressor tree");
+				return false;
+			}
+		}
+
+		resizeBitAmount(stages);
+		solution = cachedSolution;
+		REPORT(LogLevel::DETAIL, "reusing the cached compressor tree");
+		return true;
+	}
+
+	void OptimalCompressionStrategy::storeSolution(const string& key){
+		ostringstream contents;
+		contents << "stages " << bitAmount.size() - 1 << endl;
+		for(auto const& k : compressorCounts){
+			contents << "k " << k[0] << " " << k[1] << " " << k[2] << " " << k[3] << endl;
+		}
+		for(unsigned int s = 0; s < emptyInputs.size(); s++){
+			contents << "z " << s;
+			for(auto z : emptyInputs[s]){
+				contents << " " << z;
+			}
+			contents << endl;
+		}
+		DiskCache::storeEntry(key, ".compression", contents.str());
+	}
+
+	void OptimalCompressionStrategy::resizeBitAmount(unsigned int stages){
+
+		stages++;	//we need also one stage for the outputbits
+
+		unsigned int columns = bitAmount[bitAmount.size() - 1].size();
+		//we need one stage more for the
+		while(bitAmount.size() < stages){
+			bitAmount.resize(bitAmount.size() + 1);
+			bitAmount[bitAmount.size() - 1].resize(columns, 0);
+		}
+	}
+
+
 #ifdef HAVE_SCALP
 	bool OptimalCompressionStrategy::optimalGeneration(unsigned int stages, bool optimalMinStages){
 
@@ -134,18 +236,6 @@ namespace flopoco{
 
 	}
 
-	void OptimalCompressionStrategy::resizeBitAmount(unsigned int stages){
-
-		stages++;	//we need also one stage for the outputbits
-
-		unsigned int columns = bitAmount[bitAmount.size() - 1].size();
-		//we need one stage more for the
-		while(bitAmount.size() < stages){
-			bitAmount.resize(bitAmount.size() + 1);
-			bitAmount[bitAmount.size() - 1].resize(columns, 0);
-		}
-	}
-
 	void OptimalCompressionStrategy::initializeSolver(){
 
 		problemSolver = new ScaLP::Solver(ScaLP::newSolverDynamic({bitheap->getOp()->getTarget()->getILPSolver(),"Gurobi","CPLEX","SCIP","LPSolve"}));
@@ -403,6 +493,7 @@ namespace flopoco{
 		REPORT(LogLevel::DEBUG, "backend while solving ilp problem is " << problemSolver->getBackendName());
 
 		ScaLP::status stat = problemSolver->solve();
+		solutionIsOptimal = (stat == ScaLP::status::OPTIMAL);
 
 		if(stat == ScaLP::status::INFEASIBLE_OR_UNBOUND || stat == ScaLP::status::INFEASIBLE || stat == ScaLP::status::UNBOUND){
 			solutionFound = false;
@@ -422,7 +513,8 @@ namespace flopoco{
 	void OptimalCompressionStrategy::fillSolutionFromILP(){
 
 		ScaLP::Result result = problemSolver->getResult();
-
+		compressorCounts.clear();
+		emptyInputs.clear();
 
 		for(unsigned int s = 0; s < compCountVars.size(); s++){
 			for(unsigned int e = 0; e < compCountVars[s].size(); e++){
@@ -435,6 +527,7 @@ namespace flopoco{
 							for(unsigned int k = 0; k < (unsigned int) integerValue; k++){
 								solution.addCompressor(s, c, possibleCompressors[e]);
 							}
+							compressorCounts.push_back({s, e, c, (unsigned int) integerValue});
 						}
 					}
 				}
@@ -456,6 +549,7 @@ namespace flopoco{
 				}
 			}
 			solution.setEmptyInputsByRemainingBits(s, tempVector);
+			emptyInputs.push_back(tempVector);
 		}
 	}
 
@@ -0,0 +1,128 @@
+#include <atomic>
+#include <chrono>
+#include <future>
+
+#include "flopoco/BitHeap/RaceCompressionStrategy.hpp"
+#include "flopoco/BitHeap/MaxEfficiencyCompressionStrategy.hpp"
+#include "flopoco/BitHeap/ParandehAfsharCompressionStrategy.hpp"
+
+
+using namespace std;
+
+namespace flopoco{
+
+
+	RaceCompressionStrategy::RaceCompressionStrategy(BitHeap* bitheap) : CompressionStrategy(bitheap)
+	{
+
+	}
+
+
+	RaceCompressionStrategy::~RaceCompressionStrategy()
+	{
+		for(auto candidate: candidates){
+			delete candidate;
+		}
+	}
+
+
+
+
+	void RaceCompressionStrategy::compressionAlgorithm()
+	{
+		REPORT(LogLevel::DEBUG, "compressionAlgorithm is race");
+
+		//adds the Bits to stages and columns. This schedules the operator, so it is done once, before the race
+		orderBitsByColumnAndStage();
+
+		//populates bitAmount. every candidate gets its own copy of it
+		fillBitAmounts();
+
+		//prints out how the inputbits of the bitheap looks like
+		printBitAmounts();
+
+		//the candidates are built here: their constructors create compressors, which is not thread-safe
+		candidates.push_back(new MaxEfficiencyCompressionStrategy(bitheap));
+		candidates.push_back(new ParandehAfsharCompressionStrategy(bitheap));
+		vector<string> names = {"heuristicMaxEff", "heuristicPA"};
+		vector<string> errors(candidates.size());
+		vector<bool> failed(candidates.size(), false);
+
+		//once the budget is spent, the candidates still running give up at their next stage, provided another one has a solution
+		auto deadline = chrono::steady_clock::now() + chrono::seconds(budget);
+		atomic<int> finished(0);
+		for(auto candidate: candidates){
+			candidate->orderedBits = orderedBits;
+			candidate->bitAmount = bitAmount;
+			candidate->outOfBudget = [deadline, &finished]() {
+				return finished > 0 && chrono::steady_clock::now() > deadline;
+			};
+		}
+
+		//the candidates only work on their own bitAmount, solution and compressors, no VHDL-Code is written here
+		vector<future<void>> workers;
+		for(size_t i = 0; i < candidates.size(); i++){
+			workers.push_back(async(launch::async, [this, i, &finished]() {
+				candidates[i]->buildSolution();
+				finished++;
+			}));
+		}
+		//get() rethrows what escaped buildSolution() in the thread of the candidate
+		for(size_t i = 0; i < candidates.size(); i++){
+			try{
+				workers[i].get();
+			}
+			catch(const string& e){
+				errors[i] = e;
+				failed[i] = true;
+			}
+			catch(const std::exception& e){
+				errors[i] = e.what();
+				failed[i] = true;
+			}
+			catch(...){
+				errors[i] = "unknown exception";
+				failed[i] = true;
+			}
+			candidates[i]->outOfBudget = nullptr;
+		}
+
+		//the smallest area wins, then the fewest stages. Ties go to the first candidate, so the result does not depend on the thread timing
+		CompressionStrategy* winner = nullptr;
+		unsigned int winnerArea = 0;
+		string winnerName;
+		for(size_t i = 0; i < candidates.size(); i++){
+			if(failed[i]){
+				REPORT(LogLevel::VERBOSE, names[i] << " failed: " << errors[i]);
+				continue;
+			}
+			unsigned int area = candidates[i]->getSolutionArea();
+			REPORT(LogLevel::VERBOSE, names[i] << " has an area of " << area << " LUTs and " << candidates[i]->bitAmount.size()-1 << " stages");
+			if(winner == nullptr || area < winnerArea
+					|| (area == winnerArea && candidates[i]->bitAmount.size() < winner->bitAmount.size())){
+				winner = candidates[i];
+				winnerName = names[i];
+				winnerArea = area;
+			}
+		}
+		if(winner == nullptr){
+			ostringstream o;
+			o << "all the candidates of the compression race failed:";
+			for(size_t i = 0; i < candidates.size(); i++){
+				o << endl << "  " << names[i] << ": " << errors[i];
+			}
+			THROWERROR(o.str());
+		}
+
+		REPORT(LogLevel::VERBOSE, "the compression race is won by " << winnerName);
+		solution = winner->solution;
+		bitAmount = winner->bitAmount;
+
+		//reports the area in LUT-equivalents
+		printSolutionStatistics();
+
+		//here the VHDL-Code for the compressors as well as the bits->compressors->bits are being written.
+		applyAllCompressorsFromSolution();
+	}
+
+}
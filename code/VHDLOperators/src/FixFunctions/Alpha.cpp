@@ -511,10 +511,13 @@ namespace flopoco
       mpz_class max_input = (mpz_class(1) << (wIn));
       mpz_class max_output = (mpz_class(1) << (wOut));
 
+      vector<mpz_class> allRNorD, allRU;
+      f->evalAll(allRNorD, allRU, correctlyRounded, getTarget()->getThreads());
+
       for(mpz_class i = 0; i < max_input; i++) {
         mpz_class x = i;
-        mpz_class rNorD, ru;
-        f->eval(x, rNorD, ru, correctlyRounded);
+        mpz_class rNorD = allRNorD[i.get_ui()];
+        mpz_class ru = (correctlyRounded ? mpz_class(0) : allRU[i.get_ui()]);
         // Signed input
         if(x >= sign_limit_in) {
           x = x - max_input;
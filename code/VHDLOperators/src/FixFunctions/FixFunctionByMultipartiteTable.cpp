@@ -18,6 +18,7 @@
 #include <sstream>
 #include <string>
 #include <vector>
+#include <sys/mman.h>
 
 #include <gmp.h>
 #include <gmpxx.h>
@@ -30,6 +31,7 @@
 #include "flopoco/FixFunctions/Multipartite.hpp"
 #include "flopoco/Tables/DiffCompressedTable.hpp"
 #include "flopoco/Tables/TableOperator.hpp"
+#include "flopoco/Tools/WorkerProcesses.hpp"
 #include "flopoco/report.hpp"
 #include "flopoco/utils.hpp"
 
@@ -145,31 +147,9 @@ namespace flopoco
 			}
 
 			// Parameter space exploration complete. Now checking the results
-			rank = 0 ;
-			bool tryAgain = true;
-			while (rank < ten && tryAgain) {
-				// time to report
-				bestMP = topTen[rank];
-				if(bestMP->totalSize==sizeMax) { // This is one of the dummy mpts
-					tryAgain=false;
-				}
-				else {
-					REPORT(LogLevel::DETAIL, "Now running exhaustive test on candidate #" << rank << " :" << endl
-								 << tab << bestMP->descriptionString() << endl
-								 << tab<< bestMP->descriptionStringLaTeX()  );
-					bestMP->mkTables();
-					if (bestMP->exhaustiveTest()) {
-						REPORT(LogLevel::DETAIL, "... passed, now building the operator");
-						tryAgain = false;
-					}
-					else {
-						REPORT(LogLevel::DETAIL, "... failed, trying next candidate");
-						rank++;
-					}
-				}
-			}
+			rank = firstValidCandidate();
 
-			if(rank==ten || bestMP->totalSize==sizeMax) {
+			if(rank==ten) {
 				REPORT(LogLevel::DETAIL, "It seems we have to use the safe value of g... starting again");
 				for (int i=0; i<ten; i++){
 					topTen[i]-> totalSize =	sizeMax;
@@ -188,6 +168,8 @@ namespace flopoco
 		// Exploration complete. Now building the operator
 
 		bestMP = topTen[rank];
+		if(bestMP->tiv.empty()) // its tables were built by a worker process
+			bestMP->mkTables();
 
 		REPORT(LogLevel::DEBUG,"Full table dump:" <<endl << bestMP->fullTableDump());
 		vector<mpz_class> mpzTIV;
@@ -773,6 +755,86 @@ namespace flopoco
 	}
 
 
+	int FixFunctionByMultipartiteTable::firstValidCandidate() {
+		int sizeMax = f->wOut<<f->wIn; // the size of the dummy candidates, which are at the end of the top ten
+		int candidates = 0;
+		while(candidates < ten && topTen[candidates]->totalSize != sizeMax)
+			candidates++;
+
+		// The best rank that passed so far, shared with the worker processes so that they skip the worse candidates
+		int* bestRank = (int*) mmap(nullptr, sizeof(int), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+		if(bestRank == MAP_FAILED) {
+			THROWERROR("firstValidCandidate: mmap failed");
+		}
+		*bestRank = ten;
+
+		// before forking, so that the workers inherit it
+		if(exhaustiveTestReference.empty())
+			buildExhaustiveTestReference();
+
+		vector<bool> passed(candidates, false);
+		runInWorkerProcesses(candidates, getTarget()->getThreads(),
+			[&](uint64_t begin, uint64_t end, FILE* out) {
+				for(int r = begin; r < (int)end; r++) {
+					char result = 0;
+					if(r < __atomic_load_n(bestRank, __ATOMIC_ACQUIRE)) {
+						Multipartite* mp = topTen[r];
+						REPORT(LogLevel::DETAIL, "Now running exhaustive test on candidate #" << r << " :" << endl
+									 << tab << mp->descriptionString() << endl
+									 << tab<< mp->descriptionStringLaTeX()  );
+						mp->mkTables();
+						if (mp->exhaustiveTest()) {
+							REPORT(LogLevel::DETAIL, "... candidate #" << r << " passed");
+							result = 1;
+							int current = __atomic_load_n(bestRank, __ATOMIC_ACQUIRE);
+							while(r < current && !__atomic_compare_exchange_n(bestRank, &current, r, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+								;
+						}
+						else {
+							REPORT(LogLevel::DETAIL, "... candidate #" << r << " failed");
+						}
+					}
+					else {
+						REPORT(LogLevel::DEBUG, "Skipping candidate #" << r << ", a better one passed");
+					}
+					fputc(result, out);
+				}
+			},
+			[&](uint64_t begin, uint64_t end, FILE* in) {
+				for(uint64_t r = begin; r < end; r++)
+					passed[r] = (fgetc(in) == 1);
+			});
+		munmap(bestRank, sizeof(int));
+
+		for(int r = 0; r < candidates; r++) {
+			if(passed[r]) {
+				REPORT(LogLevel::DETAIL, "Candidate #" << r << " is the best valid one, now building the operator");
+				return r;
+			}
+		}
+		return ten;
+	}
+
+
+	void FixFunctionByMultipartiteTable::buildExhaustiveTestReference() {
+		uint64_t n = uint64_t(1) << f->wIn;
+		double scale = intpow2(f->lsbIn);
+		exhaustiveTestReference.resize(n);
+		runInWorkerProcesses(n, getTarget()->getThreads(),
+			[&](uint64_t begin, uint64_t end, FILE* out) {
+				for(uint64_t x = begin; x < end; x++) {
+					double ref = f->eval(((double)x) * scale);
+					fwrite(&ref, sizeof(double), 1, out);
+				}
+			},
+			[&](uint64_t begin, uint64_t end, FILE* in) {
+				if(fread(exhaustiveTestReference.data() + begin, sizeof(double), end - begin, in) != end - begin) {
+					THROWERROR("buildExhaustiveTestReference: could not read back the values computed by a worker");
+				}
+			});
+	}
+
+
 	TestList FixFunctionByMultipartiteTable::unitTest(int testLevel)
 	{
 		// the static list of mandatory tests
@@ -110,7 +110,7 @@ namespace flopoco{
 			// Build the polynomial approximation
 			double targetAcc= approxErrorBudget*pow(2, lsbOut);
 			REPORT(LogLevel::DETAIL, "Computing polynomial approximation of degree " << degree << " for target accuracy "<< targetAcc);
-			pwp = new UniformPiecewisePolyApprox(func, targetAcc, degree);
+			pwp = new UniformPiecewisePolyApprox(func, targetAcc, degree, getTarget()->getThreads());
 			alpha =  pwp-> alpha; // coeff table input size
 
 			// Build the coefficient table out of the vector of polynomials. This is also where we add the final rounding bit
@@ -41,13 +41,8 @@ namespace flopoco{
 		if(wOut<=0) {
 			THROWERROR("FixFunction determined that wOut=" << wOut << " which makes no sense");
 		}
-		vector<mpz_class> v;
-		for(int i=0; i<(1<<wIn); i++) {
-			mpz_class rn, devnull;
-			f->eval(mpz_class(i), rn, devnull, true);
-			v.push_back(rn);
-			//cerr <<   f-> getDescription()<< " : f("<< i << ") = " << rn <<endl;
-		};
+		vector<mpz_class> v, devnull;
+		f->evalAll(v, devnull, true, target_->getThreads());
 
 		init(v, name.str(), wIn, wOut);
 		if(target_->tableCompression()) {
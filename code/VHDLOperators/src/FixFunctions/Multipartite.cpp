@@ -16,6 +16,11 @@
 #include <sstream>
 #include <vector>
 
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define MULTIPARTITE_AVX2 1
+#include <immintrin.h>
+#endif
+
 #include "flopoco/BitHeap/BitHeap.hpp"
 #include "flopoco/FixFunctions/FixFunction.hpp"
 #include "flopoco/FixFunctions/FixFunctionByMultipartiteTable.hpp"
@@ -491,69 +496,142 @@ namespace flopoco
 	}
 
 
-#define ETDEBUG 0
+	namespace {
+		/** The tables of a candidate, flattened for the exhaustive test kernels */
+		struct ExhaustiveTestData {
+			int inputSize, alpha, m, guardBits;
+			bool compressed;
+			int ssIndexSize, ssShift;
+			const int64_t* tiv;          /**< the TIV, or the diffTIV if compressed */
+			const int64_t* ssTIV;
+			vector<const int64_t*> toi;
+			vector<int> pi, betai, gammai;
+			vector<int64_t> inMask;      /**< (1<<betai)-1 */
+			vector<int64_t> lowMask;     /**< (1<<(betai-1))-1 */
+			vector<int64_t> negative;    /**< negativeTOi, as 0 or 1 */
+			const double* ref;
+			double rulp;
+		};
+
+		/** The sum of the tables for input x, after the final rounding. A branchless rewriting of the VHDL architecture:
+				the TOi index is mirrored, and its output complemented, according to the MSB of its input */
+		inline int64_t multipartiteSum(const ExhaustiveTestData& d, int64_t x)
+		{
+			int64_t result = d.tiv[x >> (d.inputSize - d.alpha)];
+			if(d.compressed)
+				result += d.ssTIV[x >> (d.inputSize - d.ssIndexSize)] << d.ssShift;
+			for(int i=0; i<d.m; i++) {
+				int64_t a = (x >> d.pi[i]) & d.inMask[i];
+				int64_t msb = a >> (d.betai[i]-1);
+				int64_t index = (a & d.lowMask[i]) ^ ((msb-1) & d.lowMask[i]);
+				index += (x >> (d.inputSize - d.gammai[i])) << (d.betai[i]-1);
+				int64_t complement = -(int64_t)(msb == d.negative[i]);
+				result += d.toi[i][index] ^ complement;
+			}
+			return result >> d.guardBits;
+		}
+
+		/** true if the error is less than one ulp for all the inputs in [begin, end) */
+		bool exhaustiveTestScalar(const ExhaustiveTestData& d, int64_t begin, int64_t end)
+		{
+			for(int64_t x=begin; x<end; x++) {
+				double error = std::fabs(((double) multipartiteSum(d, x)) * d.rulp - d.ref[x]);
+				if(error >= d.rulp)
+					return false;
+			}
+			return true;
+		}
+
+#if MULTIPARTITE_AVX2
+		/** Same as exhaustiveTestScalar, four inputs at a time, for end-begin a multiple of 4.
+				AVX2 has neither a 64-bit arithmetic shift nor an int64 to double conversion, both are emulated;
+				the conversion is exact only for results smaller than 2^51 */
+		__attribute__((target("avx2")))
+		bool exhaustiveTestAVX2(const ExhaustiveTestData& d, int64_t begin, int64_t end)
+		{
+			const __m256i one = _mm256_set1_epi64x(1);
+			const __m256i four = _mm256_set1_epi64x(4);
+			const __m128i tivShift = _mm_cvtsi32_si128(d.inputSize - d.alpha);
+			const __m128i ssIndexShift = _mm_cvtsi32_si128(d.inputSize - d.ssIndexSize);
+			const __m128i ssShift = _mm_cvtsi32_si128(d.ssShift);
+			const __m128i guardShift = _mm_cvtsi32_si128(d.guardBits);
+			const __m256d magic = _mm256_set1_pd(6755399441055744.0); // 2^52+2^51
+			const __m256d absMask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7fffffffffffffffLL));
+			const __m256d rulp = _mm256_set1_pd(d.rulp);
+			__m256i x = _mm256_add_epi64(_mm256_set1_epi64x(begin), _mm256_set_epi64x(3, 2, 1, 0));
+			for(int64_t x0=begin; x0<end; x0+=4) {
+				__m256i result = _mm256_i64gather_epi64((const long long*) d.tiv, _mm256_srl_epi64(x, tivShift), 8);
+				if(d.compressed) {
+					__m256i ss = _mm256_i64gather_epi64((const long long*) d.ssTIV, _mm256_srl_epi64(x, ssIndexShift), 8);
+					result = _mm256_add_epi64(result, _mm256_sll_epi64(ss, ssShift));
+				}
+				for(int i=0; i<d.m; i++) {
+					const __m128i msbShift = _mm_cvtsi32_si128(d.betai[i]-1);
+					const __m256i lowMask = _mm256_set1_epi64x(d.lowMask[i]);
+					__m256i a = _mm256_and_si256(_mm256_srl_epi64(x, _mm_cvtsi32_si128(d.pi[i])), _mm256_set1_epi64x(d.inMask[i]));
+					__m256i msb = _mm256_srl_epi64(a, msbShift);
+					__m256i index = _mm256_xor_si256(_mm256_and_si256(a, lowMask), _mm256_and_si256(_mm256_sub_epi64(msb, one), lowMask));
+					index = _mm256_add_epi64(index, _mm256_sll_epi64(_mm256_srl_epi64(x, _mm_cvtsi32_si128(d.inputSize - d.gammai[i])), msbShift));
+					__m256i y = _mm256_i64gather_epi64((const long long*) d.toi[i], index, 8);
+					__m256i complement = _mm256_cmpeq_epi64(msb, _mm256_set1_epi64x(d.negative[i]));
+					result = _mm256_add_epi64(result, _mm256_xor_si256(y, complement));
+				}
+				// arithmetic shift: (result ^ sign) >> g ^ sign
+				__m256i sign = _mm256_cmpgt_epi64(_mm256_setzero_si256(), result);
+				result = _mm256_xor_si256(_mm256_srl_epi64(_mm256_xor_si256(result, sign), guardShift), sign);
+				// int64 to double: result + 2^52+2^51 has the bits of a double of the same value
+				__m256d fresult = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_add_epi64(result, _mm256_castpd_si256(magic))), magic);
+				__m256d error = _mm256_and_pd(_mm256_sub_pd(_mm256_mul_pd(fresult, rulp), _mm256_loadu_pd(d.ref + x0)), absMask);
+				if(_mm256_movemask_pd(_mm256_cmp_pd(error, rulp, _CMP_GE_OQ)))
+					return false;
+				x = _mm256_add_epi64(x, four);
+			}
+			return true;
+		}
+#endif
+	} // namespace
+
+
 	bool Multipartite::exhaustiveTest(){
-		double maxError=0;
 		double rulp=1;
-		int lsbIn=mpt->f->lsbIn;
 		int lsbOut=mpt->f->lsbOut;
 		if(lsbOut<0)
 				rulp = 1.0 / ((double) (1<<(-lsbOut)));
 		if(lsbOut>0)
 			rulp =  (double) (1<<lsbOut);
-		for (int x=0; x<(1<<inputSize); x++) {
-			int64_t result;
-			if(!mpt->compressTIV) {
-				int a = x>>(inputSize-alpha);
-				int64_t yTIV = tiv[a];
-				result = yTIV;
-#if ETDEBUG
-				cerr 	<< "  x=" << x<< " tiv=" << result;
-#endif
-			}
-			else { //compressed table
-				int aa = x>>(inputSize-dcTIV.subsamplingIndexSize);
-				int64_t ySSTIV = ssTIV[aa];
-
-				int adiff = x>>(inputSize-alpha);
-				int64_t yDiffTIV = diffTIV[adiff];
-				result = (ySSTIV << dcTIV.subsamplingShift()) + yDiffTIV;
-#if ETDEBUG
-				cerr 	<< "  x=" << x<< " yssTIV=" << ySSTIV << " yDiffTIV=" << yDiffTIV ;
-#endif
-			}
-			for(int i=0; i<m; i++) {
-				int aTOi = (x>>pi[i]) & ((1<<betai[i])-1);
-				int sign = 1-(aTOi >> (betai[i]-1) );
-#if ETDEBUG
-				cerr << "  aTO" << i << "I=" << aTOi << "  s=" << sign << "  ";
-#endif
-				aTOi = (aTOi & ((1<<(betai[i]-1))-1));
-				if(sign==1)
-					aTOi =  ((1<<(betai[i]-1))-1)  - aTOi;
-				aTOi +=   ((x>>(inputSize-gammai[i])) << (betai[i]-1));
-				int64_t yTOi = toi[i][aTOi];
-#if ETDEBUG
-				cerr << " aTO" << i << "F=" << aTOi << " yTOi="  << yTOi;
-#endif
-				if(negativeTOi[i])
-					sign=1-sign;
-				if(sign==1)
-					yTOi = ~yTOi;
-				result += yTOi;
-			}
-			//final rounding
-			result = result >> guardBits;
-			double fresult = ((double) result) * rulp;
-			double ref = f->eval(   ((double)x) / ((double)(1<<(-lsbIn))) );
-			double error = abs(fresult-ref);
-			maxError = max(maxError, error);
-#if ETDEBUG
-			cerr //<< ((double)x) / ((double)(1<<(-lsbIn)))
-			  << "  sum=" << result<< " fresult=" << fresult << "ref=" <<ref << "   e=" << error << " u=" <<rulp << (error > rulp ? " *******  Error here":"") <<  endl;
-#endif
+		if(mpt->exhaustiveTestReference.empty())
+			mpt->buildExhaustiveTestReference();
+
+		ExhaustiveTestData d;
+		d.inputSize = inputSize;
+		d.alpha = alpha;
+		d.m = m;
+		d.guardBits = guardBits;
+		d.compressed = mpt->compressTIV;
+		d.ssIndexSize = d.compressed ? dcTIV.subsamplingIndexSize : 0;
+		d.ssShift = d.compressed ? dcTIV.subsamplingShift() : 0;
+		d.tiv = d.compressed ? diffTIV.data() : tiv.data();
+		d.ssTIV = ssTIV.data();
+		for(int i=0; i<m; i++) {
+			d.toi.push_back(toi[i].data());
+			d.inMask.push_back((int64_t(1) << betai[i]) - 1);
+			d.lowMask.push_back((int64_t(1) << (betai[i]-1)) - 1);
+			d.negative.push_back(negativeTOi[i] ? 1 : 0);
+		}
+		d.pi = pi;
+		d.betai = betai;
+		d.gammai = gammai;
+		d.ref = mpt->exhaustiveTestReference.data();
+		d.rulp = rulp;
+
+		int64_t n = int64_t(1) << inputSize;
+#if MULTIPARTITE_AVX2
+		if(outputSize < 50 && __builtin_cpu_supports("avx2")) {
+			int64_t vectorEnd = n & ~int64_t(3);
+			return exhaustiveTestAVX2(d, 0, vectorEnd) && exhaustiveTestScalar(d, vectorEnd, n);
 		}
-		return (maxError < rulp);
+#endif
+		return exhaustiveTestScalar(d, 0, n);
 	}
 
 }
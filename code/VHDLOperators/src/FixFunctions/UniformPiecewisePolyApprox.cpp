@@ -33,11 +33,13 @@
 #include "flopoco/FixFunctions/UniformPiecewisePolyApprox.hpp"
 #include "flopoco/Tables/DiffCompressedTable.hpp"
 #include "flopoco/Tables/Table.hpp"
+#include "flopoco/Tools/DiskCache.hpp"
+#include "flopoco/Tools/WorkerProcesses.hpp"
 
 namespace flopoco{
 
-	UniformPiecewisePolyApprox::UniformPiecewisePolyApprox(FixFunction *f_, double targetAccuracy_, int degree_):
-		degree(degree_), f(f_), targetAccuracy(targetAccuracy_)
+	UniformPiecewisePolyApprox::UniformPiecewisePolyApprox(FixFunction *f_, double targetAccuracy_, int degree_, int workers_):
+		degree(degree_), f(f_), targetAccuracy(targetAccuracy_), workers(workers_)
 	{
 		needToFreeF = false;
 		srcFileName="UniformPiecewisePolyApprox"; // should be somehow static but this is too much to ask me
@@ -45,8 +47,8 @@ namespace flopoco{
 	}
 
 
-	UniformPiecewisePolyApprox::UniformPiecewisePolyApprox(string sollyaString_, double targetAccuracy_, int degree_):
-		degree(degree_), targetAccuracy(targetAccuracy_)
+	UniformPiecewisePolyApprox::UniformPiecewisePolyApprox(string sollyaString_, double targetAccuracy_, int degree_, int workers_):
+		degree(degree_), targetAccuracy(targetAccuracy_), workers(workers_)
 	{
 		//  parsing delegated to FixFunction
 		f = new FixFunction(sollyaString_, false /* on [0,1]*/);
@@ -97,16 +99,11 @@ namespace flopoco{
 	// split into smaller and smaller intervals until the function can be approximated by a polynomial of degree given by degree.
 	void UniformPiecewisePolyApprox::build()
 	{
-		ostringstream cacheFileName;
-		cacheFileName << "PiecewisePoly_"<<vhdlize(f->description) << "_" << degree << "_" << targetAccuracy << ".cache";
+		string key = (DiskCache::isEnabled() ? cacheKey() : "");
 
-		// Test existence of cache file, create it if necessary
-		openCacheFile(cacheFileName.str());
-
-		if(!cacheFile.is_open())
+		if(key.empty() || !readFromCache(key))
 		{
 			//********************** Do the work, then write the cache *********************
-			sollya_obj_t fS = f->fS; // no need to free this one
 			sollya_obj_t rangeS;
 
 			rangeS  = sollya_lib_parse_string("[-1;1]");
@@ -116,41 +113,9 @@ namespace flopoco{
 
 			// Limit alpha to 24, because alpha will be the number of bits input to a table
 			// it will take too long before that anyway
-			bool alphaOK;
-			for (alpha=0; alpha<24; alpha++)
-			{
-				nbIntervals = 1<<alpha;
-				alphaOK = true;
-				REPORT(LogLevel::VERBOSE, " Testing alpha=" << alpha );
-				for (int i=0; i<nbIntervals; i++) {
-					// The worst case is typically on the left (i==0) or on the right (i==nbIntervals-1).
-					// To test these two first, we do this small rotation of i
-					int ii=(i+nbIntervals-1) & ((1<<alpha)-1);
-
-					// First build g_i(x) = f(2^(-alpha)*x + i*2^(-alpha))
-					sollya_obj_t giS = buildSubIntervalFunction(fS, alpha, ii);
-
-					if(is_log_lvl_enabled(LogLevel::DEBUG))
-						sollya_lib_printf("> UniformPiecewisePolyApprox: alpha=%d, ii=%d, testing  %b \n", alpha, ii, giS);
-					// Now what degree do we need to approximate gi?
-					int degreeInf, degreeSup;
-					BasicPolyApprox::guessDegree(giS, rangeS, targetAccuracy, &degreeInf, &degreeSup);
-					// REPORT(LogLevel::DEBUG, " guessDegree returned (" << degreeInf <<  ", " << degreeSup<<")" ); // no need to report, it is done by guessDegree()
-					sollya_lib_clear_obj(giS);
-					// For now we only consider degreeSup. Is this a TODO?
-					if(degreeSup>degree) {
-						REPORT(LogLevel::DEBUG, "   alpha=" << alpha << " failed." );
-						alphaOK=false;
-						break;
-					}
-				} // end for loop on i
-
-				// Did we succeed?
-				if (alphaOK)
-					break;
-			} // end for loop on alpha
-
-			if (alphaOK)
+			alpha = searchAlpha(rangeS);
+			nbIntervals = 1<<alpha;
+			if (alpha<24)
 				REPORT(LogLevel::DETAIL, "Found alpha=" << alpha);
 
 			// Compute the LSB of each coefficient. Minimum value is:
@@ -169,65 +134,14 @@ namespace flopoco{
 
 			bool success=false;
 			while(!success) {
-				// Now fill the vector of polynomials, computing the coefficient parameters along.
-				//		LSB=INT_MAX; // very large
-				// MSB=INT_MIN; // very small
-				approxErrorBound = 0.0;
-				BasicPolyApprox *p;
-
 				REPORT(LogLevel::VERBOSE, "Computing the actual polynomials ");
-				// initialize the vector of MSB weights
-				for (int j=0; j<=degree; j++) {
-					MSB.push_back(INT_MIN);
-				}
-
-				for (int i=0; i<nbIntervals; i++) {
-					REPORT(LogLevel::VERBOSE, " ... computing polynomial approx for interval " << i << " / "<< nbIntervals);
-					// Recompute the substitution. No big deal.
-					sollya_obj_t giS = buildSubIntervalFunction(fS, alpha, i);
-
-					p = new BasicPolyApprox(giS, degree, LSB, true);
-					poly.push_back(p);
-					if (approxErrorBound < p->getApproxErrorBound()){
-						REPORT(LogLevel::DEBUG, "   new approxErrorBound=" << p->getApproxErrorBound() );
-						approxErrorBound = p->getApproxErrorBound();
-					}
-					if (approxErrorBound>targetAccuracy){
-						break; // fail, exit for loop
-					}
-
-					// Now compute the englobing MSB for each coefficient
-					for (int j=0; j<=degree; j++) {
-						// if the coeff is zero, we can set its MSB to anything, so we exclude this case
-						if (  (!p->getCoeff(j)->isZero())  &&  (p->getCoeff(j)->MSB > MSB[j])  )
-							MSB[j] = p->getCoeff(j)->MSB;
-					}
-
-					// Now set the MSB and LSB of the zero coefficients, for consistency
-					// This prevents a future crash in this case
-					for (int j=0; j<=degree; j++) {
-						// if the coeff is zero, we can set its MSB to anything, so we exclude this case
-						if (p->getCoeff(j)->isZero()) {
-							p->getCoeff(j)->MSB = MSB[j]; // before that it was set arbitrary to 1
-							p->getCoeff(j)->LSB = LSB; // before that it was set arbitrary to 0
-							p->getCoeff(j)->width = MSB[j]-LSB+1;
-						}
-					}
-
-				} // end for loop on i
-
-				if (approxErrorBound < targetAccuracy) {
+				if (computePolynomials()) {
 					REPORT(LogLevel::DETAIL, " *** Success! Final approxErrorBound=" << approxErrorBound << "  is smaller than target accuracy: " << targetAccuracy  );
 					success=true;
 				}
 				else {
 					REPORT(LogLevel::DETAIL, "With LSB="<<LSB<<", approx error:" << approxErrorBound << " is larger than target accuracy: " << targetAccuracy
 							<< ". Decreasing LSB and starting over. Thank you for your patience");
-					//empty poly
-					for (auto i:poly)
-						delete i;
-					while(!poly.empty())
-						poly.pop_back();
 
 					if(lsbAttempts<=lsbAttemptsMax) {
 						lsbAttempts++;
@@ -253,18 +167,16 @@ namespace flopoco{
 				}
 			}
 
-			// Write the cache file
-			writeToCacheFile(cacheFileName.str());
+			// Write the cache
+			if(!key.empty())
+				writeToCache(key);
 
 			//cleanup the sollya objects
 			sollya_lib_clear_obj(rangeS);
 		}
 		else
 		{
-			REPORT(LogLevel::DETAIL, "Polynomial data cache found: " << cacheFileName.str());
-			//********************** Just read the cache *********************
-			readFromCacheFile(cacheFileName.str());
-			REPORT(LogLevel::DETAIL, "Polynomial data read: " << cacheFileName.str());
+			REPORT(LogLevel::DETAIL, "Polynomial data read from the cache");
 		} // end if cache
 
 		// Check if all the coefficients of a given degree are of the same sign
@@ -290,6 +202,170 @@ namespace flopoco{
 	}
 
 
+	bool UniformPiecewisePolyApprox::subIntervalFits(sollya_obj_t rangeS, int alpha, int i)
+	{
+		auto cached = subIntervalFitsCache.find(make_pair(alpha, i));
+		if(cached != subIntervalFitsCache.end())
+			return cached->second;
+
+		// First build g_i(x) = f(2^(-alpha)*x + i*2^(-alpha))
+		sollya_obj_t giS = buildSubIntervalFunction(f->fS, alpha, i);
+
+		if(is_log_lvl_enabled(LogLevel::DEBUG))
+			sollya_lib_printf("> UniformPiecewisePolyApprox: alpha=%d, i=%d, testing  %b \n", alpha, i, giS);
+		// Now what degree do we need to approximate gi?
+		int degreeInf, degreeSup;
+		BasicPolyApprox::guessDegree(giS, rangeS, targetAccuracy, &degreeInf, &degreeSup);
+		// REPORT(LogLevel::DEBUG, " guessDegree returned (" << degreeInf <<  ", " << degreeSup<<")" ); // no need to report, it is done by guessDegree()
+		sollya_lib_clear_obj(giS);
+		// For now we only consider degreeSup. Is this a TODO?
+		bool fits = (degreeSup<=degree);
+		subIntervalFitsCache[make_pair(alpha, i)] = fits;
+		return fits;
+	}
+
+
+	int UniformPiecewisePolyApprox::searchAlpha(sollya_obj_t rangeS)
+	{
+		// The worst case is typically on the left (i==0) or on the right (i==2^alpha-1): probe these two only
+		auto extremesFit = [&](int a) {
+			REPORT(LogLevel::VERBOSE, " Probing alpha=" << a );
+			return subIntervalFits(rangeS, a, (1<<a)-1) && subIntervalFits(rangeS, a, 0);
+		};
+
+		// Exponential search for an alpha where the extremes fit: 0, 1, 2, 4, 8, 16, 23
+		int lo=-1; // the extremes do not fit for lo
+		int hi=0;
+		while(!extremesFit(hi)) {
+			if(hi==23) {
+				return 24;
+			}
+			lo=hi;
+			hi=(hi==0 ? 1 : min(2*hi, 23));
+		}
+		// then binary search between them
+		while(hi-lo>1) {
+			int mid=(lo+hi)/2;
+			if(extremesFit(mid))
+				hi=mid;
+			else
+				lo=mid;
+		}
+
+		// Now all the subintervals must fit, the two extremes first (they are memoized)
+		for (int a=hi; a<24; a++) {
+			int n = 1<<a;
+			REPORT(LogLevel::VERBOSE, " Testing alpha=" << a );
+			bool alphaOK = true;
+			for (int i=0; i<n; i++) {
+				// To test the extremes first, we do this small rotation of i
+				if(!subIntervalFits(rangeS, a, (i+n-1) & (n-1))) {
+					REPORT(LogLevel::DEBUG, "   alpha=" << a << " failed." );
+					alphaOK=false;
+					break;
+				}
+			}
+			if (alphaOK)
+				return a;
+		}
+		return 24;
+	}
+
+
+	bool UniformPiecewisePolyApprox::computePolynomials()
+	{
+		// Per subinterval: the error bound of its polynomial (negative if not computed), its coefficients and their MSBs
+		vector<double> errors(nbIntervals, -1.0);
+		vector<vector<mpz_class>> coeffs(nbIntervals, vector<mpz_class>(degree+1));
+		vector<vector<int>> msbs(nbIntervals, vector<int>(degree+1));
+
+		// Position k visits the extremes first, like the alpha search
+		auto subInterval = [&](uint64_t k) { return (int)((k+nbIntervals-1) & (nbIntervals-1)); };
+
+		// Each worker stops its slice at the first polynomial that is not accurate enough
+		auto computeRange = [&](uint64_t first, uint64_t n, int w) {
+			runInWorkerProcesses(n, w,
+				[&](uint64_t begin, uint64_t end, FILE* out) {
+					for(uint64_t k = begin; k < end; k++) {
+						int i = subInterval(first+k);
+						REPORT(LogLevel::VERBOSE, " ... computing polynomial approx for interval " << i << " / "<< nbIntervals);
+						sollya_obj_t giS = buildSubIntervalFunction(f->fS, alpha, i);
+						BasicPolyApprox* p = new BasicPolyApprox(giS, degree, LSB, true);
+						double error = p->getApproxErrorBound();
+						fputc(1, out);
+						fwrite(&error, sizeof(double), 1, out);
+						for (int j=0; j<=degree; j++) {
+							mpz_class c = p->getCoeff(j)->getConstantAsMPZ();
+							fwrite(&p->getCoeff(j)->MSB, sizeof(int), 1, out);
+							mpz_out_raw(out, c.get_mpz_t());
+						}
+						delete p;
+						if (error>targetAccuracy) {
+							fputc(0, out);
+							break;
+						}
+					}
+				},
+				[&](uint64_t begin, uint64_t end, FILE* in) {
+					for(uint64_t k = begin; k < end && fgetc(in) == 1; k++) {
+						int i = subInterval(first+k);
+						bool ok = (fread(&errors[i], sizeof(double), 1, in) == 1);
+						for (int j=0; j<=degree; j++) {
+							ok = ok && (fread(&msbs[i][j], sizeof(int), 1, in) == 1) && (mpz_inp_raw(coeffs[i][j].get_mpz_t(), in) != 0);
+						}
+						if(!ok) {
+							THROWERROR("computePolynomials: could not read back the polynomials computed by a worker");
+						}
+					}
+				});
+		};
+
+		// The two extremes in this process, so that an LSB that is too large fails fast, then the others
+		uint64_t extremes = (nbIntervals < 2 ? nbIntervals : 2);
+		computeRange(0, extremes, 1);
+		bool extremesOK = true;
+		for (uint64_t k=0; k<extremes; k++) {
+			extremesOK = extremesOK && errors[subInterval(k)] >= 0 && errors[subInterval(k)] <= targetAccuracy;
+		}
+		if(extremesOK && nbIntervals > 2) {
+			computeRange(extremes, nbIntervals-extremes, workers);
+		}
+
+		approxErrorBound = 0.0;
+		bool complete = true;
+		for (int i=0; i<nbIntervals; i++) {
+			if (errors[i] < 0) {
+				complete = false; // not computed, because a worse one was found
+			}
+			else if (approxErrorBound < errors[i]){
+				REPORT(LogLevel::DEBUG, "   new approxErrorBound=" << errors[i] );
+				approxErrorBound = errors[i];
+			}
+		}
+		if (!complete || approxErrorBound >= targetAccuracy) {
+			return false;
+		}
+
+		// Now compute the englobing MSB for each coefficient
+		MSB.assign(degree+1, INT_MIN);
+		for (int i=0; i<nbIntervals; i++) {
+			for (int j=0; j<=degree; j++) {
+				// if the coeff is zero, we can set its MSB to anything, so we exclude this case
+				if (coeffs[i][j] != 0 && msbs[i][j] > MSB[j])
+					MSB[j] = msbs[i][j];
+			}
+		}
+
+		// The zero coefficients keep their MSB here, they are resized to MSB[j] with the others
+		for (int i=0; i<nbIntervals; i++) {
+			BasicPolyApprox* p = new BasicPolyApprox(degree, msbs[i], LSB, coeffs[i]);
+			p->setApproxErrorBound(errors[i]);
+			poly.push_back(p);
+		}
+		return true;
+	}
+
+
 	mpz_class UniformPiecewisePolyApprox::getCoeffAsPositiveMPZ(int i, int d){
 		BasicPolyApprox* p = poly[i];
 		FixConstant* c = p->getCoeff(d);
@@ -297,82 +373,98 @@ namespace flopoco{
 	}
 
 
-	void UniformPiecewisePolyApprox::openCacheFile(string cacheFileName)
+	string UniformPiecewisePolyApprox::cacheKey()
 	{
-		cacheFile.open(cacheFileName.c_str(), ios::in);
-
-		// check for bogus .cache file
-		if(cacheFile.is_open() && cacheFile.peek() == std::ifstream::traits_type::eof())
-		{
-			cacheFile.close();
-			std::remove(cacheFileName.c_str());
-			cacheFile.open(cacheFileName.c_str(), ios::in); // of course this one will fail
-		}
+		string function = BasicPolyApprox::normalizedString(f->fS);
+		string interval = BasicPolyApprox::normalizedString(f->inputRangeS);
+		if(function.empty() || interval.empty())
+			return "";
+		ostringstream key;
+		key << "UniformPiecewisePolyApprox f=" << function << " interval=" << interval << " degree=" << degree << " accuracy=" << setprecision(17) << targetAccuracy;
+		return key.str();
 	}
 
 
-	void UniformPiecewisePolyApprox::writeToCacheFile(string cacheFileName)
+	void UniformPiecewisePolyApprox::writeToCache(string key)
 	{
-		cacheFile.open(cacheFileName.c_str(), ios::out);
-
-		cacheFile << "Polynomial data cache for " << cacheFileName << endl;
-		cacheFile << "Erasing this file is harmless, but do not try to edit it." <<endl;
+		ostringstream cache;
+		cache << setprecision(17);
 
-		cacheFile << degree <<endl;
-		cacheFile << alpha <<endl;
-		cacheFile << LSB <<endl;
+		cache << degree <<endl;
+		cache << alpha <<endl;
+		cache << LSB <<endl;
 
 		for (int j=0; j<=degree; j++) {
-			cacheFile << MSB[j] << endl;
+			cache << MSB[j] << endl;
 		}
 
-		cacheFile << approxErrorBound << endl;
+		cache << approxErrorBound << endl;
 
 		// now write the coefficients themselves
 		for(int i=0; i<(1<<alpha); i++)
 		{
 			for (int j=0; j<=degree; j++)
 			{
-				cacheFile <<  poly[i] -> getCoeff(j) -> getConstantAsMPZ() << endl;
+				cache <<  poly[i] -> getCoeff(j) -> getConstantAsMPZ() << endl;
 			}
-			cacheFile << poly[i] -> getApproxErrorBound() << endl;
+			cache << poly[i] -> getApproxErrorBound() << endl;
 		}
+
+		DiskCache::storeEntry(key, ".piecewise", cache.str());
 	}
 
 
-	void UniformPiecewisePolyApprox::readFromCacheFile(string cacheFileName)
+	bool UniformPiecewisePolyApprox::readFromCache(string key)
 	{
-		string line;
-
-		getline(cacheFile, line); // ignore the first line which is a comment
-		getline(cacheFile, line); // ignore the second line which is a comment
-
-		cacheFile >> degree;
-		cacheFile >> alpha;
-		nbIntervals = 1<<alpha;
-		cacheFile >> LSB;
-
+		string contents;
+		if(!DiskCache::loadEntry(key, ".piecewise", contents))
+			return false;
+		istringstream cache(contents);
+
+		// A truncated or corrupted entry is a miss: everything is read and checked before this object is modified
+		int cachedDegree, cachedAlpha, cachedLSB;
+		cache >> cachedDegree >> cachedAlpha >> cachedLSB;
+		if(!cache || cachedDegree!=degree || cachedAlpha<0 || cachedAlpha>24)
+			return false;
+
+		vector<int> cachedMSB;
 		for (int j=0; j<=degree; j++) {
 			int msb;
-			cacheFile >> msb;
-			MSB.push_back(msb);
+			cache >> msb;
+			cachedMSB.push_back(msb);
 		}
 
-		cacheFile >> approxErrorBound;
+		double cachedErrorBound;
+		cache >> cachedErrorBound;
 
-		for (int i=0; i<(1<<alpha); i++) {
+		vector<vector<mpz_class>> coeffs;
+		vector<double> errorBounds;
+		for (int i=0; i<(1<<cachedAlpha) && cache; i++) {
 			vector<mpz_class> coeff;
 			for (int j=0; j<=degree; j++) {
 				mpz_class c;
-				cacheFile >> c;
+				cache >> c;
 				coeff.push_back(c);
 			}
-			BasicPolyApprox* p = new BasicPolyApprox(degree,MSB,LSB,coeff);
-			poly.push_back(p);
+			coeffs.push_back(coeff);
 			double aeb;
-			cacheFile >> aeb;
-			p->setApproxErrorBound(aeb);
+			cache >> aeb;
+			errorBounds.push_back(aeb);
+		}
+		if(!cache || !(cache >> ws).eof())
+			return false;
+
+		alpha = cachedAlpha;
+		nbIntervals = 1<<alpha;
+		LSB = cachedLSB;
+		MSB = cachedMSB;
+		approxErrorBound = cachedErrorBound;
+		for (int i=0; i<(1<<alpha); i++) {
+			BasicPolyApprox* p = new BasicPolyApprox(degree,MSB,LSB,coeffs[i]);
+			p->setApproxErrorBound(errorBounds[i]);
+			poly.push_back(p);
 		}
+		return true;
 	}
 
 	void UniformPiecewisePolyApprox::checkCoefficientsSign()
@@ -429,7 +521,7 @@ namespace flopoco{
 		ui.parseFloat(args, "targetAcc", &ta);
 		ui.parseInt(args, "d", &d);
 
-		UniformPiecewisePolyApprox *ppa = new UniformPiecewisePolyApprox(f, ta, d);
+		UniformPiecewisePolyApprox *ppa = new UniformPiecewisePolyApprox(f, ta, d, target->getThreads());
 		cout << "Accuracy is " << ppa->approxErrorBound << " ("<< log2(ppa->approxErrorBound) << " bits)";
 
 		return NULL;
@@ -24,6 +24,8 @@
 
 */
 #include "flopoco/FixFunctions/VaryingPiecewisePolyApprox.hpp"
+#include "flopoco/Tools/DiskCache.hpp"
+#include <iomanip>
 #include <sstream>
 #include <limits.h>
 #include <float.h>
@@ -87,13 +89,9 @@ namespace flopoco {
 	// split into smaller and smaller intervals until the function can be approximated by a polynomial of degree given by degree.
 	void VaryingPiecewisePolyApprox::build()
 	{
-		ostringstream cacheFileName;
-		cacheFileName << "VaryingPiecewisePoly_"<<vhdlize(f->description) << "_" << degree << "_" << targetAccuracy << ".cache";
+		string key = (DiskCache::isEnabled() ? cacheKey() : "");
 
-		// Test existence of cache file, create it if necessary
-		openCacheFile(cacheFileName.str());
-
-		if(!cacheFile.is_open())
+		if(key.empty() || !readFromCache(key))
 		{
 			//********************** Do the work, then write the cache *********************
 			msbOut = f->msbOut;
@@ -267,17 +265,16 @@ namespace flopoco {
 			  free(g);
 			}
 				    
-			// Write the cache file
-			writeToCacheFile(cacheFileName.str());
+			// Write the cache
+			if(!key.empty())
+				writeToCache(key);
 
 			//cleanup the sollya objects
 			sollya_lib_clear_obj(rangeS);
 		}
 		else
 		{
-			REPORT(LogLevel::DETAIL, "Polynomial data cache found: " << cacheFileName.str());
-			//********************** Just read the cache *********************
-			readFromCacheFile(cacheFileName.str());
+			REPORT(LogLevel::DETAIL, "Polynomial data read from the cache");
 		} // end if cache
 
 		// Check if all the coefficients of a given degree are of the same sign
@@ -301,92 +298,112 @@ namespace flopoco {
 	}
 
 
-	void VaryingPiecewisePolyApprox::openCacheFile(string cacheFileName)
+	string VaryingPiecewisePolyApprox::cacheKey()
 	{
-		cacheFile.open(cacheFileName.c_str(), ios::in);
-
-		// check for bogus .cache file
-		if(cacheFile.is_open() && cacheFile.peek() == std::ifstream::traits_type::eof())
-		{
-			cacheFile.close();
-			std::remove(cacheFileName.c_str());
-			cacheFile.open(cacheFileName.c_str(), ios::in); // of course this one will fail
-		}
+		string function = BasicPolyApprox::normalizedString(f->fS);
+		string interval = BasicPolyApprox::normalizedString(f->inputRangeS);
+		if(function.empty() || interval.empty())
+			return "";
+		ostringstream key;
+		key << "VaryingPiecewisePolyApprox f=" << function << " interval=" << interval << " lsbIn=" << lsbIn << " msbOut=" << msbOut << " lsbOut=" << lsbOut
+				<< " accuracy=" << setprecision(17) << targetAccuracy;
+		return key.str();
 	}
 
 
-	void VaryingPiecewisePolyApprox::writeToCacheFile(string cacheFileName)
+	void VaryingPiecewisePolyApprox::writeToCache(string key)
 	{
-		cacheFile.open(cacheFileName.c_str(), ios::out);
-
-		cacheFile << "Polynomial data cache for " << cacheFileName << endl;
-		cacheFile << "Erasing this file is harmless, but do not try to edit it." <<endl;
+		ostringstream cache;
+		cache << setprecision(17);
 
-		cacheFile << degree <<endl;
-		cacheFile << nbInterval << endl;
-		cacheFile << LSB <<endl;
-		cacheFile << tabulateRest << endl;
+		cache << degree <<endl;
+		cache << nbInterval << endl;
+		cache << LSB <<endl;
+		cache << tabulateRest << endl;
 
 		for (int j=0; j<=degree; j++) {
-			cacheFile << MSB[j] << endl;
+			cache << MSB[j] << endl;
 		}
 
-		cacheFile << approxErrorBound << endl;
+		cache << approxErrorBound << endl;
 
-		// now write the coefficients themselves
+		// now write the coefficients themselves, as readFromCache() expects them
 		for(int i=0; i<nbInterval; i++){
-		
+
 			for (int j=0; j<=degree; j++)
 			{
-				cacheFile <<  poly[i] -> getCoeff(j) -> getBitVectorAsMPZ() << endl;
+				cache <<  poly[i] -> getCoeff(j) -> getConstantAsMPZ() << endl;
 			}
 		}
 
 		if (tabulateRest==true) {
 		  for (int i=0; i<(1<<6); i++) {
-		    cacheFile << table[i]<< endl;
+		    cache << table[i]<< endl;
 		  }
 		}
+
+		DiskCache::storeEntry(key, ".piecewise", cache.str());
 	}
 
 
-	void VaryingPiecewisePolyApprox::readFromCacheFile(string cacheFileName)
+	bool VaryingPiecewisePolyApprox::readFromCache(string key)
 	{
-		string line;
-
-		getline(cacheFile, line); // ignore the first line which is a comment
-		getline(cacheFile, line); // ignore the second line which is a comment
-
-		cacheFile >> degree;
-		cacheFile >> nbInterval;
-		cacheFile >> LSB;
-		cacheFile >> tabulateRest;
-
-		for (int j=0; j<=degree; j++) {
+		string contents;
+		if(!DiskCache::loadEntry(key, ".piecewise", contents))
+			return false;
+		istringstream cache(contents);
+
+		// A truncated or corrupted entry is a miss: everything is read and checked before this object is modified
+		int cachedDegree, cachedNbInterval, cachedLSB;
+		bool cachedTabulateRest;
+		cache >> cachedDegree >> cachedNbInterval >> cachedLSB >> cachedTabulateRest;
+		// build() tries at most -lsbIn-6 intervals, and no polynomial has a degree anywhere near 64
+		if(!cache || cachedDegree<0 || cachedDegree>64 || cachedNbInterval<0 || cachedNbInterval>max(-lsbIn, 0))
+			return false;
+
+		vector<int> cachedMSB;
+		for (int j=0; j<=cachedDegree; j++) {
 			int msb;
-			cacheFile >> msb;
-			MSB.push_back(msb);
+			cache >> msb;
+			cachedMSB.push_back(msb);
 		}
 
-		cacheFile >> approxErrorBound;
+		double cachedErrorBound;
+		cache >> cachedErrorBound;
 
-		for (int i=0; i<nbInterval; i++) {
+		vector<vector<mpz_class>> coeffs;
+		for (int i=0; i<cachedNbInterval && cache; i++) {
 			vector<mpz_class> coeff;
-			for (int j=0; j<=degree; j++) {
+			for (int j=0; j<=cachedDegree; j++) {
 				mpz_class c;
-				cacheFile >> c;
+				cache >> c;
 				coeff.push_back(c);
 			}
-			BasicPolyApprox* p = new BasicPolyApprox(degree,MSB,LSB,coeff);
-			poly.push_back(p);
+			coeffs.push_back(coeff);
 		}
-		if (tabulateRest==true) {
+		vector<mpz_class> cachedTable;
+		if (cachedTabulateRest==true) {
 		  for (int i=0; i<(1<<6); i++) {
 		    mpz_class c;
-		    cacheFile >> c;
-		    table.push_back(c);
+		    cache >> c;
+		    cachedTable.push_back(c);
 		  }
 		}
+		if(!cache || !(cache >> ws).eof())
+			return false;
+
+		degree = cachedDegree;
+		nbInterval = cachedNbInterval;
+		LSB = cachedLSB;
+		tabulateRest = cachedTabulateRest;
+		MSB = cachedMSB;
+		approxErrorBound = cachedErrorBound;
+		for (int i=0; i<nbInterval; i++) {
+			BasicPolyApprox* p = new BasicPolyApprox(degree,MSB,LSB,coeffs[i]);
+			poly.push_back(p);
+		}
+		table = cachedTable;
+		return true;
 	}
 
 
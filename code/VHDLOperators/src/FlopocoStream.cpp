@@ -29,6 +29,7 @@
 
 #include "flopoco/FlopocoStream.hpp"
 #include "flopoco/Operator.hpp"
+#include "flopoco/Tools/PhaseTrace.hpp"
 
 
 using namespace std;
@@ -55,6 +56,7 @@ namespace flopoco{
 
 
 	FlopocoStream::~FlopocoStream(){
+		delete lexer;
 	}
 
 	string FlopocoStream::str(){
@@ -75,36 +77,32 @@ namespace flopoco{
 
 
 	void FlopocoStream::flushAndParseAndBuildDependencyTable(){
-		ostringstream bufferCode;
-
 		if(op->noParseNoSchedule()) {
 			vhdlCode << vhdlCodeBuffer.str();			
 			codeParsed = true;
 			vhdlCodeBuffer.str("");
 		}
 		else {
+			// one copy out of the ostringstream, then the lexer scans this string in place
+			string code = vhdlCodeBuffer.str();
 			//parse the buffer if it is not empty
-			if(vhdlCodeBuffer.str() != string(""))
+			if(!code.empty())
 				{
-					//scan the code buffer and build the dependence table and annotate the code
-					bufferCode.str("");
-					
-					//parse the code, if required
-					istringstream in(vhdlCodeBuffer.str());
-		
-					//instantiate the flex++ object  for lexing the buffer info
-					LexerContext* lexer = new LexerContext(op, &in, &bufferCode, &lexLhsName, &lexExtraRhsNames, &lexDependenceTable, &lexLexingMode, &lexLexingModeOld, &lexIsLhsSet);
-					
-					//call the FlexLexer++ on the buffer. The lexing output is
-					//	in the variable bufferCode. Additionally, a temporary table lexer->dependenceTable 
+					//the flex++ object is built once per stream, and reused for each flush
+					if(lexer == nullptr)
+						lexer = new LexerContext(op, nullptr, &vhdlCode, &lexLhsName, &lexExtraRhsNames, &lexDependenceTable, &lexLexingMode, &lexLexingModeOld, &lexIsLhsSet);
+
+					//call the FlexLexer++ on the buffer. The annotated code is directly
+					//	appended to vhdlCode. Additionally, a temporary table lexer->dependenceTable 
 					//	containing the triplets <lhsName, rhsName, delay> is created
 					try
 						{
-							lexer->lex();
+							TRACE_PHASE("lex", op->getName());
+							lexer->lex(code);
 						}catch(string &e)
 						{
 							cerr << "Lexing failed: " << e << endl;
-							cerr << "on the following VHDL code:" << vhdlCodeBuffer.str() << endl;
+							cerr << "on the following VHDL code:" << code << endl;
 							exit(1);
 						}
 
@@ -122,9 +120,6 @@ namespace flopoco{
 					vhdlCodeBuffer.str("");
 					//fix the dependence table in case of (rhs1, rhs2) <= ... 
 					cleanupDependenceTable();
-
-					//the newly processed code is appended to the existing one
-					vhdlCode << bufferCode.str();
 				}
 		}
 	}
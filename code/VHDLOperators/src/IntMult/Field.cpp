@@ -1,12 +1,13 @@
 #include "flopoco/IntMult/Field.hpp"
+#include <algorithm>
 #include <iostream>
 
 namespace flopoco {
     Field::Field(unsigned int wX, unsigned int wY, bool signedIO, FieldState& baseState) : wX_(wX), wY_(wY), signedIO_(signedIO), currentStateID_(0U), baseState_{&baseState} {
-        field_.resize(wY_);
-        for(unsigned int i = 0; i < wY_; i++) {
-            field_[i] = vector<ID>(wX_, currentStateID_);
-        }
+        words_ = (wX_ + 63) / 64;
+        baseBits_.assign(wY_ * words_, 0);
+        stateBits_.assign(wY_ * words_, 0);
+        rowOwner_.assign(wY_, currentStateID_);
         currentStateID_++;
 
         initFieldState(baseState);
@@ -16,20 +17,18 @@ namespace flopoco {
     Field::Field(const Field &copy) {
         wX_ = copy.wX_;
         wY_ = copy.wY_;
-
-        field_.resize(wY_);
-        for(unsigned int i = 0U; i < wY_; i++) {
-            field_[i].resize(wX_);
-            for(unsigned int j = 0; j < wX_; j++) {
-                field_[i][j] = copy.field_[i][j];
-            }
-        }
+        words_ = copy.words_;
+        baseBits_ = copy.baseBits_;
+        stateBits_ = copy.stateBits_;
+        rowOwner_ = copy.rowOwner_;
+        currentStateID_ = copy.currentStateID_;
+        baseState_ = copy.baseState_;
+        baseID_ = copy.baseID_;
 
         signedIO_ = copy.signedIO_;
     }
 
     Field::~Field() {
-        field_.clear();
     }
 
     void Field::initFieldState(FieldState& fieldState) {
@@ -45,16 +44,61 @@ namespace flopoco {
     void Field::reset() {
         initFieldState(*baseState_);
         baseID_ = baseState_->getID();
+        std::fill(baseBits_.begin(), baseBits_.end(), 0);
+    }
+
+    uint64_t Field::columnMask(unsigned int w, unsigned int x0, unsigned int x1) {
+        unsigned int lo = std::max(x0, 64 * w);
+        unsigned int hi = std::min(x1, 64 * (w + 1));
+        if(lo >= hi) {
+            return 0;
+        }
+        uint64_t mask = (hi - lo == 64) ? ~uint64_t(0) : ((uint64_t(1) << (hi - lo)) - 1);
+        return mask << (lo - 64 * w);
+    }
+
+    unsigned int Field::cover(unsigned int y, unsigned int w, uint64_t mask, ID id) {
+        mask &= ~occupied(y, w, id);
+        if(id == baseID_) {
+            baseBits_[y * words_ + w] |= mask;
+        }
+        else {
+            if(rowOwner_[y] != id) {
+                // the cells of the previous owner of this row belong to a state that was reset since
+                std::fill(stateBits_.begin() + y * words_, stateBits_.begin() + (y + 1) * words_, 0);
+                rowOwner_[y] = id;
+            }
+            stateBits_[y * words_ + w] |= mask;
+        }
+        return __builtin_popcountll(mask);
+    }
+
+    const vector<uint64_t>& Field::shapeMask(const Cursor coord, BaseMultiplierCategory* tile, unsigned int x1, unsigned int y1) {
+        auto key = make_tuple(tile, coord.first, coord.second, x1, y1);
+        auto it = shapeMasks_.find(key);
+        if(it != shapeMasks_.end()) {
+            return it->second;
+        }
+
+        vector<uint64_t>& masks = shapeMasks_[key];
+        masks.assign((y1 - coord.second) * words_, 0);
+        for (unsigned int i = coord.second; i < y1; i++) {
+            for (unsigned int j = coord.first; j < x1; j++) {
+                if (tile->shape_contribution(j, i, coord.first, coord.second, wX_, wY_, signedIO_)) {
+                    masks[(i - coord.second) * words_ + j / 64] |= uint64_t(1) << (j % 64);
+                }
+            }
+        }
+        return masks;
     }
 
     BaseMultiplierParametrization Field::checkDSPPlacement(const Cursor coord, BaseMultiplierCategory* tile, FieldState& fieldState, unsigned int maxX, unsigned int maxY) {
         unsigned int sizeX = std::min((unsigned int)tile->wX_DSPexpanded(coord.first, coord.second, wX_, wY_, signedIO_), maxX);
         unsigned int sizeY = std::min((unsigned int)tile->wY_DSPexpanded(coord.first, coord.second, wX_, wY_, signedIO_), maxY);
-        ID fieldID = fieldState.getID();
 
-        for (unsigned int i = coord.second; i < sizeY + coord.second; i++) {
-            for (unsigned int j = coord.first; j < sizeX + coord.second; j++) {
-                if (field_[i][j] == fieldID || field_[i][j] == baseID_) {
+        for (unsigned int i = coord.second; i < sizeY + coord.second && i < wY_; i++) {
+            for (unsigned int j = coord.first; j < sizeX + coord.second && j < wX_; j++) {
+                if (checkPosition(j, i, fieldState)) {
                     unsigned int area1 = i - coord.second + 1 * maxY;
                     unsigned int area2 = maxX * j - coord.second + 1;
                     if(area1 > area2) {
@@ -67,9 +111,9 @@ namespace flopoco {
             }
         }
 
-        for (unsigned int i = coord.second; i < sizeY; i++) {
-            for (unsigned int j = coord.first; j < sizeX; j++) {
-                if (field_[i][j] == fieldID || field_[i][j] == baseID_) {
+        for (unsigned int i = coord.second; i < sizeY && i < wY_; i++) {
+            for (unsigned int j = coord.first; j < sizeX && j < wX_; j++) {
+                if (checkPosition(j, i, fieldState)) {
                     return tile->parametrize(0, 0, false, false);
                 }
             }
@@ -85,36 +129,36 @@ namespace flopoco {
         unsigned int endY = coord.second + sizeY;
         unsigned int maxX = std::min(endX, wX_);
         unsigned int maxY = std::min(endY, wY_);
+        if (coord.first >= maxX || coord.second >= maxY) {
+            return 0;
+        }
 
         unsigned int covered = 0;
         ID fieldID = fieldState.getID();
+        unsigned int w0 = coord.first / 64;
+        unsigned int w1 = (maxX - 1) / 64;
 
         if (tile->isIrregular() || tile->isKaratsuba()) {
+            const vector<uint64_t>& masks = shapeMask(coord, tile, maxX, maxY);
             for (unsigned int i = coord.second; i < maxY; i++) {
-                for (unsigned int j = coord.first; j < maxX; j++) {
-                    //check if tile could cover this area
-                    if (!tile->shape_contribution(j, i, coord.first, coord.second, wX_, wY_, signedIO_)) {
-                        continue;
-                    }
-
-                    if (field_[i][j] == fieldID || field_[i][j] == baseID_) {
+                for (unsigned int w = w0; w <= w1; w++) {
+                    uint64_t mask = masks[(i - coord.second) * words_ + w];
+                    if (occupied(i, w, fieldID) & mask) {
                         return 0;
                     }
-
-                    covered++;
+                    covered += __builtin_popcountll(mask);
                 }
             }
         }
         else {
             for (unsigned int i = coord.second; i < maxY; i++) {
-                for (unsigned int j = coord.first; j < maxX; j++) {
-                    if (field_[i][j] == fieldID || field_[i][j] == baseID_) {
+                for (unsigned int w = w0; w <= w1; w++) {
+                    if (occupied(i, w, fieldID) & columnMask(w, coord.first, maxX)) {
                         return 0;
                     }
-
-                    covered++;
                 }
             }
+            covered = (maxX - coord.first) * (maxY - coord.second);
         }
 
         return covered;
@@ -131,24 +175,21 @@ namespace flopoco {
         ID fieldID = fieldState.getID();
         unsigned int updateMissing = 0U;
 
-        if(tile->isIrregular() || tile->isKaratsuba()) {
-            for (unsigned int i = coord.second; i < maxY; i++) {
-                for (unsigned int j = coord.first; j < maxX; j++) {
-                    //check if tile could cover this area and if area is free
-                    if (tile->shape_contribution(j, i, coord.first, coord.second, wX_, wY_, signedIO_) &&
-                        field_[i][j] != fieldID && field_[i][j] != baseID_) {
-                        field_[i][j] = fieldID;
-                        updateMissing++;
+        if (coord.first < maxX && coord.second < maxY) {
+            unsigned int w0 = coord.first / 64;
+            unsigned int w1 = (maxX - 1) / 64;
+            if(tile->isIrregular() || tile->isKaratsuba()) {
+                const vector<uint64_t>& masks = shapeMask(coord, tile, maxX, maxY);
+                for (unsigned int i = coord.second; i < maxY; i++) {
+                    for (unsigned int w = w0; w <= w1; w++) {
+                        updateMissing += cover(i, w, masks[(i - coord.second) * words_ + w], fieldID);
                     }
                 }
             }
-        }
-        else {
-            for (unsigned int i = coord.second; i < maxY; i++) {
-                for (unsigned int j = coord.first; j < maxX; j++) {
-                    if (field_[i][j] != fieldID && field_[i][j] != baseID_) {
-                        field_[i][j] = fieldID;
-                        updateMissing++;
+            else {
+                for (unsigned int i = coord.second; i < maxY; i++) {
+                    for (unsigned int w = w0; w <= w1; w++) {
+                        updateMissing += cover(i, w, columnMask(w, coord.first, maxX), fieldID);
                     }
                 }
             }
@@ -169,27 +210,26 @@ namespace flopoco {
     }
 
     unsigned int Field::getMissingLine(FieldState& fieldState) {
-        unsigned int missing = 0U;
         Cursor c = fieldState.getCursor();
         ID fieldID = fieldState.getID();
 
-        for(unsigned int i = c.first; i < wX_; i++) {
-            if(field_[c.second][i] == fieldID || field_[c.second][i] == baseID_) {
-                break;
+        // the first covered cell at or after the cursor, in its row
+        for(unsigned int w = c.first / 64; w < words_; w++) {
+            uint64_t bits = occupied(c.second, w, fieldID) & columnMask(w, c.first, wX_);
+            if(bits != 0) {
+                return 64 * w + __builtin_ctzll(bits) - c.first;
             }
-            missing++;
         }
 
-        return missing;
+        return (c.first < wX_) ? wX_ - c.first : 0U;
     }
 
     unsigned int Field::getMissingHeight(FieldState& fieldState) {
         unsigned int missing = 0U;
         Cursor c = fieldState.getCursor();
-        ID fieldID = fieldState.getID();
 
         for(unsigned int i = c.second; i < wY_; i++) {
-            if(field_[i][c.first] == fieldID || field_[i][c.first] == baseID_) {
+            if(checkPosition(c.first, i, fieldState)) {
                 break;
             }
             missing++;
@@ -199,10 +239,11 @@ namespace flopoco {
     }
 
     void Field::printField() {
-        for(auto v: field_) {
+        for(unsigned int y = 0; y < wY_; y++) {
             string line;
-            for(auto c: v) {
-                char b = '0' + c;
+            for(unsigned int x = 0; x < wX_; x++) {
+                uint64_t bit = uint64_t(1) << (x % 64);
+                char b = (baseBits_[y * words_ + x / 64] & bit) ? '1' : ((stateBits_[y * words_ + x / 64] & bit) ? '2' : '0');
                 line =  string((const char*)&b, 1) + line;
             }
             cout << line << endl;
@@ -210,7 +251,7 @@ namespace flopoco {
     }
 
     bool Field::checkPosition(unsigned int x, unsigned int y, Field::FieldState &fieldState) {
-        return (field_[y][x] == fieldState.getID() || field_[y][x] == baseID_);
+        return (occupied(y, x / 64, fieldState.getID()) >> (x % 64)) & 1;
     }
 
     void Field::setTruncated(unsigned int range, FieldState& fieldState) {
@@ -221,13 +262,9 @@ namespace flopoco {
                 break;
             }
 
-            for(unsigned int x = 0; x < wX_; x++) {
-                if(y + x > range) {
-                   break;
-                }
-
-                field_[y][x] = fieldID;
-                updateMissing++;
+            unsigned int x1 = std::min(wX_, range - y + 1);
+            for(unsigned int w = 0; w < words_; w++) {
+                updateMissing += cover(y, w, columnMask(w, 0, x1), fieldID);
             }
         }
 
@@ -235,27 +272,27 @@ namespace flopoco {
         fieldState.updateCursor();
     }
 
-    void Field::setTruncated(unsigned wOut, unsigned prodWidth, unsigned guardBits, unsigned keepBits,  FieldState& fieldState) {
-        cout << "keepBits " << keepBits << " guardBits " << guardBits << " prod " << prodWidth << " wOut " << wOut <<endl;
+    void Field::setTruncated(unsigned int actualLSB, unsigned int keepBits, FieldState& fieldState) {
         ID fieldID = fieldState.getID();
         unsigned int updateMissing = 0;
 
-        int t = IntMultiplier::widthOfDiagonalOfRect(wX_, wY_, (int)prodWidth-wOut-guardBits+1, prodWidth) - keepBits;
-        cout << "t=" << t << " diag=" << IntMultiplier::widthOfDiagonalOfRect(wX_, wY_, (int)prodWidth-wOut-guardBits+1, prodWidth) << endl;
+        // the number of bits to remove from column actualLSB, as computed by IntMultiplier::computeTruncMultParams()
+        int t = -(int)keepBits;
+        for(unsigned int y = 0; y < wY_ && y <= actualLSB; y++) {
+            if(actualLSB - y < wX_) {
+                t++;
+            }
+        }
+
         for(unsigned int y = 0; y < wY_; y++) {
-            for(unsigned int x = 0; x < wX_; x++) {
-                if((x+y) < ((int)prodWidth-wOut-guardBits)){
-                    field_[y][x] = fieldID;
-                    updateMissing++;
-                } else if((x+y) == ((int)prodWidth-wOut-guardBits)){
-                    if((t)?t--:0){
-                        //cout << "NO keepBit at" << x << "," << y << endl;
-                        field_[y][x] = fieldID;
-                        updateMissing++;
-                    } else {
-                        //cout << "keepBit at" << x << "," << y << endl;
-                    }
-                }
+            // columns x+y < actualLSB, and the cell of column actualLSB while some remain to be removed
+            unsigned int x1 = (y < actualLSB) ? std::min(wX_, actualLSB - y) : 0;
+            if(y <= actualLSB && actualLSB - y < wX_ && t > 0) {
+                t--;
+                x1++;
+            }
+            for(unsigned int w = 0; w < words_; w++) {
+                updateMissing += cover(y, w, columnMask(w, 0, x1), fieldID);
             }
         }
 
@@ -264,11 +301,9 @@ namespace flopoco {
     }
 
     void Field::printField(FieldState& fieldState) {
-        ID fieldID = fieldState.getID();
-
-        for(auto v: field_) {
-            for(auto c: v) {
-                cout << (c == fieldID || c == baseID_);
+        for(unsigned int y = 0; y < wY_; y++) {
+            for(unsigned int x = 0; x < wX_; x++) {
+                cout << checkPosition(x, y, fieldState);
             }
             cout << endl;
         }
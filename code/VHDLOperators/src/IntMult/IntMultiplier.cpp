@@ -189,9 +189,7 @@ namespace flopoco {
 
 		TilingStrategy* tilingStrategy;
 
-		// Message to Andreas:
-		// Florent commented out all these methods for you to revive them now that I have converged on the proper interface.
-		// Beware that I also made the option case-insensitive by lowercasing them...
+		// The method names have been lowercased
 		if(tilingMethod.compare("heuristicbasictiling") == 0) {
 			tilingStrategy = new TilingStrategyBasicTiling(
 					wX,
@@ -203,119 +201,108 @@ namespace flopoco {
 					dspOccupationThreshold,
 					((maxDSP<0)?(unsigned)INT_MAX:(unsigned)((useDSP)?maxDSP:0))	);
 		 }
-		// else if(tilingMethod.compare("heuristicgreedytiling") == 0) { 
-		// 	tilingStrategy = new TilingStrategyGreedy(
-		// 			wX,
-		// 			wY,
-		// 			wOut,
-		// 			signedX,
-		// 			&baseMultiplierCollection,
-		// 			baseMultiplierCollection.getPreferedMultiplier(),
-		// 			dspOccupationThreshold,
-		// 			maxDSP,
-		// 			useirregular,
-		// 			use2xk,
-		// 			superTiles,
-		// 			useKaratsuba,
-		// 			multiplierTileCollection,
-		// 			guardBits,
-		// 			lastColumnKeepBits );
-		// }
-		// else if(tilingMethod.compare("heuristicXGreedyTiling") == 0) {
-		// 	tilingStrategy = new TilingStrategyXGreedy(
-		// 			wX,
-		// 			wY,
-		// 			wOut,
-		// 			signedX,
-		// 			&baseMultiplierCollection,
-		// 			baseMultiplierCollection.getPreferedMultiplier(),
-		// 			dspOccupationThreshold,
-		// 			maxDSP,
-		// 			useirregular,
-		// 			use2xk,
-		// 			superTiles,
-		// 			useKaratsuba,
-		// 			multiplierTileCollection,
-		// 			guardBits,
-		// 			lastColumnKeepBits );
-		// }
-	  // else
-		// if(tilingMethod.compare("heuristicbeamsearchtiling") == 0) {
-		// 	tilingStrategy = new TilingStrategyBeamSearch(
-		// 																								wX,
-		// 																								wY,
-		// 																								wOutPlusGuardBits, // was wOut
-		// 																								signedX,
-		// 																								&baseMultiplierCollection,
-		// 																								baseMultiplierCollection.getPreferedMultiplier(),
-		// 																								dspOccupationThreshold,
-		// 																								maxDSP,
-		// 																								useirregular,
-		// 																								use2xk,
-		// 																								superTiles,
-		// 																								useKaratsuba,
-		// 																								multiplierTileCollection,
-		// 																								beamRange,
-		// 																								0, // wasguardBits,
-		// 																								lastColumnKeepBits	);
-		// }
-		// 	else if(tilingMethod.compare("optimal") == 0){
-		// 	tilingStrategy = new TilingStrategyOptimalILP(
-		// 			wX,
-		// 			wY,
-		// 			wOut,
-		// 			signedX,
-		// 			&baseMultiplierCollection,
-		// 			baseMultiplierCollection.getPreferedMultiplier(),
-		// 			dspOccupationThreshold,
-		// 			maxDSP,
-		// 			multiplierTileCollection,
-		// 			guardBits,
-		// 			lastColumnKeepBits,
-		// 			errorBudget,
-		// 			centerErrConstant,
-		// 			optiTrunc,
-		// 			squarer );
-		// }
-		// 	else if(tilingMethod.compare("optimaltilingandcompression") == 0){
-		// 	tilingStrategy = new TilingAndCompressionOptILP(
-		// 			wX,
-		// 			wY,
-		// 			wOut,
-		// 			signedX,
-		// 			&baseMultiplierCollection,
-		// 			baseMultiplierCollection.getPreferedMultiplier(),
-		// 			dspOccupationThreshold,
-		// 			maxDSP,
-		// 			multiplierTileCollection,
-		// 			bh,
-		// 			guardBits,
-		// 			lastColumnKeepBits,
-		// 			errorBudget,
-		// 			centerErrConstant,
-		// 			optiTrunc,
-		// 			minStages
-		// 	);
-
-		// }
-		// else if(tilingMethod.compare("csv") == 0) {
-		// 	tilingStrategy = new TilingStrategyCSV(
-		// 																				 wX,
-		// 																				 wY,
-		// 																				 wOutPlusGuardBits, //was wOut
-		// 																				 signedX,
-		// 																				 &baseMultiplierCollection,
-		// 																				 baseMultiplierCollection.getPreferedMultiplier(),
-		// 																				 dspOccupationThreshold,
-		// 																				 maxDSP,
-		// 																				 useirregular,
-		// 																				 use2xk,
-		// 																				 superTiles,
-		// 																				 useKaratsuba,
-		// 																				 multiplierTileCollection,
-		// 																				 0,// was guardBits,
-		// 																				 lastColumnKeepBits );
-		// }
+		else if(tilingMethod.compare("heuristicgreedytiling") == 0) {
+			tilingStrategy = new TilingStrategyGreedy(
+					wX,
+					wY,
+					signedX,
+					errorBudget,
+					&baseMultiplierCollection,
+					baseMultiplierCollection.getPreferedMultiplier(),
+					dspOccupationThreshold,
+					((maxDSP<0)?(unsigned)INT_MAX:(unsigned)((useDSP)?maxDSP:0)),
+					useirregular,
+					use2xk,
+					superTiles,
+					useKaratsuba,
+					multiplierTileCollection );
+		}
+		else if(tilingMethod.compare("heuristicxgreedytiling") == 0) {
+			tilingStrategy = new TilingStrategyXGreedy(
+					wX,
+					wY,
+					signedX,
+					errorBudget,
+					&baseMultiplierCollection,
+					baseMultiplierCollection.getPreferedMultiplier(),
+					dspOccupationThreshold,
+					((maxDSP<0)?(unsigned)INT_MAX:(unsigned)((useDSP)?maxDSP:0)),
+					useirregular,
+					use2xk,
+					superTiles,
+					useKaratsuba,
+					multiplierTileCollection );
+		}
+		else if(tilingMethod.compare("heuristicbeamsearchtiling") == 0) {
+			tilingStrategy = new TilingStrategyBeamSearch(
+					wX,
+					wY,
+					signedX,
+					errorBudget,
+					&baseMultiplierCollection,
+					baseMultiplierCollection.getPreferedMultiplier(),
+					dspOccupationThreshold,
+					((maxDSP<0)?(unsigned)INT_MAX:(unsigned)((useDSP)?maxDSP:0)),
+					useirregular,
+					use2xk,
+					superTiles,
+					useKaratsuba,
+					multiplierTileCollection,
+					beamRange,
+					op->getTarget()->getBeamThreads() );
+		}
+		else if(tilingMethod.compare("optimal") == 0) {
+			// the beam search tiling is the incumbent of the solver, so that an ILP timeout still yields a good tiling
+			TilingStrategy* warmStart = nullptr;
+			if(!squarer) {
+				warmStart = new TilingStrategyBeamSearch(
+						wX,
+						wY,
+						signedX,
+						errorBudget,
+						&baseMultiplierCollection,
+						baseMultiplierCollection.getPreferedMultiplier(),
+						dspOccupationThreshold,
+						((maxDSP<0)?(unsigned)INT_MAX:(unsigned)((useDSP)?maxDSP:0)),
+						useirregular,
+						use2xk,
+						superTiles,
+						useKaratsuba,
+						multiplierTileCollection,
+						beamRange,
+						op->getTarget()->getBeamThreads() );
+			}
+			tilingStrategy = new TilingStrategyOptimalILP(
+					wX,
+					wY,
+					signedX,
+					errorBudget,
+					&baseMultiplierCollection,
+					baseMultiplierCollection.getPreferedMultiplier(),
+					dspOccupationThreshold,
+					((maxDSP<0)?INT_MAX:((useDSP)?maxDSP:0)),
+					multiplierTileCollection,
+					optiTrunc,
+					squarer,
+					warmStart );
+		}
+		else if(tilingMethod.compare("csv") == 0) {
+			tilingStrategy = new TilingStrategyCSV(
+					wX,
+					wY,
+					signedX,
+					errorBudget,
+					&baseMultiplierCollection,
+					baseMultiplierCollection.getPreferedMultiplier(),
+					dspOccupationThreshold,
+					((maxDSP<0)?(unsigned)INT_MAX:(unsigned)((useDSP)?maxDSP:0)),
+					useirregular,
+					use2xk,
+					superTiles,
+					useKaratsuba,
+					multiplierTileCollection );
+		}
+		// TilingAndCompressionOptILP (optimaltilingandcompression) still has to be ported to this interface
 		else {
 			ostringstream e;
 			e << "Tiling strategy " << tilingMethod << " unknown";
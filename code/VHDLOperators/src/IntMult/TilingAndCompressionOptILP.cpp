@@ -42,7 +42,7 @@ TilingAndCompressionOptILP::TilingAndCompressionOptILP(
         minLutsFocus{!minStages}
 	{
 	    //Check if error bound fits into UINT64 and otherwise use optiTrunc=0
-        cout << errorBudget << endl;
+        REPORT(LogLevel::DEBUG, errorBudget);
         mpz_class max64;
         unsigned long long max64u = (1ULL << 52)-1ULL;//UINT64_MAX; //Limit to dynamic of double type
         mpz_import(max64.get_mpz_t(), 1, -1, sizeof max64u, 0, 0, &max64u);
@@ -50,17 +50,17 @@ TilingAndCompressionOptILP::TilingAndCompressionOptILP(
             mpz_export(&this->errorBudget, 0, -1, sizeof this->errorBudget, 0, 0, errorBudget.get_mpz_t());
         } else {
             if(performOptimalTruncation)
-                cout << "WARNING: errorBudget or constant exceeds the number range of uint64, switching to optiTrunc=0" << endl;
+                REPORT(LogLevel::MESSAGE, "WARNING: errorBudget or constant exceeds the number range of uint64, switching to optiTrunc=0");
             this->errorBudget = 0;
             this->performOptimalTruncation = false;
         }
-        cout << this->errorBudget << endl;
+        REPORT(LogLevel::DEBUG, this->errorBudget);
 
-        cout << "guardBits " << guardBits << " keepBits " << keepBits << endl;
+        REPORT(LogLevel::DEBUG, "guardBits " << guardBits << " keepBits " << keepBits);
 
         for(auto &p:tiles)
         {
-                cout << p->getLUTCost(0, 0, wX, wY, false) << " " << p->getType() << endl;
+                REPORT(LogLevel::DEBUG, p->getLUTCost(0, 0, wX, wY, false) << " " << p->getType());
         }
         pipelineTiles_ = false;  //The combined optimization currently does not support bits that arrive to a later stage of the BH
  	}
@@ -71,7 +71,7 @@ void TilingAndCompressionOptILP::solve()
 #ifndef HAVE_SCALP
     throw "Error, TilingAndCompressionOptILP::solve() was called but FloPoCo was not built with ScaLP library";
 #else
-    cout << "using ILP solver " << target->getILPSolver() << endl;
+    REPORT(LogLevel::DEBUG, "using ILP solver " << target->getILPSolver());
     solver = new ScaLP::Solver(ScaLP::newSolverDynamic({target->getILPSolver(),"Gurobi","CPLEX","SCIP","LPSolve"}));
     solver->timeout = target->getILPTimeout();
 
@@ -80,9 +80,9 @@ void TilingAndCompressionOptILP::solve()
     addFlipFlop();      //Add FF to list of compressors
     addRowAdder();
 
-    cout << "available compressors" << endl;
+    REPORT(LogLevel::DEBUG, "available compressors");
     for(unsigned int i = 0; i < possibleCompressors.size(); i++){
-        cout << possibleCompressors[i]->getStringOfIO() << " cost " << possibleCompressors[i]->area << endl;
+        REPORT(LogLevel::DEBUG, possibleCompressors[i]->getStringOfIO() << " cost " << possibleCompressors[i]->area);
     }
 
     ScaLP::status stat;
@@ -93,7 +93,7 @@ void TilingAndCompressionOptILP::solve()
     do{ //increase stages till a feasible solution is found to get the minimal possible number of compressor stages
         //Try to find a cheaper result with one more stage, check if previous solution was feasible
         if((stat == ScaLP::status::OPTIMAL || stat == ScaLP::status::FEASIBLE || stat == ScaLP::status::TIMEOUT_FEASIBLE) && tryOneMoreStage){
-            cerr << "The result with " << s_max << " stages was " << stat << " but attempting to get a cheaper result with one stage more." << endl;
+            REPORT(LogLevel::DEBUG, "The result with " << s_max << " stages was " << stat << " but attempting to get a cheaper result with one stage more.");
             bestResult = solver->getResult();
             tryOneMoreStage = false;
         }
@@ -104,12 +104,12 @@ void TilingAndCompressionOptILP::solve()
         constructProblem(s_max);
 
         // Try to solve
-        cout << "starting solver, this might take a while..." << endl;
-        solver->quiet = false;
+        REPORT(LogLevel::DEBUG, "starting solver, this might take a while...");
+        solver->quiet = !is_log_lvl_enabled(LogLevel::DEBUG);
         stat = solver->solve();
 
         // print results
-        cerr << "The result is " << stat << endl;
+        REPORT(LogLevel::DEBUG, "The result is " << stat);
         //cerr << solver->getResult() << endl;
         writeSolutionFile(solver->getResult());
 
@@ -119,11 +119,11 @@ void TilingAndCompressionOptILP::solve()
     ScaLP::Result res = solver->getResult();
     if(!bestResult.empty()){
         if(bestResult.objectiveValue <= res.objectiveValue){
-            cout << "The solution with " << s_max-1 << " stages is less or equally expensive (" << bestResult.objectiveValue << ") then with " << s_max << " stages (" << res.objectiveValue << ")" << endl;
+            REPORT(LogLevel::DEBUG, "The solution with " << s_max-1 << " stages is less or equally expensive (" << bestResult.objectiveValue << ") then with " << s_max << " stages (" << res.objectiveValue << ")");
             s_max--;
             writeSolutionFile(bestResult);
         } else {
-            cout << "The solution with " << s_max-1 << " stages is more expensive (" << bestResult.objectiveValue << ") then with " << s_max << " stages (" << res.objectiveValue << ")" << endl;
+            REPORT(LogLevel::DEBUG, "The solution with " << s_max-1 << " stages is more expensive (" << bestResult.objectiveValue << ") then with " << s_max << " stages (" << res.objectiveValue << ")");
             bestResult = res;
         }
     } else bestResult = res;
@@ -137,12 +137,12 @@ void TilingAndCompressionOptILP::solve()
             constructProblem(s_max);
 
             // Try to solve
-            cout << "starting solver, this might take a while..." << endl;
-            solver->quiet = false;
+            REPORT(LogLevel::DEBUG, "starting solver, this might take a while...");
+            solver->quiet = !is_log_lvl_enabled(LogLevel::DEBUG);
             stat = solver->solve();
 
             // print results
-            cerr << "The result is " << stat << endl;
+            REPORT(LogLevel::DEBUG, "The result is " << stat);
             //cerr << solver->getResult() << endl;
             writeSolutionFile(solver->getResult());
         }
@@ -181,15 +181,15 @@ void TilingAndCompressionOptILP::solve()
 		{
 		    if(p.second > 0.5){     //parametrize all multipliers at a certain position, for which the solver returned 1 as solution, to flopoco solution structure
 		        std::string var_name = p.first->getName();
-		        cout << var_name << "\t " << p.second << endl;
+		        REPORT(LogLevel::DEBUG, var_name << "\t " << p.second);
 		        //if(var_name.substr(0,1).compare("k") != 0) continue;
 		        switch(var_name.substr(0,1).at(0)) {
 		            case 'k':{      //decision variables 'k' for placed compressors
 		                int sta_id = stoi(var_name.substr(2, dpSt));
 		                int com_id = stoi(var_name.substr(2 + dpSt + 1, dpK));
 		                int col_id = stoi(var_name.substr(2 + dpSt + 1 + dpK + 1, dpC));
-		                cout << p.second << " compressor" <<  setw(2) << com_id << " stage " << sta_id << " column " <<  setw(3) << col_id
-		                << " compressor type " << ((com_id<(int)possibleCompressors.size())?possibleCompressors[com_id]->getStringOfIO():"?") << endl;
+		                REPORT(LogLevel::DEBUG, p.second << " compressor" <<  setw(2) << com_id << " stage " << sta_id << " column " <<  setw(3) << col_id
+		                << " compressor type " << ((com_id<(int)possibleCompressors.size())?possibleCompressors[com_id]->getStringOfIO():"?"));
 		                if(possibleCompressors[com_id]->type == CompressorType::Variable){
 		                    for(int n = 0; n < (int)lrint(p.second);n++){
 		                        int index = (possibleCompressors[com_id]->subtype == subType::M)?1:0;
@@ -225,7 +225,7 @@ void TilingAndCompressionOptILP::solve()
 		    }
 		}
 
-		cout << "Total compressor LUT-cost: " << compressor_cost << endl;
+		REPORT(LogLevel::DEBUG, "Total compressor LUT-cost: " << compressor_cost);
 
 		replace_row_adders(CompressionStrategy::solution, row_adder);
 
@@ -242,12 +242,12 @@ void TilingAndCompressionOptILP::solve()
 #ifdef HAVE_SCALP
 void TilingAndCompressionOptILP::constructProblem(int s_max)
 {
-    cout << "constructing problem formulation with " << s_max << " stages..." << endl;
+    REPORT(LogLevel::DEBUG, "constructing problem formulation with " << s_max << " stages...");
     wS = tiles.size();
 
 
     //Assemble cost function, declare problem variables
-    cout << "   assembling cost function, declaring problem variables..." << endl;
+    REPORT(LogLevel::DEBUG, "   assembling cost function, declaring problem variables...");
     ScaLP::Term obj;
     int x_neg = 0, y_neg = 0, keepBits_ = keepBits;
     for(int s = 0; s < wS; s++){
@@ -278,7 +278,7 @@ void TilingAndCompressionOptILP::constructProblem(int s_max)
     vector<vector<vector<ScaLP::Variable>>> solve_Vars(wS, vector<vector<ScaLP::Variable>>(wX+x_neg, vector<ScaLP::Variable>(wY+y_neg)));
     ScaLP::Term maxEpsTerm, minEpsTerm, constVecTerm;
     // add the Constraints
-    cout << "   adding the constraints to problem formulation..." << endl;
+    REPORT(LogLevel::DEBUG, "   adding the constraints to problem formulation...");
     for(int y = 0; y < wY; y++){
         for(int x = 0; x < wX; x++){
             stringstream consName;
@@ -342,9 +342,9 @@ void TilingAndCompressionOptILP::constructProblem(int s_max)
             } else if(!performOptimalTruncation && (wOut < (int)prodWidth) && ((x + y) == (int)(prodWidth - wOut - guardBits))){
                 if((keepBits_)?keepBits_--:0){
                     c1Constraint = pxyTerm == (bool)1;
-                    cout << "keepBit at" << x << "," << y << endl;
+                    REPORT(LogLevel::DEBUG, "keepBit at" << x << "," << y);
                 } else {
-                    cout << "NO keepBit at" << x << "," << y << endl;
+                    REPORT(LogLevel::DEBUG, "NO keepBit at" << x << "," << y);
                 }
             } else {
                 c1Constraint = pxyTerm == (bool)1;
@@ -363,8 +363,7 @@ void TilingAndCompressionOptILP::constructProblem(int s_max)
             if (tiles[s]->getDSPCost())
                 nDSPTiles++;
         if (nDSPTiles) {
-            cout << "   adding the constraint to limit the use of DSP-Blocks to " << max_pref_mult_ << " instances..."
-                 << endl;
+            REPORT(LogLevel::DEBUG, "   adding the constraint to limit the use of DSP-Blocks to " << max_pref_mult_ << " instances...");
             stringstream consName;
             consName << "limDSP";
             ScaLP::Term pxyTerm;
@@ -385,7 +384,7 @@ void TilingAndCompressionOptILP::constructProblem(int s_max)
     //make shure the available precision is present in case of truncation
     if(performOptimalTruncation && (wOut < (int)prodWidth))
     {
-        cout << "   multiplier is truncated by " << (int)prodWidth-wOut << " bits (err=" << (unsigned long)wX*(((unsigned long)1<<((int)wOut-guardBits))) << "), ensure sufficient precision..." << endl;
+        REPORT(LogLevel::DEBUG, "   multiplier is truncated by " << (int)prodWidth-wOut << " bits (err=" << (unsigned long)wX*(((unsigned long)1<<((int)wOut-guardBits))) << "), ensure sufficient precision...");
         //cout << "   guardBits=" << guardBits << endl;
         //cout << "   g=" << guardBits << " k=" << keepBits << " errorBudget=" << errorBudget << " difference to conservative est: " << errorBudget-(long long)(((unsigned long)1)<<(prodWidth-(int)wOut-1)-1) << endl;
 
@@ -421,7 +420,7 @@ void TilingAndCompressionOptILP::constructProblem(int s_max)
         solver->addConstraint(cLimConstraint);
 
         //Limit the error budget
-        cout << "  maxErr=" << errorBudget << endl;
+        REPORT(LogLevel::DEBUG, "  maxErr=" << errorBudget);
         ScaLP::Constraint maxErrConstraint = maxEpsTerm - Cvar <= errorBudget - 1;
         stringstream maxErrName;
         maxErrName << "maxEps";
@@ -429,7 +428,7 @@ void TilingAndCompressionOptILP::constructProblem(int s_max)
         solver->addConstraint(maxErrConstraint);
 
         //Limit the error budget
-        cout << "  minErr=" << errorBudget << endl;
+        REPORT(LogLevel::DEBUG, "  minErr=" << errorBudget);
         ScaLP::Constraint minErrConstraint = -minEpsTerm + Cvar <= errorBudget - 1;
         stringstream minErrName;
         minErrName << "minEps";
@@ -539,12 +538,14 @@ void TilingAndCompressionOptILP::constructProblem(int s_max)
     }
 
     // Set the Objective
-    cout << "   setting objective (minimize cost function)..." << endl;
+    REPORT(LogLevel::DEBUG, "   setting objective (minimize cost function)...");
     solver->setObjective(ScaLP::minimize(obj));
 
     // Write Linear Program to file for debug purposes
-    cout << "   writing LP-file for debuging..." << endl;
-    solver->writeLP("tile.lp");
+    if(is_log_lvl_enabled(LogLevel::DEBUG)) {
+        REPORT(LogLevel::DEBUG, "   writing LP-file for debuging...");
+        solver->writeLP("tile.lp");
+    }
 }
 
 void TilingAndCompressionOptILP::C0_bithesp_input_bits(int s, int c, vector<ScaLP::Term> &bitsinCurrentColumn, vector<ScaLP::Term> &inpBitsinColumn, vector<vector<ScaLP::Variable>> &bitsInColAndStage, vector<ScaLP::Variable> &cvBits){
@@ -712,10 +713,10 @@ void TilingAndCompressionOptILP::C0_bithesp_input_bits(int s, int c, vector<ScaL
         }
 
         if(truncError <= maxErr){
-            cout << "OK: actual truncation error=" << truncError << " is smaller than the max. permissible error=" << maxErr << " by " << maxErr-truncError << "." << endl;
+            REPORT(LogLevel::DEBUG, "OK: actual truncation error=" << truncError << " is smaller than the max. permissible error=" << maxErr << " by " << maxErr-truncError << ".");
             return true;
         } else {
-            cout << "WARNING: actual truncation error=" << truncError << " is larger than the max. permissible error=" << maxErr << " by " << truncError-maxErr << "." << endl;
+            REPORT(LogLevel::MESSAGE, "WARNING: actual truncation error=" << truncError << " is larger than the max. permissible error=" << maxErr << " by " << truncError-maxErr << ".");
             return false;
         }
     }
@@ -724,7 +725,7 @@ void TilingAndCompressionOptILP::C0_bithesp_input_bits(int s, int c, vector<ScaL
         //parse tiling solution
         unsigned long long int new_constant = 0;
         double sum[4] = {0, 0, 0, 0};                   //variable to sum the rounded and double decision variables to check for numeric problems
-        if(wOut < (int) prodWidth) cout << "centerErrConstant was: " << centerErrConstant << endl;//new error re-centering constant for truncation from solution
+        if(wOut < (int) prodWidth) REPORT(LogLevel::DEBUG, "centerErrConstant was: " << centerErrConstant);//new error re-centering constant for truncation from solution
         double total_cost = 0 ;
         int dsp_cost = 0, own_lut_cost=0;
         for(auto &p:bestResult.values)
@@ -739,8 +740,8 @@ void TilingAndCompressionOptILP::C0_bithesp_input_bits(int s, int c, vector<ScaL
                         int m_x_pos = stoi(var_name.substr(1 + dpS + x_negative, dpX)) * ((x_negative) ? (-1) : 1);
                         int y_negative = (var_name.substr(1 + dpS + x_negative + dpX, 1) == "m") ? 1 : 0;
                         int m_y_pos = stoi(var_name.substr(1 + dpS + dpX + x_negative + y_negative, dpY)) * ((y_negative) ? (-1) : 1);
-                        cout << "is true:  " << setfill(' ') << setw(dpY) << mult_id << " " << setfill(' ') << setw(dpY) << m_x_pos << " " << setfill(' ') << setw(
-                                dpY) << m_y_pos << " cost: " << setfill(' ') << setw(5) << tiles[mult_id]->getLUTCost(m_x_pos, m_y_pos, wX, wY, signedIO) << endl;
+                        REPORT(LogLevel::DEBUG, "is true:  " << setfill(' ') << setw(dpY) << mult_id << " " << setfill(' ') << setw(dpY) << m_x_pos << " " << setfill(' ') << setw(
+                                dpY) << m_y_pos << " cost: " << setfill(' ') << setw(5) << tiles[mult_id]->getLUTCost(m_x_pos, m_y_pos, wX, wY, signedIO));
 
                         total_cost += (double) tiles[mult_id]->getLUTCost(m_x_pos, m_y_pos, wX, wY, signedIO);
                         own_lut_cost += tiles[mult_id]->ownLUTCost(m_x_pos, m_y_pos, wX, wY, signedIO);
@@ -757,7 +758,7 @@ void TilingAndCompressionOptILP::C0_bithesp_input_bits(int s, int c, vector<ScaL
                     case 'c':{
                         int c_id = stoi(var_name.substr(1, dpC));
                         new_constant |= (1ULL << c_id);
-                        cout << var_name << " pos " << c_id << " dpC " << dpC << endl;
+                        REPORT(LogLevel::DEBUG, var_name << " pos " << c_id << " dpC " << dpC);
                         break;
                     }
                     default:
@@ -777,25 +778,27 @@ void TilingAndCompressionOptILP::C0_bithesp_input_bits(int s, int c, vector<ScaL
                 if (p.second >= 0.5) sum[3] += (1 << shift);
             }
         }
-        cout << "Total LUT cost:" << total_cost << endl;
-        cout << "Own LUT cost:" << own_lut_cost << endl;
-        cout << "Total DSP cost:" << dsp_cost << endl;
+        REPORT(LogLevel::DEBUG, "Total LUT cost:" << total_cost);
+        REPORT(LogLevel::DEBUG, "Own LUT cost:" << own_lut_cost);
+        REPORT(LogLevel::DEBUG, "Total DSP cost:" << dsp_cost);
 
         if(performOptimalTruncation){
             //refresh centerErrConstant according to ILP solution
             mpz_import(centerErrConstant.get_mpz_t(), 1, -1, sizeof new_constant, 0, 0, &new_constant);
-            cout << "centerErrConstant now is: " << centerErrConstant << endl;
+            REPORT(LogLevel::DEBUG, "centerErrConstant now is: " << centerErrConstant);
 
             //check for numeric errors in solution
             optTruncNumericErr = (long long)ceil(fabs((sum[0] + sum[2]) - (sum[1] + sum[3])));
             if(0 < optTruncNumericErr){
-                cout << "Warning: Numeric problems in solution, repeating ILP with Offset for Error of " << optTruncNumericErr << endl;
+                REPORT(LogLevel::DETAIL, "Numeric problems in solution, repeating ILP with Offset for Error of " << optTruncNumericErr);
                 errorBudget -= optTruncNumericErr;      //Reduce errorBudget by scope of numeric derivation for next iteration
             }
         }
     }
 
     void TilingAndCompressionOptILP::writeSolutionFile(ScaLP::Result result) {
+        if(!is_log_lvl_enabled(LogLevel::DEBUG))
+            return;
         ofstream result_file;
         result_file.open("result.txt");
         result_file << result;
@@ -816,7 +819,7 @@ void TilingAndCompressionOptILP::C0_bithesp_input_bits(int s, int c, vector<ScaL
                         //int sta_id = stoi(var_name.substr(2, dpSt));
                         //int col_id = stoi(var_name.substr(2 + dpSt + 1, dpC));
                         //bitsOnBitHeap[sta_id][col_id] += 1;
-                        cout << var_name << "\t " << p.second << endl;
+                        REPORT(LogLevel::DEBUG, var_name << "\t " << p.second);
                         break;
                     }
                     case 'N': {          //bits present in a particular column an stage of BitHeap
@@ -833,20 +836,22 @@ void TilingAndCompressionOptILP::C0_bithesp_input_bits(int s, int c, vector<ScaL
                 }
             }
         }
+        ostringstream drawing;
         for(int c = bitsOnBitHeap[0].size()-1; 0 <= c; c--){
-            cout << setw(colWidth[c]) << ((c%4==0)?'|':' ');
+            drawing << setw(colWidth[c]) << ((c%4==0)?'|':' ');
         }
-        cout << endl;
+        drawing << endl;
         for(unsigned s = 0; s < bitsOnBitHeap.size(); s++){
             for(int c = bitsOnBitHeap[0].size()-1; 0 <= c; c--){
-                cout << setw(colWidth[c]) << bitsOnBitHeap[s][c];
+                drawing << setw(colWidth[c]) << bitsOnBitHeap[s][c];
             }
-            cout << endl;
+            drawing << endl;
         }
+        REPORT(LogLevel::DEBUG, "bits in each stage and column of the bitheap:" << endl << drawing.str());
     }
 
     void TilingAndCompressionOptILP::replace_row_adders(BitHeapSolution &solution, vector<vector<vector<int>>> &row_adders){
-        cout << solution.getSolutionStatus() << endl;
+        REPORT(LogLevel::DEBUG, solution.getSolutionStatus());
         for(int rcType = 0; rcType < 3; rcType++){
             for(unsigned s = 0; s < row_adders.size(); s++){
                 for(unsigned c = 0; c < row_adders[0].size(); c++){
@@ -868,33 +873,33 @@ void TilingAndCompressionOptILP::C0_bithesp_input_bits(int s, int c, vector<ScaL
                                         adder_started = false;
                                         switch(rcType){
                                             case 0:{
-                                                cout << "RCA row adder in stage " << s <<  " from col " << c << " to " << c+ci << " width " << ci+1 << endl;
+                                                REPORT(LogLevel::DEBUG, "RCA row adder in stage " << s <<  " from col " << c << " to " << c+ci << " width " << ci+1);
                                                 BasicCompressor *newCompressor = new BasicRowAdder(bitheap->getOp(), bitheap->getOp()->getTarget(), ci+1);
                                                 //possibleCompressors.push_back(newCompressor);
-                                                cout << solution.getCompressorsAtPosition(s, c).size() << endl;
+                                                REPORT(LogLevel::DEBUG, solution.getCompressorsAtPosition(s, c).size());
                                                 solution.addCompressor(s, c, newCompressor, ci-2);
-                                                cout << solution.getCompressorsAtPosition(s, c).size() << " " << solution.getCompressorsAtPosition(s, c)[0].first->outHeights.size() << endl;
-                                                cout << "ok" << endl;
+                                                REPORT(LogLevel::DEBUG, solution.getCompressorsAtPosition(s, c).size() << " " << solution.getCompressorsAtPosition(s, c)[0].first->outHeights.size());
+                                                REPORT(LogLevel::DEBUG, "ok");
                                                 break;
                                             }
                                             case 1:{
-                                                cout << "ternary row adder in stage " << s <<  " from col " << c << " to " << c+ci << " width " << ci+1 << endl;
+                                                REPORT(LogLevel::DEBUG, "ternary row adder in stage " << s <<  " from col " << c << " to " << c+ci << " width " << ci+1);
                                                 BasicCompressor *newCompressor = new BasicRowAdder(bitheap->getOp(), bitheap->getOp()->getTarget(), ci+1, 3);
                                                 //possibleCompressors.push_back(newCompressor);
-                                                cout << solution.getCompressorsAtPosition(s, c).size() << endl;
+                                                REPORT(LogLevel::DEBUG, solution.getCompressorsAtPosition(s, c).size());
                                                 solution.addCompressor(s, c, newCompressor, ci-2);
-                                                cout << solution.getCompressorsAtPosition(s, c).size() << " " << solution.getCompressorsAtPosition(s, c)[0].first->outHeights.size() << endl;
-                                                cout << "ok" << endl;
+                                                REPORT(LogLevel::DEBUG, solution.getCompressorsAtPosition(s, c).size() << " " << solution.getCompressorsAtPosition(s, c)[0].first->outHeights.size());
+                                                REPORT(LogLevel::DEBUG, "ok");
                                                 break;
                                             }
                                             case 2:{
-                                                cout << "4:2 row adder in stage " << s <<  " from col " << c << " to " << c+ci << " width " << ci+1 << endl;
+                                                REPORT(LogLevel::DEBUG, "4:2 row adder in stage " << s <<  " from col " << c << " to " << c+ci << " width " << ci+1);
                                                 BasicCompressor *newCompressor = new BasicXilinxFourToTwoCompressor(bitheap->getOp(), bitheap->getOp()->getTarget(), ci+1);
                                                 //possibleCompressors.push_back(newCompressor);
-                                                cout << solution.getCompressorsAtPosition(s, c).size() << endl;
+                                                REPORT(LogLevel::DEBUG, solution.getCompressorsAtPosition(s, c).size());
                                                 solution.addCompressor(s, c, newCompressor, ci-2);
-                                                cout << solution.getCompressorsAtPosition(s, c).size() << " " << solution.getCompressorsAtPosition(s, c)[0].first->outHeights.size() << endl;
-                                                cout << "ok" << endl;
+                                                REPORT(LogLevel::DEBUG, solution.getCompressorsAtPosition(s, c).size() << " " << solution.getCompressorsAtPosition(s, c)[0].first->outHeights.size());
+                                                REPORT(LogLevel::DEBUG, "ok");
                                                 break;
                                             }
                                             default:
@@ -1,3 +1,6 @@
+#include <cfloat>
+#include <memory>
+#include <thread>
 #include <utility>
 
 #include "flopoco/IntMult/TilingStrategyBeamSearch.hpp"
@@ -5,11 +8,28 @@
 #include "flopoco/IntMult/NearestPointCursor.hpp"
 
 namespace flopoco {
+    namespace {
+        typedef vector<tuple<BaseMultiplierCategory*, BaseMultiplierParametrization, TilingStrategy::multiplier_coordinates_t>> dsp_blocks_t;
+
+        /** The tiling state as seen by one beam thread: a field of its own, in which the placed tiles are replayed */
+        struct BeamReplica {
+            NearestPointCursor baseState;
+            NearestPointCursor tempState;
+            Field field;
+            unsigned int usedDSPBlocks;
+            double cost;
+            unsigned int area;
+            dsp_blocks_t dspBlocks;
+
+            BeamReplica(unsigned int wX, unsigned int wY, bool signedIO): field(wX, wY, signedIO, baseState), usedDSPBlocks{0}, cost{0.0}, area{0} {}
+        };
+    }
+
     TilingStrategyBeamSearch::TilingStrategyBeamSearch(
             unsigned int wX,
             unsigned int wY,
-            unsigned int wOut,
             bool signedIO,
+            mpz_class errorBudget,
             BaseMultiplierCollection* bmc,
             base_multiplier_id_t prefered_multiplier,
             float occupation_threshold,
@@ -20,18 +40,21 @@ namespace flopoco {
             bool useKaratsuba,
             MultiplierTileCollection& tiles,
             unsigned int beamRange,
-            unsigned guardBits,
-            unsigned keepBits
-            ):TilingStrategyGreedy(wX, wY, wOut, signedIO, bmc, prefered_multiplier, occupation_threshold, maxPrefMult, useIrregular, use2xk, useSuperTiles, useKaratsuba, tiles, guardBits, keepBits),
-            beamRange_{beamRange}
+            unsigned int beamThreads
+            ):TilingStrategyGreedy(wX, wY, signedIO, errorBudget, bmc, prefered_multiplier, occupation_threshold, maxPrefMult, useIrregular, use2xk, useSuperTiles, useKaratsuba, tiles),
+            beamRange_{beamRange},
+            beamThreads_{std::max(1U, beamThreads)}
     {
 
     };
 
     void TilingStrategyBeamSearch::solve() {
-        NearestPointCursor baseState;
-        NearestPointCursor tempState;
-        Field field(wX, wY, signedIO, baseState);
+        vector<unique_ptr<BeamReplica>> replicas;
+        for(unsigned int t = 0; t < beamThreads_; t++) {
+            replicas.emplace_back(new BeamReplica(wX, wY, signedIO));
+            truncateField(replicas[t]->field, replicas[t]->baseState);
+        }
+        BeamReplica& main = *replicas[0];
 
         unsigned int usedDSPBlocks = 0;
         unsigned int range = beamRange_;
@@ -40,61 +63,84 @@ namespace flopoco {
         double bestCost = 0.0;
         unsigned int bestArea = 0;
 
-        if(truncated_) {
-            //field.setTruncated(truncatedRange_, baseState);
-            field.setTruncated(wOut, prodsize_, guardBits_, keepBits_,  baseState);
-        }
-
-        tempState.reset(baseState);
+        main.tempState.reset(main.baseState);
 
-        greedySolution(tempState, nullptr, &path, bestCost, bestArea, usedDSPBlocks);
+        greedySolution(main.tempState, nullptr, &path, bestCost, bestArea, usedDSPBlocks);
         unsigned int next = path.front();
         unsigned int lastPath = next;
         path.pop();
 
-        double currentTotalCost = 0.0;
-        unsigned int currentArea = 0;
-        usedDSPBlocks = 0;
-        vector<tuple<BaseMultiplierCategory*, BaseMultiplierParametrization, multiplier_coordinates_t>> dspBlocks;
-
-        while(baseState.getMissing() > 0) {
+        while(main.baseState.getMissing() > 0) {
             unsigned int minIndex = std::max(0, (int)next - (int)range);
             unsigned int maxIndex = std::min((unsigned int)tiles_.size() - 1, next + range);
 
-            unsigned int neededX = field.getMissingLine(baseState);
-            unsigned int neededY = field.getMissingHeight(baseState);
+            unsigned int neededX = main.field.getMissingLine(main.baseState);
+            unsigned int neededY = main.field.getMissingHeight(main.baseState);
 
             lastPath = next;
             BaseMultiplierCategory* tile = tiles_[next];
 
+            // the alternatives to the greedy path, which do not depend on each other
+            vector<unsigned int> alternatives;
             for (unsigned int i = minIndex; i <= maxIndex; i++) {
                 //check if we got the already calculated greedy path
-                if (i == lastPath) {
-                    continue;
+                if (i != lastPath) {
+                    alternatives.push_back(i);
                 }
+            }
+            vector<double> costs(alternatives.size(), DBL_MAX);
+            vector<unsigned int> areas(alternatives.size(), 0);
+            vector<queue<unsigned int>> paths(alternatives.size());
+
+            auto evaluate = [&](BeamReplica& r, size_t k) {
+                r.tempState.reset(r.baseState);
+                unsigned int tempUsedDSPBlocks = r.usedDSPBlocks;
+                double tempCost = r.cost;
+                unsigned int tempArea = r.area;
+                dsp_blocks_t localDSPBlocks = r.dspBlocks;
+
+                if (placeSingleTile(r.tempState, tempUsedDSPBlocks, nullptr, neededX, neededY, tiles_[alternatives[k]], tempCost, tempArea, bestCost, localDSPBlocks)) {
+                    if(greedySolution(r.tempState, nullptr, &paths[k], tempCost, tempArea, tempUsedDSPBlocks, bestCost, &localDSPBlocks)) {
+                        costs[k] = tempCost;
+                        areas[k] = tempArea;
+                    }
+                }
+            };
 
-                BaseMultiplierCategory* t = tiles_[i];
-
-                tempState.reset(baseState);
-                queue<unsigned int> tempPath;
-                unsigned int tempUsedDSPBlocks = usedDSPBlocks;
-                double tempCost = currentTotalCost;
-                unsigned int tempArea = currentArea;
-
-                vector<tuple<BaseMultiplierCategory*, BaseMultiplierParametrization, multiplier_coordinates_t>> localDSPBlocks = dspBlocks;
+            size_t threads = std::min((size_t)beamThreads_, alternatives.size());
+            if(threads <= 1) {
+                for(size_t k = 0; k < alternatives.size(); k++) {
+                    evaluate(main, k);
+                }
+            }
+            else {
+                vector<thread> workers;
+                for(size_t t = 0; t < threads; t++) {
+                    workers.emplace_back([&, t]() {
+                        for(size_t k = t; k < alternatives.size(); k += threads) {
+                            evaluate(*replicas[t], k);
+                        }
+                    });
+                }
+                for(auto& w: workers) {
+                    w.join();
+                }
+            }
 
-                if (placeSingleTile(tempState, tempUsedDSPBlocks, nullptr, neededX, neededY, t, tempCost, tempArea, bestCost, localDSPBlocks)) {
-                    if(greedySolution(tempState, nullptr, &tempPath, tempCost, tempArea, tempUsedDSPBlocks, bestCost, &localDSPBlocks)) {
-                        bestCost = tempCost;
-                        bestArea = tempArea;
-                        path = std::move(tempPath);
-                        tile = t;
-                    }
+            // same choice as a sequential evaluation in increasing order: the last of the cheapest alternatives, if not worse than the current path
+            for(size_t k = 0; k < alternatives.size(); k++) {
+                if(costs[k] <= bestCost) {
+                    bestCost = costs[k];
+                    bestArea = areas[k];
+                    path = std::move(paths[k]);
+                    tile = tiles_[alternatives[k]];
                 }
             }
 
-            //place single tile
-            placeSingleTile(baseState, usedDSPBlocks, &solution, neededX, neededY, tile, currentTotalCost, currentArea, FLT_MAX, dspBlocks);
+            //place single tile, in all the replicas
+            for(auto& r: replicas) {
+                placeSingleTile(r->baseState, r->usedDSPBlocks, (r.get() == &main ? &solution : nullptr), neededX, neededY, tile, r->cost, r->area, FLT_MAX, r->dspBlocks);
+            }
 
             if(path.size() > 0) {
                 next = path.front();
@@ -103,20 +149,20 @@ namespace flopoco {
         }
 
         if(useSuperTiles_) {
-            performSuperTilePass(&dspBlocks, &solution, currentTotalCost);
+            performSuperTilePass(&main.dspBlocks, &solution, main.cost);
 
-            for(auto& tile: dspBlocks) {
+            for(auto& tile: main.dspBlocks) {
                 unsigned int x = std::get<2>(tile).first;
                 unsigned int y = std::get<2>(tile).second;
 
                 solution.push_back(make_pair(std::get<1>(tile).tryDSPExpand(x, y, wX, wY, signedIO), std::get<2>(tile)));
 
-                currentTotalCost += std::get<0>(tile)->getLUTCost(x, y, wX, wY, signedIO);
+                main.cost += std::get<0>(tile)->getLUTCost(x, y, wX, wY, signedIO);
             }
         }
 
-        REPORT(LogLevel::VERBOSE, "Total cost: " << currentTotalCost << " " << usedDSPBlocks);
-        REPORT(LogLevel::VERBOSE, "Total area: " << currentArea);
+        REPORT(LogLevel::VERBOSE, "Total cost: " << main.cost << " " << main.usedDSPBlocks);
+        REPORT(LogLevel::VERBOSE, "Total area: " << main.area);
     }
 
     bool TilingStrategyBeamSearch::placeSingleTile(BaseFieldState& fieldState, unsigned int& usedDSPBlocks, list<mult_tile_t>* solution, const unsigned int neededX, const unsigned int neededY, BaseMultiplierCategory* tile, double& cost, unsigned int& area, double cmpCost, vector<tuple<BaseMultiplierCategory*, BaseMultiplierParametrization, multiplier_coordinates_t>>& dspBlocks) {
@@ -13,8 +13,8 @@ namespace flopoco {
 	TilingStrategyCSV::TilingStrategyCSV(
 			unsigned int wX,
 			unsigned int wY,
-			unsigned int wOut,
 			bool signedIO,
+			mpz_class errorBudget,
 			BaseMultiplierCollection* bmc,
 			base_multiplier_id_t prefered_multiplier,
 			float occupation_threshold,
@@ -23,9 +23,7 @@ namespace flopoco {
 			bool use2xk,
 			bool useSuperTiles,
 			bool useKaratsuba,
-			MultiplierTileCollection tiles_,
-            unsigned guardBits,
-            unsigned keepBits):TilingStrategy(wX, wY, wOut, signedIO, bmc),
+			MultiplierTileCollection tiles_):TilingStrategy(wX, wY, signedIO, errorBudget, bmc),
 								prefered_multiplier_{prefered_multiplier},
 								occupation_threshold_{occupation_threshold},
 								max_pref_mult_{maxPrefMult},
@@ -33,10 +31,11 @@ namespace flopoco {
 								use2xk_{use2xk},
 								useSuperTiles_{useSuperTiles},
 								useKaratsuba_{useKaratsuba},
-								tiles{tiles_.MultTileCollection},
-                                guardBits_{guardBits},
-                                keepBits_{keepBits}
+								tiles{tiles_.MultTileCollection}
 	{
+		// the tiling read from the file is expected to respect the truncation that corresponds to the error budget
+		unsigned int keepBits;
+		IntMultiplier::computeTruncMultParams(wX, wY, errorBudget, actualLSB, keepBits, errorCorrectionConstant);
 	}
 
 	void TilingStrategyCSV::solve() {
@@ -62,7 +61,7 @@ namespace flopoco {
 		            placement = placement.substr(placement.find(",")+1, placement.length());
 		            int y = stoi(placement.substr(0, placement.find(",")));
 		            placements.push_back(make_triplet(t,x,y));
-		            cout << "t=" << t << " x=" << x << " y=" << y << endl;
+		            REPORT(LogLevel::DEBUG, "t=" << t << " x=" << x << " y=" << y);
 		            
 		            cost += (double) tiles[t]->getLUTCost(x, y, wX, wY, signedIO);
 		            //own_lut_cost += tiles[t]->ownLUTCost(x, y, wX, wY, signedIO);
@@ -75,12 +74,12 @@ namespace flopoco {
 		    }
 		    multdef.close();
 		} else {
-		    cerr << "Error when opening tiling_solution.csv file for input." << endl;
+		    throw(string("TilingStrategyCSV: cannot open ./tiling_solution.csv"));
 		}
 
 		//exit(1);
 
-		cout << "Total cost: " << cost << " " << usedDSPBlocks << endl;
+		REPORT(LogLevel::VERBOSE, "Total cost: " << cost << " " << usedDSPBlocks);
 		//cout << "Total area: " << area << endl;
 
 	}
@@ -13,8 +13,8 @@ namespace flopoco {
 	TilingStrategyGreedy::TilingStrategyGreedy(
 			unsigned int wX,
 			unsigned int wY,
-			unsigned int wOut,
 			bool signedIO,
+			mpz_class errorBudget,
 			BaseMultiplierCollection* bmc,
 			base_multiplier_id_t prefered_multiplier,
 			float occupation_threshold,
@@ -23,9 +23,7 @@ namespace flopoco {
 			bool use2xk,
 			bool useSuperTiles,
 			bool useKaratsuba,
-			MultiplierTileCollection& tiles,
-            unsigned guardBits,
-            unsigned keepBits):TilingStrategy(wX, wY, wOut, signedIO, bmc),
+			MultiplierTileCollection& tiles):TilingStrategy(wX, wY, signedIO, errorBudget, bmc),
 								prefered_multiplier_{prefered_multiplier},
 								occupation_threshold_{occupation_threshold},
 								max_pref_mult_{maxPrefMult},
@@ -33,9 +31,7 @@ namespace flopoco {
 								use2xk_{use2xk},
 								useSuperTiles_{useSuperTiles},
 								useKaratsuba_{useKaratsuba},
-								tileCollection_{tiles},
-                                guardBits_{guardBits},
-                                keepBits_{keepBits}
+								tileCollection_{tiles}
 	{
 		//copy vector
 		tiles_ = tiles.BaseTileCollection;
@@ -58,30 +54,29 @@ namespace flopoco {
         max_pref_mult_ = (max_pref_mult_ < 0)?INT_MAX:max_pref_mult_;
 
 		prodsize_ = IntMultiplier::prodsize(wX, wY, signedIO, signedIO);
-		truncated_ = wOut != prodsize_;
-/*		if(truncated_) {
-			truncatedRange_ = (prodsize_ - 1) - wOut;
-		}*/
+		truncated_ = (errorBound > 0);
+	}
+
+	void TilingStrategyGreedy::truncateField(Field& field, BaseFieldState& fieldState) {
+		unsigned int keepBits;
+		IntMultiplier::computeTruncMultParams(wX, wY, errorBound, actualLSB, keepBits, errorCorrectionConstant);
+		if(truncated_) {
+			field.setTruncated(actualLSB, keepBits, fieldState);
+		}
 	}
 
 	void TilingStrategyGreedy::solve() {
 		NearestPointCursor fieldState;
 		Field field(wX, wY, signedIO, fieldState);
-
-		if(truncated_) {
-			//field.setTruncated(truncatedRange_, fieldState);
-			field.setTruncated(wOut, prodsize_, guardBits_, keepBits_,  fieldState);
-		}
-		field.printField();
+		truncateField(field, fieldState);
 
 		double cost = 0.0;
 		unsigned int area = 0;
 		unsigned int usedDSPBlocks = 0;
 		//only one state, base state is also current state
 		greedySolution(fieldState, &solution, nullptr, cost, area, usedDSPBlocks);
-		cout << "Total cost: " << cost << " " << usedDSPBlocks << endl;
-		cout << "Total area: " << area << endl;
-        field.printField();
+		REPORT(LogLevel::VERBOSE, "Total cost: " << cost << " " << usedDSPBlocks);
+		REPORT(LogLevel::VERBOSE, "Total area: " << area);
 	}
 
 	bool TilingStrategyGreedy::greedySolution(BaseFieldState& fieldState, list<mult_tile_t>* solution, queue<unsigned int>* path, double& cost, unsigned int& area, unsigned int& usedDSPBlocks, double cmpCost, vector<tuple<BaseMultiplierCategory*, BaseMultiplierParametrization, multiplier_coordinates_t>>* dspBlocks) {
@@ -2,6 +2,7 @@
 #include "flopoco/IntMult/IntMultiplier.hpp"
 #include "flopoco/IntMult/BaseMultiplierLUT.hpp"
 #include "flopoco/IntMult/MultiplierTileCollection.hpp"
+#include "flopoco/Tools/DiskCache.hpp"
 
 using namespace std;
 namespace flopoco {
@@ -9,35 +10,38 @@ namespace flopoco {
 TilingStrategyOptimalILP::TilingStrategyOptimalILP(
 		unsigned int wX_,
 		unsigned int wY_,
-		unsigned int wOut_,
 		bool signedIO_,
+		mpz_class errorBudget,
 		BaseMultiplierCollection* bmc,
 		base_multiplier_id_t prefered_multiplier,
 		float occupation_threshold,
 		int maxPrefMult,
         MultiplierTileCollection mtc_,
-        unsigned guardBits,
-        unsigned keepBits,
-        mpz_class errorBudget,
-        mpz_class &centerErrConstant,
         bool performOptimalTruncation,
-        bool squarer):TilingStrategy(
+        bool squarer,
+        TilingStrategy* warmStart):TilingStrategy(
 			wX_,
 			wY_,
-			wOut_,
 			signedIO_,
+			errorBudget,
 			bmc),
 		occupation_threshold_{occupation_threshold},
 		max_pref_mult_ {maxPrefMult},
 		tiles{mtc_.MultTileCollection},
-        guardBits{guardBits},
-        keepBits{keepBits},
         eBudget{errorBudget},
-        centerErrConstant{centerErrConstant},
+        centerErrConstant{errorCorrectionConstant},
         performOptimalTruncation{performOptimalTruncation},
-        squarer{squarer}
+        squarer{squarer},
+        warmStart{warmStart},
+        warmStartCost{-1}
 	{
-	    cout << errorBudget << endl;
+        IntMultiplier::computeTruncMultParams(wX, wY, errorBudget, actualLSB, keepBits, errorCorrectionConstant);
+        // The ILP model is expressed with an output width and guard bits: the error budget is half an ulp of the output
+        prodWidth = IntMultiplier::prodsize(wX, wY, signedIO, signedIO);
+        unsigned lsbOut = (errorBudget > 0) ? mpz_sizeinbase(errorBudget.get_mpz_t(), 2) : 0;
+        wOut = prodWidth - lsbOut;
+        guardBits = lsbOut - actualLSB;
+
         mpz_class max64;
         unsigned long long max64u = (1ULL << 52)-1ULL;//UINT64_MAX; //Limit to dynamic of double type
         mpz_import(max64.get_mpz_t(), 1, -1, sizeof max64u, 0, 0, &max64u);
@@ -45,57 +49,156 @@ TilingStrategyOptimalILP::TilingStrategyOptimalILP(
             mpz_export(&this->errorBudget, 0, -1, sizeof this->errorBudget, 0, 0, errorBudget.get_mpz_t());
         } else {
             if(performOptimalTruncation)
-                cout << "WARNING: errorBudget or constant exceeds the number range of uint64, switching to optiTrunc=0" << endl;
+                REPORT(LogLevel::MESSAGE, "WARNING: errorBudget or constant exceeds the number range of uint64, switching to optiTrunc=0");
             this->errorBudget = 0;
             this->performOptimalTruncation = false;
         }
-        cout << this->errorBudget << endl;
+        REPORT(LogLevel::DETAIL, "errorBudget=" << this->errorBudget << " wOut=" << wOut << " guardBits=" << guardBits << " keepBits=" << keepBits);
+	}
+
+TilingStrategyOptimalILP::~TilingStrategyOptimalILP()
+{
+    delete warmStart;
+}
 
-	    cout << "guardBits " << guardBits << " keepBits " << keepBits << endl;
-        for(auto &p:tiles)
-        {
-                cout << p->getLUTCost(0, 0, wX, wY, false) << " " << p->getType() << endl;
+bool TilingStrategyOptimalILP::solveWarmStart()
+{
+    warmStart->solve();
+    warmStartPlacements.clear();
+    warmStartCost = 0;
+    int dspCount = 0;
+    for (auto& tile : warmStart->getSolution()) {
+        // tiles are matched by type and shape, as the heuristic may have expanded a DSP tile or used its own copy of a super-tile
+        int x = tile.second.first, y = tile.second.second;
+        int s = 0;
+        for (; s < (int)tiles.size(); s++) {
+            BaseMultiplierCategory::Parametrization ilpTile = tiles[s]->getParametrisation().tryDSPExpand(x, y, wX, wY, signedIO);
+            if (tiles[s]->getType() == tile.first.getMultType() && ilpTile.getShapePara() == tile.first.getShapePara()
+                && ilpTile.getTileXWordSize() == tile.first.getTileXWordSize() && ilpTile.getTileYWordSize() == tile.first.getTileYWordSize())
+                break;
         }
-	}
+        if (s == (int)tiles.size()) {
+            REPORT(LogLevel::MESSAGE, "The " << tile.first.getTileXWordSize() << "x" << tile.first.getTileYWordSize() << " " << tile.first.getMultType()
+                << " tile of the heuristic tiling is not in the ILP model, solving without warm start");
+            warmStartCost = -1;
+            return false;
+        }
+        warmStartPlacements.push_back(make_tuple(s, x, y));
+        warmStartCost += tiles[s]->getLUTCost(x, y, wX, wY, signedIO);
+        dspCount += tiles[s]->getDSPCost();
+    }
+    if (0 <= max_pref_mult_ && max_pref_mult_ < dspCount) {
+        REPORT(LogLevel::MESSAGE, "The heuristic tiling uses " << dspCount << " DSPs, more than the " << max_pref_mult_ << " allowed in the ILP model, solving without warm start");
+        warmStartCost = -1;
+        return false;
+    }
+    // the rest of the objective: the bits of the error correction constant
+    if (performOptimalTruncation && wOut < (int)prodWidth) {
+        mpz_class constant = warmStart->getErrorCorrectionConstant();
+        warmStartCost += constantBitCost * mpz_popcount(constant.get_mpz_t());
+    }
+    REPORT(LogLevel::MESSAGE, "Heuristic tiling with ILP cost " << warmStartCost << " used as warm start");
+    return true;
+}
+
+string TilingStrategyOptimalILP::cacheKey()
+{
+    ostringstream key;
+    key << "TilingStrategyOptimalILP wX=" << wX << " wY=" << wY << " signedIO=" << signedIO << " wOut=" << wOut
+        << " guardBits=" << guardBits << " keepBits=" << keepBits << " errorBudget=" << eBudget
+        << " maxPrefMult=" << max_pref_mult_ << " occupation=" << occupation_threshold_
+        << " optiTrunc=" << performOptimalTruncation << " squarer=" << squarer << " target=" << target->getID();
+    for (auto const& t : tiles) {
+        key << " " << t->getType() << ":" << t->wX() << "x" << t->wY() << ":" << t->getDSPCost()
+            << ":" << t->getLUTCost(0, 0, wX, wY, signedIO) << ":" << t->getParametrisation().getTilingWeight();
+    }
+    return key.str();
+}
+
+bool TilingStrategyOptimalILP::loadCachedSolution(const string& key)
+{
+    string contents;
+    if(!DiskCache::loadEntry(key, ".tiling", contents))
+        return false;
+
+    istringstream in(contents);
+    string constant;
+    in >> constant;
+    list<mult_tile_t> cachedSolution;
+    int t, x, y;
+    while(in >> t >> x >> y) {
+        if(t < 0 || t >= (int)tiles.size())
+            return false;
+        cachedSolution.push_back(make_pair(tiles[t]->getParametrisation().tryDSPExpand(x, y, wX, wY, signedIO), make_pair(x, y)));
+    }
+    if(cachedSolution.empty() || centerErrConstant.set_str(constant, 10) != 0)
+        return false;
+    solution = cachedSolution;
+    REPORT(LogLevel::MESSAGE, "Reusing the cached ILP tiling (" << solution.size() << " tiles)");
+    return true;
+}
+
+void TilingStrategyOptimalILP::storeSolution(const string& key)
+{
+    ostringstream contents;
+    contents << centerErrConstant << endl;
+    for (auto const& p : placements)
+        contents << get<0>(p) << " " << get<1>(p) << " " << get<2>(p) << endl;
+    DiskCache::storeEntry(key, ".tiling", contents.str());
+}
 
 void TilingStrategyOptimalILP::solve()
 {
+    // the key is computed before constructProblem(), which consumes keepBits
+    string key = cacheKey();
+    if(DiskCache::isEnabled() && loadCachedSolution(key))
+        return;
 
 #ifndef HAVE_SCALP
     throw "Error, TilingStrategyOptimalILP::solve() was called but FloPoCo was not built with ScaLP library";
 #else
     solver = new ScaLP::Solver(ScaLP::newSolverDynamic({target->getILPSolver(),"Gurobi","CPLEX","SCIP","LPSolve"}));
-    cout << "using ILP solver " << solver->getBackendName() << " (whish was " << target->getILPSolver() << ")" << endl;
+    REPORT(LogLevel::DEBUG, "using ILP solver " << solver->getBackendName() << " (whish was " << target->getILPSolver() << ")");
 
     if(solver->getBackendName().find("LPSolve") != std::string::npos)
     {
-      cout << "LPSolve is used, disabling presolve as this caused problems in the past" << endl;
+      REPORT(LogLevel::DEBUG, "LPSolve is used, disabling presolve as this caused problems in the past");
       solver->presolve = false;
     }
     solver->timeout = target->getILPTimeout();
 
+    if(warmStart != nullptr)
+        solveWarmStart();
+
     long long optTruncNumericErr = 0;
+    double ilpCost = 0;
+    ScaLP::status stat;
     do {                                //Loop as a workaround for numeric solver problems during optimal truncation to ensure that the truncation error margin is met
         solver->reset();
         TilingStrategy::solution.clear();
+        placements.clear();
         constructProblem();
+        if(0 <= warmStartCost)
+            setStartValues();
 
         // Try to solve
-        cout << "starting solver, this might take a while..." << endl;
-        solver->quiet = false;
-        ScaLP::status stat = solver->solve();
+        REPORT(LogLevel::DEBUG, "starting solver, this might take a while...");
+        solver->quiet = !is_log_lvl_enabled(LogLevel::DEBUG);
+        stat = solver->solve();
 
         // print results
-        cerr << "The result is " << stat << endl;
+        REPORT(LogLevel::DEBUG, "The result is " << stat);
         //cerr << solver->getResult() << endl;
-        ofstream result_file;
-        result_file.open("result.txt");
-        result_file << solver->getResult();
-        result_file.close();
+        if(is_log_lvl_enabled(LogLevel::DEBUG)) {
+            ofstream result_file;
+            result_file.open("result.txt");
+            result_file << solver->getResult();
+            result_file.close();
+        }
         ScaLP::Result res = solver->getResult();
 
         //parse solution
-        cout << "centerErrConstant was: " << centerErrConstant << endl;
+        REPORT(LogLevel::DEBUG, "centerErrConstant was: " << centerErrConstant);
         unsigned long long new_constant = 0;
         double total_cost = 0, sum1 = 0, sum2 = 0, sum3 = 0, sum4 = 0;
         int dsp_cost = 0, own_lut_cost = 0;
@@ -109,9 +212,9 @@ void TilingStrategyOptimalILP::solve()
                     int y_negative = (var_name.substr(2 + dpS + x_negative + dpX, 1).compare("m") == 0) ? 1 : 0;
                     int m_y_pos = stoi(var_name.substr(2 + dpS + dpX + x_negative + y_negative, dpY)) *
                                   ((y_negative) ? (-1) : 1);
-                    cout << "is true:  " << setfill(' ') << setw(dpY) << mult_id << " " << setfill(' ') << setw(dpY)
+                    REPORT(LogLevel::DEBUG, "is true:  " << setfill(' ') << setw(dpY) << mult_id << " " << setfill(' ') << setw(dpY)
                          << m_x_pos << " " << setfill(' ') << setw(dpY) << m_y_pos << " cost: " << setfill(' ')
-                         << setw(5) << tiles[mult_id]->getLUTCost(m_x_pos, m_y_pos, wX, wY, signedIO) << std::endl;
+                         << setw(5) << tiles[mult_id]->getLUTCost(m_x_pos, m_y_pos, wX, wY, signedIO));
 
                     total_cost += (double) tiles[mult_id]->getLUTCost(m_x_pos, m_y_pos, wX, wY, signedIO);
                     own_lut_cost += tiles[mult_id]->ownLUTCost(m_x_pos, m_y_pos, wX, wY, signedIO);
@@ -120,11 +223,12 @@ void TilingStrategyOptimalILP::solve()
                     solution.push_back(make_pair(
                             tiles[mult_id]->getParametrisation().tryDSPExpand(m_x_pos, m_y_pos, wX, wY, signedIO),
                             coord));
+                    placements.push_back(make_tuple(mult_id, m_x_pos, m_y_pos));
                 }
                 if (var_name.substr(0, 1) == "c") {
                     int c_id = stoi(var_name.substr(1, dpC));
                     new_constant |= (1ULL << c_id);
-                    cout << var_name << " pos " << c_id << " dpC " << dpC << endl;
+                    REPORT(LogLevel::DEBUG, var_name << " pos " << c_id << " dpC " << dpC);
                 }
             }
             //check variables for numeric derivations due to rounding for optimal truncation.
@@ -143,27 +247,50 @@ void TilingStrategyOptimalILP::solve()
                 if (p.second >= 0.5) sum4 += (1 << shift);
             }
         }
-        cout << "Total LUT cost:" << total_cost << std::endl;
-        cout << "Own LUT cost:" << own_lut_cost << std::endl;
-        cout << "Total DSP cost:" << dsp_cost << std::endl;
-        cout << std::setprecision(20) << sum1 << " s2 " << std::setprecision(20) << sum2 << " c:"
-             << std::setprecision(20) << sum3 << " s2 " << std::setprecision(20) << sum4 << endl;
+        ilpCost = res.objectiveValue;
+        REPORT(LogLevel::DEBUG, "Total LUT cost:" << total_cost);
+        REPORT(LogLevel::DEBUG, "Own LUT cost:" << own_lut_cost);
+        REPORT(LogLevel::DEBUG, "Total DSP cost:" << dsp_cost);
+        REPORT(LogLevel::DEBUG, std::setprecision(20) << sum1 << " s2 " << std::setprecision(20) << sum2 << " c:"
+             << std::setprecision(20) << sum3 << " s2 " << std::setprecision(20) << sum4);
 
         if(performOptimalTruncation){
             //refresh centerErrConstant according to ILP solution
             //centerErrConstant = new_constant;
             mpz_import(centerErrConstant.get_mpz_t(), 1, -1, sizeof new_constant, 0, 0, &new_constant);
-            cout << "centerErrConstant now is: " << centerErrConstant << endl;
+            REPORT(LogLevel::DEBUG, "centerErrConstant now is: " << centerErrConstant);
 
             //check for numeric errors in solution
             optTruncNumericErr = (long long)ceil(fabs((sum1 + sum3) - (sum2 + sum4)));
             if(0 < optTruncNumericErr){
-                cout << "Warning: Numeric problems in solution, repeating ILP with Offset for Error of " << optTruncNumericErr << endl;
+                REPORT(LogLevel::DETAIL, "Numeric problems in solution, repeating ILP with Offset for Error of " << optTruncNumericErr);
                 errorBudget -= optTruncNumericErr;      //Reduce errorBudget by scope of numeric derivation for next iteration
             }
         }
 
     } while(performOptimalTruncation && eBudget+centerErrConstant < IntMultiplier::checkTruncationError(solution, guardBits, eBudget, centerErrConstant, wX, wY, signedIO) && 0 < optTruncNumericErr);
+
+    // anytime behaviour: the heuristic tiling is kept if the solver did not find a better one within the timeout.
+    // Both are compared on the ILP objective, and an optimal solution of the solver is never replaced
+    bool keptWarmStart = false;
+    if(0 <= warmStartCost) {
+        bool solved = (stat == ScaLP::status::OPTIMAL || stat == ScaLP::status::FEASIBLE || stat == ScaLP::status::TIMEOUT_FEASIBLE) && !placements.empty();
+        if(!solved || (stat != ScaLP::status::OPTIMAL && warmStartCost < ilpCost)) {
+            REPORT(LogLevel::MESSAGE, "The ILP solver (status " << stat << ") did not improve on the heuristic tiling, keeping it (ILP cost " << warmStartCost << ")");
+            solution = warmStart->getSolution();
+            centerErrConstant = warmStart->getErrorCorrectionConstant();
+            placements = warmStartPlacements;
+            keptWarmStart = true;
+        }
+        else {
+            REPORT(LogLevel::MESSAGE, "ILP tiling cost " << ilpCost << ", " << 100.0 * (warmStartCost - ilpCost) / max(warmStartCost, 1.0)
+                << "% below the heuristic tiling, " << ((stat == ScaLP::status::OPTIMAL) ? "proven optimal" : "not proven optimal within the timeout"));
+        }
+    }
+
+    // a solution found before a timeout may be improved by a later run with a larger timeout, so only optimal ones are cached
+    if(DiskCache::isEnabled() && stat == ScaLP::status::OPTIMAL && !keptWarmStart && !placements.empty())
+        storeSolution(key);
 /*
     solution.push_back(make_pair(tiles[1]->getParametrisation().tryDSPExpand(0, 0, wX, wY, signedIO), make_pair(0, 0)));
     solution.push_back(make_pair(tiles[0]->getParametrisation().tryDSPExpand(16, 0, wX, wY, signedIO), make_pair(16, 0)));
@@ -184,18 +311,19 @@ void TilingStrategyOptimalILP::solve()
 #ifdef HAVE_SCALP
 void TilingStrategyOptimalILP::constructProblem()
 {
-    cout << "constructing problem formulation..." << endl;
+    REPORT(LogLevel::DEBUG, "constructing problem formulation...");
     wS = tiles.size();
 
     for (auto const& i : tiles) {
-        std::cout << i->getType() << " weight=" << i->getParametrisation().getTilingWeight()  << endl;
+        REPORT(LogLevel::DEBUG, i->getType() << " weight=" << i->getParametrisation().getTilingWeight());
     }
 
     //Assemble cost function, declare problem variables
-    cout << "   assembling cost function, declaring problem variables..." << endl;
+    REPORT(LogLevel::DEBUG, "   assembling cost function, declaring problem variables...");
     ScaLP::Term obj;
     prodWidth = IntMultiplier::prodsize(wX, wY, signedIO, signedIO);
-    int x_neg = 0, y_neg = 0;
+    x_neg = 0;
+    y_neg = 0;
     for(int s = 0; s < wS; s++){
         x_neg = (x_neg < (int)tiles[s]->wX())?tiles[s]->wX() - 1:x_neg;
         y_neg = (y_neg < (int)tiles[s]->wY())?tiles[s]->wY() - 1:y_neg;
@@ -213,10 +341,10 @@ void TilingStrategyOptimalILP::constructProblem()
         dpC++;
 
     vector<ScaLP::Term> bitsinColumn(prodWidth + 1), constVecBits(prodWidth + 5);
-    vector<vector<vector<ScaLP::Variable>>> solve_Vars(wS, vector<vector<ScaLP::Variable>>(wX+x_neg, vector<ScaLP::Variable>(wY+y_neg)));
+    solve_Vars.assign(wS, vector<vector<ScaLP::Variable>>(wX+x_neg, vector<ScaLP::Variable>(wY+y_neg)));
     ScaLP::Term maxEpsTerm, minEpsTerm;
     // add the Constraints
-    cout << "   adding the constraints to problem formulation..." << endl;
+    REPORT(LogLevel::DEBUG, "   adding the constraints to problem formulation...");
     for(int y = 0; y < wY; y++){
         for(int x = 0; x < wX; x++){
             if(squarer && x < y) continue;
@@ -316,8 +444,7 @@ void TilingStrategyOptimalILP::constructProblem()
         }
 
         if (nDSPTiles) {
-            cout << "   adding the constraint to limit the use of DSP-Blocks to " << max_pref_mult_ << " instances..."
-                 << endl;
+            REPORT(LogLevel::DEBUG, "   adding the constraint to limit the use of DSP-Blocks to " << max_pref_mult_ << " instances...");
             stringstream consName;
             consName << "limDSP";
             ScaLP::Term pxyTerm;
@@ -338,9 +465,9 @@ void TilingStrategyOptimalILP::constructProblem()
     //make shure the available precision is present in case of truncation
     if(performOptimalTruncation == true && (wOut < (int)prodWidth))
     {
-        cout << "   multiplier is truncated by " << (int)prodWidth-wOut << " bits (err=" << (unsigned long)wX*(((unsigned long)1<<((int)wOut-guardBits))) << "), ensure sufficient precision..." << endl;
-        cout << "   guardBits=" << guardBits << endl;
-        cout << "   g=" << guardBits << " k=" << keepBits << " errorBudget=" << errorBudget << " difference to conservative est: " << errorBudget-(long long)(((unsigned long)1)<<((prodWidth-(int)wOut-1)-1)) << endl;
+        REPORT(LogLevel::DEBUG, "   multiplier is truncated by " << (int)prodWidth-wOut << " bits (err=" << (unsigned long)wX*(((unsigned long)1<<((int)wOut-guardBits))) << "), ensure sufficient precision...");
+        REPORT(LogLevel::DEBUG, "   guardBits=" << guardBits);
+        REPORT(LogLevel::DEBUG, "   g=" << guardBits << " k=" << keepBits << " errorBudget=" << errorBudget << " difference to conservative est: " << errorBudget-(long long)(((unsigned long)1)<<((prodWidth-(int)wOut-1)-1)));
 
         stringstream nvarName;
         nvarName << "C";
@@ -352,10 +479,10 @@ void TilingStrategyOptimalILP::constructProblem()
         for(unsigned i = 0; i < guardBits-1; i++){
             stringstream nvarName;
             nvarName << "c" << prodWidth-wOut-guardBits+i;
-            cout << nvarName.str() << endl;
+            REPORT(LogLevel::DEBUG, nvarName.str());
             cVars[i] = ScaLP::newBinaryVariable(nvarName.str());
             cTerm.add(cVars[i],  ( 1ULL << (prodWidth-wOut-guardBits+i)));
-            obj.add(cVars[i], (double)0.65);    //append variable to cost function
+            obj.add(cVars[i], constantBitCost);    //append variable to cost function
         }
         ScaLP::Constraint cConstraint = cTerm - Cvar == 0;
         stringstream cName;
@@ -371,7 +498,7 @@ void TilingStrategyOptimalILP::constructProblem()
         solver->addConstraint(cLimConstraint);
 
         //Limit the error budget
-        cout << "  maxErr=" << errorBudget << endl;
+        REPORT(LogLevel::DEBUG, "  maxErr=" << errorBudget);
         ScaLP::Constraint maxErrConstraint = maxEpsTerm - Cvar < errorBudget;
         stringstream maxErrName;
         maxErrName << "maxEps";
@@ -379,7 +506,7 @@ void TilingStrategyOptimalILP::constructProblem()
         solver->addConstraint(maxErrConstraint);
 
         //Limit the error budget
-        cout << "  minErr=" << errorBudget << endl;
+        REPORT(LogLevel::DEBUG, "  minErr=" << errorBudget);
         ScaLP::Constraint minErrConstraint = -minEpsTerm + Cvar < errorBudget;
         stringstream minErrName;
         minErrName << "minEps";
@@ -396,7 +523,7 @@ void TilingStrategyOptimalILP::constructProblem()
             cvarName << "v" << setfill('0') << setw(dpC) << i;
             //cout << cvarName.str() << " weight " << (double)(1ULL << i) << endl;
             cvBits[i] = ScaLP::newBinaryVariable(cvarName.str());
-            obj.add(cvBits[i], 0.65);    //append variable to cost function
+            obj.add(cvBits[i], constantBitCost);    //append variable to cost function
 
             stringstream ovarName;
             ovarName << "o" << setfill('0') << setw(dpC) << i;
@@ -415,14 +542,30 @@ void TilingStrategyOptimalILP::constructProblem()
     }
 
     // Set the Objective
-    cout << "   setting objective (minimize cost function)..." << endl;
+    REPORT(LogLevel::DEBUG, "   setting objective (minimize cost function)...");
     solver->setObjective(ScaLP::minimize(obj));
 
     // Write Linear Program to file for debug purposes
-    cout << "   writing LP-file for debuging..." << endl;
-    solver->writeLP("tile.lp");
+    if(is_log_lvl_enabled(LogLevel::DEBUG)) {
+        REPORT(LogLevel::DEBUG, "   writing LP-file for debuging...");
+        solver->writeLP("tile.lp");
+    }
 }
 
+void TilingStrategyOptimalILP::setStartValues()
+{
+    ScaLP::Result start;
+    for (auto const& p : warmStartPlacements) {
+        int s = get<0>(p), x = get<1>(p) + x_neg, y = get<2>(p) + y_neg;
+        if (x < 0 || y < 0 || x >= (int)solve_Vars[s].size() || y >= (int)solve_Vars[s][x].size() || solve_Vars[s][x][y] == nullptr) {
+            REPORT(LogLevel::MESSAGE, "A tile of the heuristic tiling has no variable in the ILP model, solving without warm start");
+            return;
+        }
+        start.values.emplace(solve_Vars[s][x][y], 1.0);
+    }
+    // the other variables are left to the solver, which completes a partial MIP start
+    solver->setStartValues(start);
+}
 
 #endif
 
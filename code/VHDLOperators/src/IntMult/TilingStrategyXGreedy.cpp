@@ -7,8 +7,8 @@ namespace flopoco {
     TilingStrategyXGreedy::TilingStrategyXGreedy(
             unsigned int wX,
             unsigned int wY,
-            unsigned int wOut,
             bool signedIO,
+            mpz_class errorBudget,
             BaseMultiplierCollection* bmc,
             base_multiplier_id_t prefered_multiplier,
             float occupation_threshold,
@@ -17,9 +17,7 @@ namespace flopoco {
             bool use2xk,
             bool useSuperTiles,
             bool useKaratsuba,
-            MultiplierTileCollection& tiles,
-            unsigned guardBits,
-            unsigned keepBits):TilingStrategyGreedy(wX, wY, wOut, signedIO, bmc, prefered_multiplier, occupation_threshold, maxPrefMult, useIrregular, use2xk, useSuperTiles, useKaratsuba, tiles, guardBits, keepBits)
+            MultiplierTileCollection& tiles):TilingStrategyGreedy(wX, wY, signedIO, errorBudget, bmc, prefered_multiplier, occupation_threshold, maxPrefMult, useIrregular, use2xk, useSuperTiles, useKaratsuba, tiles)
     {
         //find all paired tiles
         for(unsigned int i = 0; i < tiles_.size(); i++) {
@@ -60,11 +58,7 @@ namespace flopoco {
         NearestPointCursor baseState;
         NearestPointCursor tempState;
         Field field(wX, wY, signedIO, baseState);
-
-        if(truncated_) {
-            //field.setTruncated(truncatedRange_, baseState);
-            field.setTruncated(wOut, prodsize_, guardBits_, keepBits_,  baseState);
-        }
+        truncateField(field, baseState);
 
         tempState.reset(baseState);
 
@@ -97,8 +91,8 @@ namespace flopoco {
             }
         }
 
-        cout << "Total cost: " << bestCost << " " << bestUsedDSPBlocks << endl;
-        cout << "Total area: " << bestArea << endl;
+        REPORT(LogLevel::VERBOSE, "Total cost: " << bestCost << " " << bestUsedDSPBlocks);
+        REPORT(LogLevel::VERBOSE, "Total area: " << bestArea);
         solution = std::move(bestSolution);
     }
 
@@ -32,6 +32,7 @@
 
 */
 
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
 #include <fstream>
@@ -39,6 +40,7 @@
 #include <set>
 #include <sstream>
 #include <string>
+#include <string_view>
 #if 0 // these seem to be unused
 #include <boost/random/mersenne_twister.hpp>
 #include <boost/random/variate_generator.hpp>
@@ -48,6 +50,8 @@
 
 #include "flopoco/InterfacedOperator.hpp"
 #include "flopoco/Operator.hpp"  // Useful only for reporting. TODO split out the REPORT and THROWERROR #defines from Operator to another include.
+#include "flopoco/Tools/PhaseTrace.hpp"
+#include "flopoco/Tools/WorkerProcesses.hpp"
 #include "flopoco/UserInterface.hpp"
 #include "flopoco/utils.hpp"
 namespace flopoco{
@@ -56,6 +60,8 @@ namespace flopoco{
 	// global variables used through most of FloPoCo,
 	// to be encapsulated in something, someday?
 	int Operator::uid = 0; 										//init of the uid static member of Operator
+	map<string, Operator*> Operator::sharedOperatorCache_;
+	std::recursive_mutex Operator::sharedOperatorMutex_;
 	int verbose=0;
 
 	Operator::Operator(Operator* parentOp, Target* target){
@@ -1260,7 +1266,6 @@ namespace flopoco{
 		s->setCriticalPath(0.0);
 		s->setCriticalPathContribution(0.0);
 		s->setHasBeenScheduled(true);
-		alreadyScheduled.insert(s);
 
 		// add the newly created signal to signalMap and signalList
 		signalList_.push_back(s);
@@ -1563,8 +1568,46 @@ namespace flopoco{
 		}
 		//create the operator
 
-		instance = instanceOpFactory->parseArguments(this, target_, parametersVector, UserInterface::getUserInterface());
-	
+		// A shared operator doesn't depend on the context of its instance, so an identical request may reuse it.
+		// The description uses the canonical form of the parameters: lower-case keys, default values filled in, in factory order.
+		ostringstream description;
+		description << opName << " target=" << target_->getOptionsDescription();
+		vector<string> otherParameters;
+		map<string, string> givenParameters;
+		for (size_t i = 1; i < parametersVector.size(); i++) {
+			size_t eqPos = parametersVector[i].find('=');
+			string key = parametersVector[i].substr(0, eqPos);
+			std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+			if(eqPos == string::npos)
+				otherParameters.push_back(parametersVector[i]);
+			else
+				givenParameters[key] = parametersVector[i].substr(eqPos+1);
+		}
+		for (auto const & paramName: instanceOpFactory->param_names()) {
+			string key = paramName;
+			std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+			auto given = givenParameters.find(key);
+			if(given != givenParameters.end()) {
+				description << " " << key << "=" << given->second;
+				givenParameters.erase(given);
+			}
+			else
+				description << " " << key << "=" << instanceOpFactory->getDefaultParamVal(paramName);
+		}
+		for (auto const & p: givenParameters) // generic options
+			description << " " << p.first << "=" << p.second;
+		for (auto const & p: otherParameters)
+			description << " " << p;
+
+		bool built;
+		instance = findOrBuildSharedOperator(description.str(), [&]() {
+				TRACE_PHASE("construct", opName);
+				return instanceOpFactory->parseArguments(this, target_, parametersVector, UserInterface::getUserInterface());
+			}, &built);
+		if(!built) {
+			REPORT(LogLevel::VERBOSE, "   newInstance("<< opName << ", " << instanceName <<"): reusing shared operator " << instance->getName());
+		}
+
 
 		REPORT(LogLevel::DEBUG, "   newInstance("<< opName << ", " << instanceName <<"): after factory call" );
 
@@ -1577,6 +1620,49 @@ namespace flopoco{
 	}
 
 
+	Operator* Operator::findSharedOperator(string description)
+	{
+		std::lock_guard<std::recursive_mutex> lock(sharedOperatorMutex_);
+		auto it = sharedOperatorCache_.find(description);
+		if(it == sharedOperatorCache_.end())
+			return nullptr;
+		return it->second;
+	}
+
+
+	void Operator::recordSharedOperator(string description, Operator* op)
+	{
+		if(!op->isShared()) {
+			throw string("Operator::recordSharedOperator: ") + op->getName() + " is not a shared operator";
+		}
+		std::lock_guard<std::recursive_mutex> lock(sharedOperatorMutex_);
+		sharedOperatorCache_[description] = op;
+	}
+
+
+	Operator* Operator::findOrBuildSharedOperator(string description, std::function<Operator*()> build, bool* built)
+	{
+		// recursive, as building an operator may build its own shared sub-components
+		std::lock_guard<std::recursive_mutex> lock(sharedOperatorMutex_);
+		Operator* op = findSharedOperator(description);
+		if(built != nullptr)
+			*built = (op == nullptr);
+		if(op == nullptr) {
+			op = build();
+			if(op->isShared())
+				recordSharedOperator(description, op);
+		}
+		return op;
+	}
+
+
+	void Operator::clearSharedOperatorCache()
+	{
+		std::lock_guard<std::recursive_mutex> lock(sharedOperatorMutex_);
+		sharedOperatorCache_.clear();
+	}
+
+
 	void Operator::parsePortMappings(string portMappings0, int portTypes)
 	{
 		string portMappings="";
@@ -2048,7 +2134,7 @@ namespace flopoco{
 		}
 
 		// The following loop thus enumerates all the possible input bit combinations
-		for(uint64_t testIndex=0; testIndex<numberOfTests; testIndex++) {
+		auto newTestCase = [&](uint64_t testIndex) {
 			TestCase* tc = new TestCase(this);
 			// and inside we just break out the loop index into bit vectors corresponding to the inputs
       mpz_class t = mpz_class((unsigned long int) testIndex);
@@ -2057,10 +2143,38 @@ namespace flopoco{
 				tc->addInput(inputName[i], t & mask);
 				t = t>>inputWidth[i];
 			}
-			emulate(tc);
-			tcl->add(tc);
-			
+			return tc;
+		};
+
+		int workers = getTarget()->getThreads();
+		if(workers <= 1) {
+			for(uint64_t testIndex=0; testIndex<numberOfTests; testIndex++) {
+				TestCase* tc = newTestCase(testIndex);
+				emulate(tc);
+				tcl->add(tc);
+			}
+		}
+		else {
+			// emulate() is typically the expensive part (e.g. Sollya evaluations): do it in worker processes
+			runInWorkerProcesses(numberOfTests, workers,
+				[&](uint64_t begin, uint64_t end, FILE* out) {
+					for(uint64_t testIndex=begin; testIndex<end; testIndex++) {
+						TestCase* tc = newTestCase(testIndex);
+						emulate(tc);
+						tc->writeRaw(out);
+						delete tc;
+					}
+				},
+				[&](uint64_t begin, uint64_t end, FILE* in) {
+					for(uint64_t testIndex=begin; testIndex<end; testIndex++) {
+						TestCase* tc = new TestCase(this);
+						tc->readRaw(in);
+						tcl->add(tc);
+					}
+				});
 		}
+		delete[] inputName;
+		delete[] inputWidth;
 		return numberOfTests;
 	}
 	
@@ -2209,14 +2323,32 @@ namespace flopoco{
 			beginArchitecture(o);
 			o << buildVHDLRegisters();					//TODO: this cannot be called before scheduling the signals (it requires the lifespan of the signals, which is not yet computed)
 			if(getIndirectOperator())
-				o << getIndirectOperator()->vhdl.str();
+				getIndirectOperator()->outputArchitectureBody(o);
 			else
-				o << vhdl.str();
+				outputArchitectureBody(o);
 			endArchitecture(o);
 		}
 	}
 
 
+	void Operator::outputArchitectureBody(std::ostream& o) {
+		string code = vhdl.str();
+		size_t currentPos = 0;
+		for(size_t i=0; i<opaqueVHDLBlocks_.size(); i++) {
+			string placeholder = "-- opaque VHDL block " + to_string(i) + "\n";
+			size_t nextPos = code.find(placeholder, currentPos);
+			if(nextPos == string::npos) {
+				REPORT(LogLevel::DEBUG, "outputArchitectureBody: placeholder of opaque block " << i << " not found, block ignored");
+				continue;
+			}
+			o.write(code.data()+currentPos, nextPos-currentPos);
+			o << opaqueVHDLBlocks_[i];
+			currentPos = nextPos + placeholder.size();
+		}
+		o.write(code.data()+currentPos, code.size()-currentPos);
+	}
+
+
 
 
 	// Comment by F2D: this whas parse2().
@@ -2225,7 +2357,8 @@ namespace flopoco{
 	void Operator::doApplySchedule()
 	{
 		ostringstream newStr;
-		string oldStr, workStr;
+		string code;
+		string_view oldStr, workStr;
 		size_t currentPos, nextPos, tmpCurrentPos, tmpNextPos;
 		int count, lhsNameLength, rhsNameLength;
 		bool unknownLHSName = false, unknownRHSName = false;
@@ -2236,18 +2369,34 @@ namespace flopoco{
 		newStr.str("");
 
 		//set the old code to the vhdl code stored in the FlopocoStream
-		oldStr = vhdl.str();
+		// All the statements, names etc. below are views of this single copy
+		code = vhdl.str();
+		oldStr = code;
+
+		// The positions of the next '?' and '$' are cached, so that the search for the next statement is linear overall
+		size_t nextQuestionMark = oldStr.find('?');
+		size_t nextDollar = oldStr.find('$');
+		auto findNext = [&](size_t& cache, char c, size_t from) {
+			if(cache != string::npos && cache < from)
+				cache = oldStr.find(c, from);
+			return cache;
+		};
+		// Same as getSignalByName(), returning nullptr instead of throwing for the names that are not signals
+		auto lookupSignal = [this](string_view name) -> Signal* {
+			auto it = signalMap_.find(string(name.substr(0, name.find('('))));
+			return (it == signalMap_.end() ? nullptr : it->second);
+		};
 
 		//iterate through the old code, one statement at the time
 		// code that doesn't need to be modified: goes directly to the new vhdl code buffer
 		// code that needs to be modified: ?? should be removed from lhs_name, $$ should be removed from rhs_name,
 		//		delays of the type rhs_name_dxxx should be added for the right-hand side signals
-		bool isSelectedAssignment = (oldStr.find('?') > oldStr.find('$'));
+		bool isSelectedAssignment = (nextQuestionMark > nextDollar);
 		currentPos = 0;
-		nextPos = (isSelectedAssignment ? oldStr.find('$') : oldStr.find('?'));
+		nextPos = (isSelectedAssignment ? nextDollar : nextQuestionMark);
 		while(nextPos !=  string::npos)
 			{
-				string lhsName, rhsName;
+				string_view lhsName, rhsName;
 				size_t auxPosition, auxPosition2;
 				Signal *lhsSignal, *rhsSignal;
 
@@ -2298,10 +2447,10 @@ namespace flopoco{
 					while(oldStr[i]!=' ')
 						i--;
 					size_t beginInstanceName = i+1;
-					string instanceName = oldStr.substr(beginInstanceName, endInstanceName-beginInstanceName);
+					string instanceName(oldStr.substr(beginInstanceName, endInstanceName-beginInstanceName));
 					REPORT(LogLevel::FULL,"doApplySchedule found instance name >>>>"<<instanceName<<"<<<<");
 
-					string subOpName=lhsName;
+					string subOpName(lhsName);
 					OperatorPtr subop = getSubComponent(subOpName);
 					if(subop==nullptr)
 						THROWERROR("doApplySchedule(): " << subOpName << " does not seem to be a subcomponent of " << getName());
@@ -2408,10 +2557,10 @@ namespace flopoco{
 								if(isSequential()
 									 && rhsIsSignal // rhs is not a constant
 									 && subop->isShared() // otherwise the dependency graph takes care of all the pipelining
-									 && subop->getSignalByName(lhsName)->type() == Signal::in
+									 && subop->getSignalByName(string(lhsName))->type() == Signal::in
 									 ) {// the lhs is a input of the subcomponent
 									// In this case, we have in the dep graph the dependencies (actualIn->actualOut): extract the first one
-									Signal* subopInput = getSignalByName(rhsName);
+									Signal* subopInput = getSignalByName(string(rhsName));
 									//look for the first output
 									int i=0;
 									while(subop->getIOList()[i]->type() != Signal::out)
@@ -2439,13 +2588,13 @@ namespace flopoco{
 									}
 								}
 								else if (isSequential() && nameSignalByCycle() && rhsIsSignal) {
-									if (subop->getSignalByName(lhsName)->type() == Signal::in) {
-										Signal* subopInput = getSignalByName(rhsName);
+									if (subop->getSignalByName(string(lhsName))->type() == Signal::in) {
+										Signal* subopInput = getSignalByName(string(rhsName));
 										if (subopInput->type() != Signal::in) {
 											newStr << "_c" << vhdlize(subopInput->getCycle());
 										}
-									} else if (subop->getSignalByName(lhsName)->type() == Signal::out) {
-										Signal* subopOutput = getSignalByName(rhsName);
+									} else if (subop->getSignalByName(string(lhsName))->type() == Signal::out) {
+										Signal* subopOutput = getSignalByName(string(rhsName));
 										if (subopOutput->type() != Signal::out) {
 											newStr << "_c" << vhdlize(subopOutput->getCycle());
 										}
@@ -2473,12 +2622,12 @@ namespace flopoco{
 
 					//prepare for a new instruction to be parsed
 					currentPos = nextPos + workStr.size() + 2;
-					nextPos = oldStr.find('?', currentPos);
+					nextPos = findNext(nextQuestionMark, '?', currentPos);
 					//special case for the selected assignment statements
 					isSelectedAssignment = false;
-					if(oldStr.find('$', currentPos) < nextPos)
+					if(findNext(nextDollar, '$', currentPos) < nextPos)
 						{
-							nextPos = oldStr.find('$', currentPos);
+							nextPos = nextDollar;
 							isSelectedAssignment = true;
 						}
 
@@ -2497,13 +2646,8 @@ namespace flopoco{
 					}
 
 				//this could be a user-defined name
-				try			{
-				lhsSignal = getSignalByName(lhsName);
-				}
-				catch(string &e)	{
-				lhsSignal = NULL;
-				unknownLHSName = true;
-				}
+				lhsSignal = lookupSignal(lhsName);
+				unknownLHSName = (lhsSignal == nullptr);
 				//check for "select" signal assignments
 				//	with signal_name select... etc
 				//	the problem is there is a signal belonging to the right hand side
@@ -2518,19 +2662,14 @@ namespace flopoco{
 					rhsName = workStr.substr(tmpCurrentPos, tmpNextPos);
 
 					//remove the possible parentheses around the rhsName
-					string newRhsName = rhsName;
+					string_view newRhsName = rhsName;
 					if(rhsName.find("(") != string::npos)	{
 						newRhsName = newRhsName.substr(rhsName.find("(")+1, rhsName.find(")")-rhsName.find("(")-1);
 					}
 					// No functional register possible here
-					try			{
-						rhsSignal = getSignalByName(newRhsName);
-					}
-					catch(...){
-						//this i must be user-defined name
-						rhsSignal = NULL;
-						unknownRHSName = true;
-					}
+					//this may be a user-defined name
+					rhsSignal = lookupSignal(newRhsName);
+					unknownRHSName = (rhsSignal == nullptr);
 
 					//output the rhs signal name
 					newStr << rhsName;
@@ -2571,12 +2710,12 @@ namespace flopoco{
 
 							//prepare for a new instruction to be parsed
 							currentPos = nextPos + workStr.size() + 2;
-							nextPos = oldStr.find('?', currentPos);
+							nextPos = findNext(nextQuestionMark, '?', currentPos);
 							//special case for the selected assignment statements
 							isSelectedAssignment = false;
-							if(oldStr.find('$', currentPos) < nextPos)
+							if(findNext(nextDollar, '$', currentPos) < nextPos)
 								{
-									nextPos = oldStr.find('$', currentPos);
+									nextPos = nextDollar;
 									isSelectedAssignment = true;
 								}
 
@@ -2612,27 +2751,22 @@ namespace flopoco{
 					rhsName = workStr.substr(tmpNextPos, workStr.find('$', tmpNextPos)-tmpNextPos);
 					rhsNameLength = rhsName.size();
 					//remove the possible parentheses around the rhsName
-					string newRhsName = rhsName;
+					string_view newRhsName = rhsName;
 					if(rhsName.find("(") != string::npos)	{
 						newRhsName = newRhsName.substr(rhsName.find("(")+1, rhsName.find(")")-rhsName.find("(")-1);
 					}
 					//this could also be a delayed signal name
 					int functionalDelay=0;
 					if(newRhsName.find('^') != string::npos){
-						string sdelay = newRhsName.substr(newRhsName.find('^') + 1, string::npos-1);
+						string sdelay(newRhsName.substr(newRhsName.find('^') + 1, string::npos-1));
 						newRhsName = newRhsName.substr(0, newRhsName.find('^'));
 						REPORT(LogLevel::FULL, "doApplySchedule: Found funct. delayed signal  : " << newRhsName << " delay:" << sdelay );
 						functionalDelay = stoi(sdelay);
 					}
 
-					try			{
-						rhsSignal = getSignalByName(newRhsName);
-					}
-					catch(...){
-						//this i must be user-defined name
-						rhsSignal = NULL;
-						unknownRHSName = true;
-					}
+					//this may be a user-defined name
+					rhsSignal = lookupSignal(newRhsName);
+					unknownRHSName = (rhsSignal == nullptr);
 
 
 					//copy the rhsName with the delay information into the new vhdl buffer
@@ -2651,9 +2785,9 @@ namespace flopoco{
 
 						// Should we insert a functional register ? This case is exclusive with the previous as long as functional delays are introduced only by the functionalRegister method.
 						if(functionalDelay>0) {
-							getSignalByName(newRhsName) -> updateLifeSpan(functionalDelay); // wonder where it is done for pipeline registers???
+							rhsSignal -> updateLifeSpan(functionalDelay); // wonder where it is done for pipeline registers???
 							if (nameSignalByCycle()) {
-								newStr << "_c" << vhdlize(getSignalByName(newRhsName)->getCycle() + functionalDelay);
+								newStr << "_c" << vhdlize(rhsSignal->getCycle() + functionalDelay);
 							} else {
 								newStr << "_d" << vhdlize(functionalDelay);
 							}
@@ -2671,12 +2805,12 @@ namespace flopoco{
 
 				//get a new line to parse
 				currentPos = nextPos + workStr.size() + 2;
-				nextPos = oldStr.find('?', currentPos);
+				nextPos = findNext(nextQuestionMark, '?', currentPos);
 				//special case for the selected assignment statements
 				isSelectedAssignment = false;
-				if(oldStr.find('$', currentPos) < nextPos)
+				if(findNext(nextDollar, '$', currentPos) < nextPos)
 					{
-						nextPos = oldStr.find('$', currentPos);
+						nextPos = nextDollar;
 						isSelectedAssignment = true;
 					}
 			}
@@ -2860,28 +2994,37 @@ namespace flopoco{
 
 	}
 
-	void  Operator::buildAlreadyScheduledList(set<Signal*> & alreadyScheduled) {
+	void  Operator::markSourceSignalsScheduled() {
 		for(auto i: signalList_)	{
-			if (i->predecessors()->size()==0) {
+			if (i->predecessors()->size()==0) { // this captures the constant signals but also the functional register outputs
 				i->setHasBeenScheduled(true);
 			}
-			if (i->hasBeenScheduled()) {  // this captures the previous constant signals but also the functional register outputs
-				alreadyScheduled.insert(i);
-			}
-
 		}
 		// and do the same recursively for all subcomponents
 		for(auto op: subComponentList_)	{
-			op->buildAlreadyScheduledList(alreadyScheduled);
+			op->markSourceSignalsScheduled();
+		}
+	}
+
+	void  Operator::collectSchedulingCandidates(vector<Signal*> & candidates) {
+		candidates.insert(candidates.end(), schedulingCandidates_.begin(), schedulingCandidates_.end());
+		schedulingCandidates_.clear();
+		for(auto op: subComponentList_)	{
+			op->collectSchedulingCandidates(candidates);
 		}
 	}
 
+	void Operator::addSchedulingCandidate(Signal* s) {
+		schedulingCandidates_.push_back(s);
+	}
+
 
 	void Operator::schedule()
 	{
 		REPORT(LogLevel::DEBUG, "Entering schedule() of operator " << getName() << " with isOperatorScheduled_="<< isOperatorScheduled_);
 		if(noParseNoSchedule_ || isOperatorScheduled_) // for TestBench and Wrapper
 			return;
+		TRACE_PHASE("schedule", getName());
 
 		// move the dependences extracted by the lexer to the operator's internal signals
 		moveDependenciesToSignalGraph();
@@ -2898,78 +3041,97 @@ namespace flopoco{
 
 
 			// Algorithm initialization
-			// We need a global list of all the signals of the graph
-			size_t numberScheduled;
-			set<Signal*> successorsFront;
 			// restate that inputs  are already scheduled for good measure (recall that we are in the top level)
 			for(auto i: ioList_)	{
 				if (i->type()==Signal::in) {
-					alreadyScheduled.insert(i); // TODO refactor into one call setScheduled(Signal*) ?
 					i->setHasBeenScheduled(true);
 				}
 			}
-			// recursively run through subcomponents looking for already scheduled signals such as constants signals, functional register outputs, etc
-			buildAlreadyScheduledList(alreadyScheduled);
-
-			// then build the current wavefront (new successors may have been added to already scheduled signals)
-			for(auto i: alreadyScheduled)	{
-				for(auto successor : *i->successors()) {
-					if(successor.first->hasBeenScheduled()==false)
-						successorsFront.insert(successor.first);
-				}
-			}
-
-			numberScheduled=0;
-			// The main loop only tries to schedule signals in the wavefront
-			while(alreadyScheduled.size() > numberScheduled) {
-				// Things are still moving
-				numberScheduled = alreadyScheduled.size();
-				set<Signal*> nextIterationFront;
-
-				// REPORTING
-				{
-					ostringstream s1,s2;
-					for(auto i: successorsFront)
-						s1 << i->getUniqueName() << " ";
-					REPORT(LogLevel::DEBUG, "schedule(): current wavefront is " << s1.str());
-					for(auto i: alreadyScheduled)
-						s2 << i->getUniqueName() << " ";
-					REPORT(LogLevel::DEBUG, "schedule(): currently scheduled: " << s2.str());
+			// recursively run through subcomponents looking for signals that are scheduled by construction, such as constants signals, functional register outputs, etc
+			markSourceSignalsScheduled();
+
+			// This is a worklist algorithm, incremental from one call to the next:
+			// the candidates are the signals that gained predecessors since the previous call, and those that were waiting for some.
+			// Each candidate holds the number of its unscheduled predecessors, and enters the worklist when it reaches zero,
+			// so each dependency is processed once.
+			vector<Signal*> candidates;
+			collectSchedulingCandidates(candidates);
+			map<Signal*, int> pendingPredecessors;
+			vector<Signal*> worklist;
+			auto countUnscheduledPredecessors = [](Signal* s) {
+				int n = 0;
+				for(auto i : *s->predecessors()) {
+					if(i.first->hasBeenScheduled() == false)
+						n++;
 				}
-
-				for(auto candidate: successorsFront) {
-					// Can we schedule this candidate?
-					//check if all the signal's predecessors have been scheduled
-					bool allPredecessorsScheduled = true;
-					for(auto i : *candidate->predecessors()) {
-						Signal* pred=i.first;
-						if(pred->hasBeenScheduled() == false) {
-							REPORT(LogLevel::DEBUG, "schedule():   " << candidate->getUniqueName() << " cannot be scheduled because of predecessor " << pred->getUniqueName());
-							allPredecessorsScheduled = false;
+				return n;
+			};
+			auto addCandidate = [&](Signal* s) {
+				if(s->hasBeenScheduled() || pendingPredecessors.count(s) != 0)
+					return;
+				int n = countUnscheduledPredecessors(s);
+				pendingPredecessors[s] = n;
+				if(n == 0)
+					worklist.push_back(s);
+			};
+			for(auto s: candidates)
+				addCandidate(s);
+
+			bool progress = true;
+			while(progress) {
+				while(!worklist.empty()) {
+					Signal* candidate = worklist.back();
+					worklist.pop_back();
+					if(candidate->hasBeenScheduled())
+						continue;
+					// The counts assume that predecessor and successor lists match: check before scheduling
+					int n = countUnscheduledPredecessors(candidate);
+					if(n != 0) {
+						if(is_log_lvl_enabled(LogLevel::DEBUG)) {
+							for(auto i : *candidate->predecessors()) {
+								if(i.first->hasBeenScheduled() == false)
+									REPORT(LogLevel::DEBUG, "schedule():   " << candidate->getUniqueName() << " cannot be scheduled because of predecessor " << i.first->getUniqueName());
+							}
 						}
+						pendingPredecessors[candidate] = n;
+						continue;
 					}
-					if(allPredecessorsScheduled) {
-						setSignalTiming(candidate); // also marks it as scheduled
-						alreadyScheduled.insert(candidate);
-						REPORT(LogLevel::DEBUG, "schedule(): :) " << candidate->getUniqueName()
-									 << " has been scheduled at lexicographic time (" << candidate->getCycle() << ", " << candidate->getCriticalPath() <<")"  );
-
-						nextIterationFront.erase(candidate);// it may have been already added to nextIterationFront in this iteration
-
-						for(auto i : *candidate->successors()) {
-							if(i.first->hasBeenScheduled() == false) {
-								REPORT(LogLevel::DEBUG, "schedule():     " << i.first->getUniqueName() << " added to the wavefront");
-								nextIterationFront.insert(i.first);
-							}
+					setSignalTiming(candidate); // also marks it as scheduled
+					pendingPredecessors.erase(candidate);
+					REPORT(LogLevel::DEBUG, "schedule(): :) " << candidate->getUniqueName()
+								 << " has been scheduled at lexicographic time (" << candidate->getCycle() << ", " << candidate->getCriticalPath() <<")"  );
+
+					for(auto i : *candidate->successors()) {
+						Signal* successor = i.first;
+						if(successor->hasBeenScheduled())
+							continue;
+						auto pending = pendingPredecessors.find(successor);
+						if(pending == pendingPredecessors.end()) {
+							REPORT(LogLevel::DEBUG, "schedule():     " << successor->getUniqueName() << " added to the wavefront");
+							addCandidate(successor);
+						}
+						else if(--pending->second <= 0) {
+							worklist.push_back(successor);
 						}
 					}
-					else { // not all the predecessors scheduled, keep this signal for next iteration
-						nextIterationFront.insert(candidate);
+				}
+				// A signal may have been missed if a successor list is incomplete: one last look at the waiting signals
+				progress = false;
+				for(auto const & pending: pendingPredecessors) {
+					if(!pending.first->hasBeenScheduled() && countUnscheduledPredecessors(pending.first) == 0) {
+						worklist.push_back(pending.first);
+						progress = true;
 					}
 				}
-				// copy the new wavefront
-				successorsFront = nextIterationFront;
-			} // end main while loop
+			}
+
+			// The signals still waiting for their predecessors will be candidates at the next call
+			for(auto const & pending: pendingPredecessors) {
+				if(!pending.first->hasBeenScheduled()) {
+					REPORT(LogLevel::DEBUG, "schedule(): " << pending.first->getUniqueName() << " is waiting for " << pending.second << " predecessor(s)");
+					pending.first->parentOp()->addSchedulingCandidate(pending.first);
+				}
+			}
 
 			set<string> unscheduledOutputs;
 			for(auto i: ioList_)	{
@@ -3601,6 +3763,13 @@ namespace flopoco{
 		vhdl << align << "-- " << comment << endl;
 	}
 
+	string Operator::opaqueVHDL(string code){
+		// A comment goes through the lexer and doApplySchedule unchanged, as long as it holds no ';', '?' or '$'
+		string placeholder = "-- opaque VHDL block " + to_string(opaqueVHDLBlocks_.size()) + "\n";
+		opaqueVHDLBlocks_.push_back(code);
+		return placeholder;
+	}
+
 	void Operator::addFullComment(string comment, int lineLength) {
 		string align = "--";
 		// - 2 for the two spaces
@@ -3653,6 +3822,7 @@ namespace flopoco{
     isExternal_         = op->isExternal();
 
 		generics_					= op->getGenerics();
+		opaqueVHDLBlocks_           = op->opaqueVHDLBlocks_;
 	}
 
 
@@ -3921,7 +4091,10 @@ namespace flopoco{
 		// launch the second VHDL parsing step. Works for sequential and combinatorial operators as well
 		if(!isOperatorApplyScheduleDone_) {
 			isOperatorApplyScheduleDone_=true;
-			doApplySchedule();
+			{
+				TRACE_PHASE("applySchedule", getName());
+				doApplySchedule();
+			}
 			// recursive call for the operator's subcomponents
 			for(auto it: subComponentList_) {
 				it->applySchedule();
@@ -16,6 +16,7 @@
 
 #include "flopoco/Posit/Fun/PositFunction.hpp"
 #include "flopoco/TestBenches/PositNumber.hpp"
+#include "flopoco/Tools/SollyaHandler.hpp"
 #include <sstream>
 #define LARGE_PREC 1000
 namespace flopoco{
@@ -74,7 +75,7 @@ namespace flopoco{
   void PositFunction::eval(mpz_class x,mpz_class &r) const
 	{
 	        mpfr_t X, R;
-	        sollya_lib_set_prec(sollya_lib_constant_from_int(LARGE_PREC));
+	        setSollyaPrecision(LARGE_PREC);
 	        PositNumber positx(width, wES, x);
 		mpfr_init2(X, LARGE_PREC);
 		mpfr_init2(R, LARGE_PREC);
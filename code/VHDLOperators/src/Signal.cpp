@@ -340,6 +340,9 @@ namespace flopoco{
 		//safe to insert a new signal in the predecessor list
 		pair<Signal*, int> newPredecessorPair = make_pair(predecessor, delayCycles);
 		predecessors_.push_back(newPredecessorPair);
+		//this signal may now be scheduled
+		if(parentOp_ != nullptr)
+			parentOp_->addSchedulingCandidate(this);
 	}
 
 	void Signal::addPredecessors(vector<pair<Signal*, int>> predecessorList)
@@ -668,17 +671,17 @@ namespace flopoco{
 	std::string Signal::valueToVHDLHex(mpz_class v, bool quot){
 		std::string o;
 
-		/* Get base 16 representation */
-		o = v.get_str(16);
-
-		/* Some check */
-		/* XXX: Too permissive */
-		if ((int)o.size() * 4 > width() + 4)	{
+		/* Some check: the value must fit on width() bits, as in unsignedBinary(),
+			 otherwise it would take an extra digit and shift what follows in a test file */
+		if (v < 0 || v >= (mpz_class(1) << width()))	{
 			std::ostringstream o;
-			o << "Error in " <<  __FILE__ << "@" << __LINE__ << ": value is larger than signal " << getName();
+			o << "Error in " <<  __FILE__ << "@" << __LINE__ << ": value " << v << " does not fit on the " << width() << " bits of signal " << getName();
 			throw o.str();
 		}
 
+		/* Get base 16 representation */
+		o = v.get_str(16);
+
 		/* Do padding */
 		while ((int)o.size() * 4 < width())
 			o = "0" + o;
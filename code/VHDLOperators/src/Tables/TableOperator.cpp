@@ -3,6 +3,17 @@
 
 namespace flopoco
 {
+	namespace {
+		/** appends the w-bit binary writing of x (zero-extended if w > 64), the word-sized counterpart of unsignedBinary() */
+		void appendUnsignedBinary(string &s, uint64_t x, int w)
+		{
+			size_t pos = s.size();
+			s.resize(pos + w, '0');
+			for (int b = 0; b < w && b < 64; b++)
+				if ((x >> b) & 1)
+					s[pos + w - 1 - b] = '1';
+		}
+	} // namespace
 
 	TableOperator::TableOperator(OperatorPtr parentOp_, Target *target_)
 		: Operator(parentOp_, target_), wIn(table.wIn), wOut(table.wOut)    // FIXME highly suspiscious, table.wOut is uninitialized
@@ -115,13 +126,34 @@ namespace flopoco
 
 		vhdl << tab << "with X select Y0 <= " << endl;
 
-		for (unsigned int i = table.minIn.get_ui();
-		     i <= table.maxIn.get_ui(); i++)
-			vhdl << tab << tab << "\""
-			     << unsignedBinary(table[i - table.minIn.get_ui()],
-					       wOut)
-			     << "\" when \"" << unsignedBinary(i, wIn) << "\","
-			     << endl;
+		// The table entries mention no signal: they bypass the lexer and
+		// the scheduler, which only see the with..select around them
+		unsigned int minIn = table.minIn.get_ui();
+		unsigned int maxIn = table.maxIn.get_ui();
+		if (table.isPacked()) {
+			// word-sized values: the entries are written without any mpz arithmetic
+			string entries;
+			entries.reserve((size_t)(maxIn - minIn + 1) * (2 * tab.size() + wOut + wIn + 12));
+			for (unsigned int i = minIn; i <= maxIn; i++) {
+				entries += tab;
+				entries += tab;
+				entries += '"';
+				appendUnsignedBinary(entries, table.packedValues[i - minIn], wOut);
+				entries += "\" when \"";
+				appendUnsignedBinary(entries, i, wIn);
+				entries += "\",\n";
+			}
+			vhdl << opaqueVHDL(std::move(entries));
+		}
+		else {
+			ostringstream entries;
+			for (unsigned int i = minIn; i <= maxIn; i++)
+				entries << tab << tab << "\""
+				     << unsignedBinary(table[i - minIn], wOut)
+				     << "\" when \"" << unsignedBinary(i, wIn) << "\","
+				     << endl;
+			vhdl << opaqueVHDL(entries.str());
+		}
 		vhdl << tab << tab << "\"";
 		for (int i = 0; i < wOut; i++)
 			vhdl << "-";
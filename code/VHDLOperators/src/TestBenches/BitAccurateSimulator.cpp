@@ -0,0 +1,2403 @@
+/*
+  In-process bit-accurate simulation of the VHDL generated by an operator.
+
+  This file is part of the FloPoCo project
+
+  Initial software.
+  Copyright © INSA-Lyon, INRIA, CNRS, UCBL,
+  2008-2024.
+  All rights reserved.
+
+ */
+
+/*
+  The architecture body of each operator is parsed once into expression trees, then compiled once
+  into a flat program of word-level instructions. Each VHDL operator, function and type conversion
+  is resolved at compile time into an opcode, with the widths and signedness of its operands:
+  simulating a test case is a single pass over the program, dispatched on the opcode, on values
+  packed into 64-bit words. Parts of the program that only depend on constants (tables, literals,
+  constant declarations) are computed once at compile time.
+
+  The signals are evaluated in an order given by the scheduled signal graph of the operator.
+  Registers are simulated: X_dN (or X_cN) reads the value X had N cycles ago, and each clock
+  cycle shifts these values. The test cases are applied one per cycle, and the outputs are checked
+  pipeline-depth cycles later, as in the VHDL test bench.
+*/
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <queue>
+#include <set>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <gmp.h>
+#include <gmpxx.h>
+
+#include "flopoco/Operator.hpp"
+#include "flopoco/TestBenches/BitAccurateSimulator.hpp"
+#include "flopoco/TestBenches/TestBench.hpp"
+#include "flopoco/TestBenches/TestCase.hpp"
+#include "flopoco/UserInterface.hpp"
+#include "flopoco/utils.hpp"
+
+using namespace std;
+
+#define SIMERROR(stream) {{ostringstream __o; __o << "ERROR in BitAccurateSimulator: " << stream; throw __o.str();}}
+
+namespace flopoco{
+
+	namespace {
+
+		/** A VHDL literal, as parsed: a bit, a bit vector, an integer, a boolean */
+		struct Value {
+			enum Kind {bit, bits, integer, boolean, fill};
+			Kind kind = bits;
+			mpz_class v = 0;        /**< bits: the bits as a non-negative integer; integer: the value; bit and boolean: 0 or 1 */
+			int width = 0;          /**< number of bits, for bits */
+			bool isSigned = false;  /**< for bits: signed or unsigned interpretation in arithmetic and comparisons */
+			bool untyped = false;   /**< for bits: literals and concatenations, whose signedness comes from the other operand */
+		};
+
+		mpz_class ones(int w) {
+			return (mpz_class(1) << w) - 1;
+		}
+
+		Value makeBits(mpz_class v, int w, bool isSigned) {
+			Value r;
+			r.width = w;
+			r.v = v & ones(w);
+			r.isSigned = isSigned;
+			return r;
+		}
+
+		Value makeScalar(Value::Kind kind, mpz_class v) {
+			Value r;
+			r.kind = kind;
+			r.v = v;
+			r.width = (kind == Value::bit ? 1 : 0);
+			return r;
+		}
+
+		/** The number represented by w bits, in two's complement */
+		mpz_class signedValue(mpz_class v, int w) {
+			if(w > 0 && mpz_tstbit(v.get_mpz_t(), w-1))
+				return v - (mpz_class(1) << w);
+			return v;
+		}
+
+
+		/** The type of an expression, known at compile time: a bit, a vector, an integer, a boolean, or the (others => b) aggregate */
+		struct Type {
+			Value::Kind kind = Value::bits;
+			int width = 0;          /**< number of bits, for bits; 1 for bit */
+			bool isSigned = false;  /**< for bits: signed or unsigned interpretation in arithmetic and comparisons */
+			bool untyped = false;   /**< for bits: literals and concatenations, whose signedness comes from the other operand */
+		};
+
+		Type bitsType(int w, bool isSigned, bool untyped = false) {
+			Type t;
+			t.width = w;
+			t.isSigned = isSigned;
+			t.untyped = untyped;
+			return t;
+		}
+
+		Type scalarType(Value::Kind kind) {
+			Type t;
+			t.kind = kind;
+			t.width = (kind == Value::bit ? 1 : 0);
+			return t;
+		}
+
+		/** The number of bits that hold a value: integers are 64-bit two's complement, bits, booleans and (others => b) are 0 or 1 */
+		int storedWidth(const Type& t) {
+			return t.kind == Value::bits ? t.width : (t.kind == Value::integer ? 64 : 1);
+		}
+
+		/** Whether the stored bits of a value represent a signed number */
+		bool numericSigned(const Type& t) {
+			return t.kind == Value::integer || (t.kind == Value::bits && t.isSigned);
+		}
+
+		/** An expression compiled into the frame: its type, and the first word of its value */
+		struct Operand {
+			Type t;
+			int slot;
+		};
+
+
+		/* Values of w bits are packed in 64-bit words, least significant word first,
+			 with the bits above w always 0. A value of 0 bits still uses one word. */
+
+		int wordCount(int w) {
+			return w <= 64 ? 1 : (w+63)/64;
+		}
+
+		uint64_t lowMask(int w) {
+			return w >= 64 ? ~uint64_t(0) : (uint64_t(1) << w) - 1;
+		}
+
+		void maskTop(uint64_t* x, int w) {
+			int n = wordCount(w);
+			x[n-1] &= lowMask(w - 64*(n-1));
+		}
+
+		bool testBit(const uint64_t* x, int64_t i) {
+			return (x[i >> 6] >> (i & 63)) & 1;
+		}
+
+		/** The 64 bits of x (n words) starting at bit pos, which may be negative or beyond x: the missing bits are 0 */
+		uint64_t getWord(const uint64_t* x, int n, int64_t pos) {
+			if(pos <= -64 || pos >= 64*(int64_t)n)
+				return 0;
+			if(pos < 0)
+				return x[0] << (-pos);
+			int64_t q = pos >> 6;
+			int r = pos & 63;
+			if(r == 0)
+				return x[q];
+			uint64_t hi = (q+1 < n ? x[q+1] : 0);
+			return (x[q] >> r) | (hi << (64-r));
+		}
+
+		/** The number represented by x (at most 64 bits) */
+		__int128 toInt128(const uint64_t* x, int w, bool isSigned) {
+			if(isSigned && w > 0 && testBit(x, w-1))
+				return (__int128)x[0] - ((__int128)1 << w);
+			return x[0];
+		}
+
+		mpz_class toMpz(const uint64_t* x, int w) {
+			mpz_class r;
+			mpz_import(r.get_mpz_t(), wordCount(w), -1, sizeof(uint64_t), 0, 0, x);
+			return r;
+		}
+
+		/** d (w bits) = x (wx bits), sign-extended if isSigned, zero-extended otherwise, or truncated */
+		void extend(uint64_t* d, int w, const uint64_t* x, int wx, bool isSigned) {
+			int nd = wordCount(w), nx = wordCount(wx);
+			bool negative = isSigned && wx > 0 && testBit(x, wx-1);
+			for(int k = 0; k < nd; k++) {
+				if(k < nx) {
+					d[k] = x[k];
+					if(negative && k == nx-1 && (wx & 63) != 0)
+						d[k] |= ~lowMask(wx & 63);
+				}
+				else
+					d[k] = (negative ? ~uint64_t(0) : 0);
+			}
+			maskTop(d, w);
+		}
+
+		/** d (w bits) = the bits of x (wx bits) from pos upwards */
+		void extract(uint64_t* d, int w, const uint64_t* x, int wx, int64_t pos) {
+			int nd = wordCount(w), nx = wordCount(wx);
+			for(int k = 0; k < nd; k++)
+				d[k] = getWord(x, nx, pos + 64*k);
+			maskTop(d, w);
+		}
+
+		/** The bits pos to pos+w-1 of d = x (w bits) */
+		void deposit(uint64_t* d, int64_t pos, const uint64_t* x, int w) {
+			int nx = wordCount(w);
+			for(int done = 0; done < w; ) {
+				int64_t q = (pos+done) >> 6;
+				int r = (pos+done) & 63;
+				int n = std::min(64-r, w-done);
+				uint64_t m = lowMask(n);
+				d[q] = (d[q] & ~(m << r)) | ((getWord(x, nx, done) & m) << r);
+				done += n;
+			}
+		}
+
+		/** d = x+y or x-y, modulo 2^w */
+		void add(uint64_t* d, const uint64_t* x, const uint64_t* y, int w, bool subtract) {
+			int n = wordCount(w);
+			uint64_t carry = (subtract ? 1 : 0);
+			for(int k = 0; k < n; k++) {
+				unsigned __int128 s = (unsigned __int128)x[k] + (subtract ? ~y[k] : y[k]) + carry;
+				d[k] = (uint64_t)s;
+				carry = (uint64_t)(s >> 64);
+			}
+			maskTop(d, w);
+		}
+
+		/** d = -x, modulo 2^w */
+		void negate(uint64_t* d, const uint64_t* x, int w) {
+			int n = wordCount(w);
+			uint64_t carry = 1;
+			for(int k = 0; k < n; k++) {
+				unsigned __int128 s = (unsigned __int128)(~x[k]) + carry;
+				d[k] = (uint64_t)s;
+				carry = (uint64_t)(s >> 64);
+			}
+			maskTop(d, w);
+		}
+
+		/** d = x*y, modulo 2^w */
+		void multiply(uint64_t* d, const uint64_t* x, const uint64_t* y, int w) {
+			int n = wordCount(w);
+			vector<uint64_t> r(n, 0);
+			for(int i = 0; i < n; i++) {
+				unsigned __int128 carry = 0;
+				for(int j = 0; i+j < n; j++) {
+					unsigned __int128 p = (unsigned __int128)x[i]*y[j] + r[i+j] + carry;
+					r[i+j] = (uint64_t)p;
+					carry = p >> 64;
+				}
+			}
+			std::copy(r.begin(), r.end(), d);
+			maskTop(d, w);
+		}
+
+		/** Compares the numbers represented by x (wx bits) and y (wy bits): -1, 0 or 1 */
+		int compare(const uint64_t* x, int wx, bool sx, const uint64_t* y, int wy, bool sy) {
+			if(wx <= 64 && wy <= 64) {
+				__int128 a = toInt128(x, wx, sx), b = toInt128(y, wy, sy);
+				return (a > b) - (a < b);
+			}
+			// extended to a common width where both are signed
+			int w = std::max(wx, wy) + 1;
+			vector<uint64_t> a(wordCount(w)), b(wordCount(w));
+			extend(a.data(), w, x, wx, sx);
+			extend(b.data(), w, y, wy, sy);
+			bool na = testBit(a.data(), w-1), nb = testBit(b.data(), w-1);
+			if(na != nb)
+				return na ? -1 : 1;
+			for(int k = a.size()-1; k >= 0; k--)
+				if(a[k] != b[k])
+					return a[k] < b[k] ? -1 : 1;
+			return 0;
+		}
+
+		/** d (w bits) = x (w bits) shifted left, or right (arithmetically if isSigned), by n >= 0 */
+		void shift(uint64_t* d, const uint64_t* x, int w, int64_t n, bool right, bool isSigned) {
+			int nw = wordCount(w);
+			n = std::min(n, (int64_t)w);
+			for(int k = 0; k < nw; k++)
+				d[k] = getWord(x, nw, right ? 64*k + n : 64*k - n);
+			if(right && isSigned && w > 0 && testBit(x, w-1)) {
+				for(int64_t i = w-n; i < w; ) {
+					int r = i & 63;
+					int m = (int)std::min((int64_t)(64-r), w-i);
+					d[i >> 6] |= lowMask(m) << r;
+					i += m;
+				}
+			}
+			maskTop(d, w);
+		}
+
+
+		/** The instructions of a compiled architecture body */
+		enum class Opcode {
+			Clear,       /**< dst = 0 */
+			Extend,      /**< dst = a, sign-extended if sa, zero-extended, or truncated */
+			Fill,        /**< dst = (others => a) */
+			Not, And, Or, Xor,
+			Add, Sub, Neg, Mul,
+			Abs,         /**< dst = |a|, a being signed if sa */
+			Div, Rem, Mod, /**< on at most 64 bits */
+			CmpEq, CmpNe, CmpLt, CmpLe, CmpGt, CmpGe,
+			Extract,     /**< dst = a(imm+w-1 downto imm) */
+			ExtractDyn,  /**< dst = a(b), checked against the range of a */
+			Insert,      /**< dst(imm+w-1 downto imm) = a */
+			Concat,      /**< dst = a & b */
+			Shl, Shr,    /**< dst = a shifted by the integer b */
+			Sra,         /**< dst = a shifted right by the integer b, arithmetically if sa */
+			IntAdd, IntSub, IntMul, IntPow, IntDiv, IntRem, IntMod, IntNeg, IntAbs,
+			ToInt,       /**< dst = the integer represented by a */
+			Lookup,      /**< dst = the constant of the lookup table imm at index a */
+			Jump,        /**< go to imm */
+			JumpIfZero,  /**< go to imm if a is false */
+			Switch,      /**< go to the target of the value of a in the switch table imm, if any */
+			NoChoice,    /**< error: no choice of a selected assignment for the value of a */
+			Call,        /**< simulate the instance imm */
+			Error        /**< error with the message imm */
+		};
+
+		struct Instr {
+			Opcode op;
+			int dst = -1, a = -1, b = -1;  /**< slots in the frame */
+			int w = 0, wa = 0, wb = 0;     /**< the widths of dst, a and b */
+			bool sa = false, sb = false;   /**< whether a and b are signed */
+			int64_t imm = 0;               /**< a bit position, a jump target, or the number of a table, instance or message */
+			uint64_t mask = 0;             /**< lowMask(w) */
+		};
+
+		Instr makeInstr(Opcode op, int dst, int w, int a = -1, int wa = 0, bool sa = false, int b = -1, int wb = 0, bool sb = false, int64_t imm = 0) {
+			Instr i;
+			i.op = op;
+			i.dst = dst;
+			i.w = w;
+			i.a = a;
+			i.wa = wa;
+			i.sa = sa;
+			i.b = b;
+			i.wb = wb;
+			i.sb = sb;
+			i.imm = imm;
+			i.mask = lowMask(w);
+			return i;
+		}
+
+
+		struct Token {
+			enum Type {identifier, number, bitString, character, symbol, end};
+			Type type;
+			string text;   /**< for bit strings, the binary digits */
+			string lower;  /**< the text in lower case, VHDL keywords and identifiers being case-insensitive */
+		};
+
+		vector<Token> tokenize(const string& code) {
+			vector<Token> tokens;
+			size_t i = 0, n = code.size();
+			auto push = [&](Token::Type type, string text) {
+				string lower = text;
+				for(auto& c: lower)
+					c = tolower(c);
+				tokens.push_back({type, text, lower});
+			};
+			while(i < n) {
+				char c = code[i];
+				if(isspace(c)) {
+					i++;
+				}
+				else if(c == '-' && i+1 < n && code[i+1] == '-') { // comment
+					while(i < n && code[i] != '\n')
+						i++;
+				}
+				else if(isalpha(c) && i+1 < n && code[i+1] == '"' && string("bBoOxX").find(c) != string::npos) { // based bit string
+					int digitBits = (tolower(c) == 'b' ? 1 : (tolower(c) == 'o' ? 3 : 4));
+					size_t j = code.find('"', i+2);
+					if(j == string::npos)
+						SIMERROR("unterminated bit string");
+					string binary;
+					for(size_t k = i+2; k < j; k++) {
+						if(code[k] == '_')
+							continue;
+						int d = isdigit(code[k]) ? code[k]-'0' : (isxdigit(code[k]) ? tolower(code[k])-'a'+10 : 0);
+						for(int b = digitBits-1; b >= 0; b--)
+							binary += ((d >> b) & 1) ? '1' : '0';
+					}
+					push(Token::bitString, binary);
+					i = j+1;
+				}
+				else if(isalpha(c)) {
+					size_t j = i;
+					while(j < n && (isalnum(code[j]) || code[j] == '_'))
+						j++;
+					push(Token::identifier, code.substr(i, j-i));
+					i = j;
+				}
+				else if(isdigit(c)) {
+					string digits;
+					while(i < n && (isdigit(code[i]) || code[i] == '_')) {
+						if(code[i] != '_')
+							digits += code[i];
+						i++;
+					}
+					push(Token::number, digits);
+				}
+				else if(c == '"') {
+					size_t j = code.find('"', i+1);
+					if(j == string::npos)
+						SIMERROR("unterminated bit string");
+					string binary;
+					for(size_t k = i+1; k < j; k++)
+						if(code[k] != '_')
+							binary += code[k];
+					push(Token::bitString, binary);
+					i = j+1;
+				}
+				else if(c == '\'' && i+2 < n && code[i+2] == '\'') {
+					push(Token::character, code.substr(i+1, 1));
+					i += 3;
+				}
+				else {
+					static const set<string> twoCharSymbols = {"<=", "=>", "/=", ">=", "**", ":="};
+					if(i+1 < n && twoCharSymbols.count(code.substr(i, 2))) {
+						push(Token::symbol, code.substr(i, 2));
+						i += 2;
+					}
+					else {
+						push(Token::symbol, code.substr(i, 1));
+						i++;
+					}
+				}
+			}
+			tokens.push_back({Token::end, "", ""});
+			return tokens;
+		}
+
+		/** The tokens of a piece of VHDL code, and the current position in them */
+		struct Parser {
+			vector<Token> tokens;
+			size_t pos = 0;
+
+			const Token& peek(int k = 0) {
+				return tokens[std::min(pos+k, tokens.size()-1)];
+			}
+			const Token& next() {
+				const Token& t = peek();
+				if(pos < tokens.size()-1)
+					pos++;
+				return t;
+			}
+			bool atEnd() {
+				return peek().type == Token::end;
+			}
+			bool isSymbol(string s, int k = 0) {
+				return peek(k).type == Token::symbol && peek(k).text == s;
+			}
+			bool isKeyword(string s, int k = 0) {
+				return peek(k).type == Token::identifier && peek(k).lower == s;
+			}
+			void expectSymbol(string s) {
+				if(!isSymbol(s))
+					SIMERROR("expected '" << s << "' but found '" << peek().text << "'");
+				next();
+			}
+			void expectKeyword(string s) {
+				if(!isKeyword(s))
+					SIMERROR("expected '" << s << "' but found '" << peek().text << "'");
+				next();
+			}
+			string expectIdentifier() {
+				if(peek().type != Token::identifier)
+					SIMERROR("expected an identifier but found '" << peek().text << "'");
+				return next().text;
+			}
+		};
+
+		/** The VHDL operators, resolved when parsing. Unary + and - are Add and Sub with one argument. */
+		enum class Operation {And, Or, Xor, Nand, Nor, Xnor, Eq, Ne, Lt, Le, Gt, Ge, Sll, Srl, Sla, Sra, Add, Sub, Concat, Mul, Div, Mod, Rem, Pow, Not, Abs};
+
+		const map<string, Operation> operations = {
+			{"and", Operation::And}, {"or", Operation::Or}, {"xor", Operation::Xor}, {"nand", Operation::Nand}, {"nor", Operation::Nor}, {"xnor", Operation::Xnor},
+			{"=", Operation::Eq}, {"/=", Operation::Ne}, {"<", Operation::Lt}, {"<=", Operation::Le}, {">", Operation::Gt}, {">=", Operation::Ge},
+			{"sll", Operation::Sll}, {"srl", Operation::Srl}, {"sla", Operation::Sla}, {"sra", Operation::Sra},
+			{"+", Operation::Add}, {"-", Operation::Sub}, {"&", Operation::Concat},
+			{"*", Operation::Mul}, {"/", Operation::Div}, {"mod", Operation::Mod}, {"rem", Operation::Rem}, {"**", Operation::Pow},
+			{"not", Operation::Not}, {"abs", Operation::Abs}};
+
+		/** The functions of the IEEE libraries, resolved when parsing */
+		enum class Function {Unsigned, Signed, StdLogicVector, ToInteger, ToUnsigned, ToSigned, ConvUnsigned, ConvSigned, ConvStdLogicVector, Resize, Ext, Sxt, ShiftLeft, ShiftRight};
+
+		const map<string, Function> functions = {
+			{"unsigned", Function::Unsigned}, {"signed", Function::Signed}, {"std_logic_vector", Function::StdLogicVector}, {"std_ulogic_vector", Function::StdLogicVector},
+			{"to_integer", Function::ToInteger}, {"conv_integer", Function::ToInteger},
+			{"to_unsigned", Function::ToUnsigned}, {"to_signed", Function::ToSigned},
+			{"conv_unsigned", Function::ConvUnsigned}, {"conv_signed", Function::ConvSigned}, {"conv_std_logic_vector", Function::ConvStdLogicVector},
+			{"resize", Function::Resize}, {"ext", Function::Ext}, {"sxt", Function::Sxt},
+			{"shift_left", Function::ShiftLeft}, {"shift_right", Function::ShiftRight}};
+
+		/** A node of an expression tree */
+		struct Node {
+			enum Op {constant, namedConstant, signal, index, slice, unary, binary, call, conditional, fill, rangeFill};
+			Op op;
+			Value value;                 /**< for constant; for namedConstant, the signedness of its declared type */
+			int sig = -1;                /**< the signal number, for signal, index and slice */
+			int delay = 0;               /**< for signal, index and slice: the number of cycles the signal is delayed by, as in X_dN */
+			Operation operation;         /**< for unary and binary */
+			Function function;           /**< for call */
+			string name;                 /**< the operator, function or constant name, for error messages */
+			vector<Node*> args;
+		};
+
+		/** What drives (part of) a signal: an assignment, a selected assignment, or an output of an instance */
+		struct Driver {
+			Node* high = nullptr;   /**< for a partial assignment target(high downto low) */
+			Node* low = nullptr;
+			Node* value = nullptr;
+			int selected = -1;
+			int instance = -1;
+			int port = -1;
+		};
+
+		struct SelectedAssignment {
+			Node* selector;
+			vector<pair<Node*, Node*>> choices;  /**< (choice, value), in the order of the code */
+			Node* others = nullptr;
+		};
+
+		/** The targets of a Switch instruction: the constant choices of a selected assignment */
+		struct SwitchTable {
+			unordered_map<uint64_t, int64_t> targets;       /**< for selectors of at most 64 bits */
+			map<vector<uint64_t>, int64_t> wideTargets;
+		};
+	}
+
+	/** The simulation model of one operator: its architecture body, parsed and compiled once */
+	class SimulationModel {
+	public:
+		SimulationModel(Operator* op, map<Operator*, SimulationModel*>& models);
+
+		/** Sets input number i (in the order of getInputList()) to the bits of v */
+		void setInput(int i, mpz_class v);
+
+		/** The bits of output number i (in the order of getOutputList()), as a non-negative integer */
+		mpz_class getOutput(int i);
+
+		/** Computes all the signals of the current cycle, from the inputs and the registers */
+		void evaluate();
+
+		/** The rising edge of the clock: the registers, here and in the sub-components, take the values of the current cycle */
+		void clock();
+
+		int inputNumber(string name) {
+			for(size_t i = 0; i < inputs.size(); i++)
+				if(inputs[i]->getName() == name)
+					return i;
+			return -1;
+		}
+
+		int outputNumber(string name) {
+			for(size_t i = 0; i < outputs.size(); i++)
+				if(outputs[i]->getName() == name)
+					return i;
+			return -1;
+		}
+
+		vector<Signal*> inputs;
+		vector<Signal*> outputs;
+
+	private:
+		struct Instance {
+			SimulationModel* model = nullptr; /**< owned: each instance has its own copy of the model, hence its own registers */
+			vector<Node*> inputs;    /**< the actual of each input of the sub-component */
+			string name;
+			vector<int> inputSlots;  /**< where the actuals are computed */
+			vector<int> outputSlots; /**< where the outputs of the sub-component are copied */
+
+			Instance() = default;
+			Instance(const Instance& i);
+			Instance(Instance&& i) noexcept;
+			Instance& operator=(const Instance&) = delete;
+			~Instance();
+		};
+
+		/** Copies a register: the words of slot src into slot dst */
+		struct RegisterCopy {
+			int dst;
+			int src;
+			int words;
+		};
+
+		int signalNumber(string name, int* delay = nullptr);
+		Node* newNode(Node::Op op);
+		Node* constantNode(string name);
+		Node* operationNode(Node::Op op, string name, vector<Node*> args);
+
+		void parseStatement(Parser& p);
+		int parseTarget(Parser& p, Driver& d);
+		void parseAssignment(Parser& p);
+		void parseSelectedAssignment(Parser& p);
+		void parseInstance(Parser& p, string label);
+		Node* parseWaveform(Parser& p);
+		Node* parseExpression(Parser& p);
+		Node* parseRelation(Parser& p);
+		Node* parseShift(Parser& p);
+		Node* parseSimpleExpression(Parser& p);
+		Node* parseTerm(Parser& p);
+		Node* parseFactor(Parser& p);
+		Node* parsePrimary(Parser& p);
+		Node* parseIdentifier(Parser& p);
+
+		void collectSignals(Node* n, vector<int>& combinational, vector<int>& registered);
+		void buildEvaluationOrder();
+
+		int allocate(int width);
+		Operand temporary(Type t);
+		int message(string m);
+		void emit(Instr i, bool foldable = true);
+		bool isConstant(Node* n);
+		Operand constantOperand(const Value& v);
+		Operand signalOperand(int s, int delay);
+		Operand compile(Node* n);
+		Operand compileBinary(Node* n, Operand a, Operand b);
+		Operand compileCall(Node* n);
+		Operand toBits(Operand x, int w, bool isSigned);
+		Operand extended(Operand x, int w, bool isSigned);
+		Operand toInteger(Operand x);
+		int64_t constantInteger(Node* n, string what);
+		void store(Operand x, int slot, int w, bool foldable);
+		void compileWaveform(Node* n, int slot, int w);
+		void compileSelected(SelectedAssignment& sa, int slot, int w);
+		void compileDriver(Driver& d, int slot, int w);
+		void compileSignal(int s);
+		void compileInstance(int i);
+		void compileProgram();
+
+		void apply(const Instr& i);
+		void call(Instance& inst);
+
+		Operator* op;
+		Operator* bodyOp;                             /**< the operator holding the architecture body: op, or its indirect operator */
+		map<Operator*, SimulationModel*>& models;
+		bool slvSigned;                               /**< true if std_logic_signed is used: std_logic_vector arithmetic is then signed */
+		vector<Signal*> signals;
+		map<string, int> signalIndex;
+		map<string, int> delayedNames;                /**< the delay of each name X_dN or X_cN */
+		vector<vector<Driver>> drivers;
+		vector<int> inputIndex, outputIndex;
+		deque<Node> nodes;
+		map<string, Node*> constants;
+		vector<SelectedAssignment> selectedAssignments;
+		vector<Instance> instances;
+		vector<int> evaluationOrder;                  /**< signal numbers, and instance numbers offset by signals.size() */
+
+		vector<Type> signalTypes;
+		vector<int> signalSlots;
+		vector<vector<int>> history;                  /**< history[s][d-1]: the slot of signal s delayed by d cycles */
+		vector<RegisterCopy> registerCopies;          /**< what the clock does, in order */
+		map<Node*, Operand> compiledConstants;
+		vector<uint64_t> frame;                       /**< the values of the signals, temporaries and constants */
+		vector<char> constantSlot;                    /**< for each word of the frame, whether it holds a constant */
+		vector<Instr> program;
+		vector<SwitchTable> switchTables;
+		vector<vector<int>> lookupTables;             /**< for each selector value, the slot of the constant, or -1 */
+		vector<string> messages;
+	};
+
+
+
+	SimulationModel::Instance::Instance(const Instance& i) :
+		model(new SimulationModel(*i.model)), inputs(i.inputs), name(i.name), inputSlots(i.inputSlots), outputSlots(i.outputSlots)
+	{
+	}
+
+
+	SimulationModel::Instance::Instance(Instance&& i) noexcept :
+		model(i.model), inputs(std::move(i.inputs)), name(std::move(i.name)), inputSlots(std::move(i.inputSlots)), outputSlots(std::move(i.outputSlots))
+	{
+		i.model = nullptr;
+	}
+
+
+	SimulationModel::Instance::~Instance() {
+		delete model;
+	}
+
+
+
+	SimulationModel::SimulationModel(Operator* op_, map<Operator*, SimulationModel*>& models_) :
+		op(op_), models(models_)
+	{
+		bodyOp = op->getIndirectOperator() ? op->getIndirectOperator() : op;
+		if(bodyOp->hasWriteEnable())
+			SIMERROR("operator " << op->getName() << " has write enables, which are not supported");
+		slvSigned = (bodyOp->getStdLibType() == -1 || bodyOp->getStdLibType() == 2);
+		inputs = bodyOp->getInputList();
+		outputs = bodyOp->getOutputList();
+		for(auto s: inputs)
+			inputIndex.push_back(signalNumber(s->getName()));
+		for(auto s: outputs)
+			outputIndex.push_back(signalNumber(s->getName()));
+
+		ostringstream body;
+		bodyOp->outputArchitectureBody(body);
+		string code = body.str();
+		// the markers of the lexer, should any remain
+		for(string marker: {"??", "$$"}) {
+			size_t i;
+			while((i = code.find(marker)) != string::npos)
+				code.erase(i, 2);
+		}
+		Parser p;
+		p.tokens = tokenize(code);
+		try {
+			while(!p.atEnd()) {
+				if(p.isSymbol(";"))
+					p.next();
+				else
+					parseStatement(p);
+			}
+			buildEvaluationOrder();
+			compileProgram();
+		} catch(string& s) {
+			throw s + " (in operator " + op->getName() + ")";
+		}
+		// only the program is needed from now on, and the instances copy the model
+		nodes.clear();
+		constants.clear();
+		compiledConstants.clear();
+		drivers.clear();
+		selectedAssignments.clear();
+		for(auto& i: instances)
+			i.inputs.clear();
+	}
+
+
+	int SimulationModel::signalNumber(string name, int* delay) {
+		if(delay != nullptr)
+			*delay = 0;
+		auto it = signalIndex.find(name);
+		if(it != signalIndex.end()) {
+			auto d = delayedNames.find(name);
+			if(delay != nullptr && d != delayedNames.end())
+				*delay = d->second;
+			return it->second;
+		}
+		if(!bodyOp->isSignalDeclared(name)) {
+			// X_dN is X delayed by N cycles, X_cN is X at cycle N (when signals are named after their cycle)
+			size_t i = name.rfind('_');
+			if(i == string::npos || i+2 >= name.size() || i+11 < name.size() || (name[i+1] != 'd' && name[i+1] != 'c'))
+				return -1;
+			for(size_t j = i+2; j < name.size(); j++)
+				if(!isdigit(name[j]))
+					return -1;
+			int baseDelay;
+			int s = signalNumber(name.substr(0, i), &baseDelay);
+			if(s < 0)
+				return -1;
+			int n = stoi(name.substr(i+2));
+			int d = baseDelay + (name[i+1] == 'd' ? n : n - signals[s]->getCycle());
+			if(d < 0)
+				SIMERROR(name << " refers to a cycle before the one of " << signals[s]->getName());
+			signalIndex[name] = s;
+			delayedNames[name] = d;
+			if(delay != nullptr)
+				*delay = d;
+			return s;
+		}
+		Signal* s = bodyOp->getSignalByName(name);
+		if(s->isCustom())
+			SIMERROR("signal " << name << " has a custom type, which is not supported");
+		signals.push_back(s);
+		drivers.push_back(vector<Driver>());
+		signalIndex[name] = signals.size()-1;
+		return signals.size()-1;
+	}
+
+
+	Node* SimulationModel::newNode(Node::Op op) {
+		nodes.push_back(Node());
+		nodes.back().op = op;
+		return &nodes.back();
+	}
+
+
+	Node* SimulationModel::operationNode(Node::Op op, string name, vector<Node*> args) {
+		Node* n = newNode(op);
+		n->name = name;
+		n->operation = operations.at(name);
+		n->args = args;
+		return n;
+	}
+
+
+	Node* SimulationModel::constantNode(string name) {
+		auto it = constants.find(name);
+		if(it != constants.end())
+			return it->second;
+		auto declared = bodyOp->getConstants();
+		if(declared.find(name) == declared.end())
+			return nullptr;
+		string type = declared[name].first;
+		Parser p;
+		p.tokens = tokenize(declared[name].second);
+		Node* n = newNode(Node::namedConstant);
+		n->name = name;
+		n->value.isSigned = (type.find("signed") != string::npos && type.find("unsigned") == string::npos) || (type.find("std_logic_vector") != string::npos && slvSigned);
+		constants[name] = n;
+		n->args = {parseExpression(p)};
+		return n;
+	}
+
+
+
+	void SimulationModel::parseStatement(Parser& p) {
+		static const set<string> unsupported = {"process", "if", "case", "for", "while", "generate", "block", "assert", "report", "wait", "component"};
+		string label;
+		if(p.peek().type == Token::identifier && p.isSymbol(":", 1)) {
+			label = p.next().text;
+			p.next();
+			if(p.isKeyword("entity")) { // label: entity work.Name port map ...
+				p.next();
+				p.expectIdentifier();
+				p.expectSymbol(".");
+			}
+			if(p.peek().type == Token::identifier && (p.isKeyword("port", 1) || p.isKeyword("generic", 1))) {
+				parseInstance(p, label);
+				return;
+			}
+		}
+		if(p.peek().type == Token::identifier && unsupported.count(p.peek().lower))
+			SIMERROR("unsupported VHDL construct '" << p.peek().text << "'");
+		if(p.isKeyword("with"))
+			parseSelectedAssignment(p);
+		else
+			parseAssignment(p);
+	}
+
+
+	int SimulationModel::parseTarget(Parser& p, Driver& d) {
+		string name = p.expectIdentifier();
+		int delay;
+		int s = signalNumber(name, &delay);
+		if(s < 0)
+			SIMERROR("assignment to unknown signal " << name);
+		if(delay != 0)
+			SIMERROR("assignment to " << name << ", a delayed version of " << signals[s]->getName() << ", outside of the registers");
+		if(p.isSymbol("(")) {
+			p.next();
+			d.high = parseExpression(p);
+			d.low = d.high;
+			if(p.isKeyword("downto")) {
+				p.next();
+				d.low = parseExpression(p);
+			}
+			else if(p.isKeyword("to")) {
+				p.next();
+				d.low = d.high;
+				d.high = parseExpression(p);
+			}
+			p.expectSymbol(")");
+		}
+		return s;
+	}
+
+
+	void SimulationModel::parseAssignment(Parser& p) {
+		Driver d;
+		int s = parseTarget(p, d);
+		p.expectSymbol("<=");
+		d.value = parseWaveform(p);
+		p.expectSymbol(";");
+		drivers[s].push_back(d);
+	}
+
+
+	void SimulationModel::parseSelectedAssignment(Parser& p) {
+		SelectedAssignment sa;
+		p.expectKeyword("with");
+		sa.selector = parseExpression(p);
+		p.expectKeyword("select");
+		Driver d;
+		int s = parseTarget(p, d);
+		p.expectSymbol("<=");
+		while(true) {
+			Node* value = parseExpression(p);
+			p.expectKeyword("when");
+			while(true) {
+				if(p.isKeyword("others")) {
+					p.next();
+					sa.others = value;
+				}
+				else
+					sa.choices.push_back(make_pair(parseExpression(p), value));
+				if(!p.isSymbol("|"))
+					break;
+				p.next();
+			}
+			if(!p.isSymbol(","))
+				break;
+			p.next();
+		}
+		p.expectSymbol(";");
+		d.selected = selectedAssignments.size();
+		selectedAssignments.push_back(sa);
+		drivers[s].push_back(d);
+	}
+
+
+	void SimulationModel::parseInstance(Parser& p, string label) {
+		string componentName = p.expectIdentifier();
+		Operator* sub = bodyOp->getSubComponent(componentName);
+		if(sub == nullptr)
+			SIMERROR("instance " << label << " of unknown component " << componentName);
+		if(sub->isExternal())
+			SIMERROR("instance " << label << " of " << componentName << " is a primitive, which cannot be simulated");
+		// each component is compiled once, and each instance has its own copy, hence its own registers
+		if(models.find(sub) == models.end())
+			models[sub] = new SimulationModel(sub, models);
+		Instance inst;
+		inst.model = new SimulationModel(*models[sub]);
+		inst.name = label;
+		inst.inputs.assign(inst.model->inputs.size(), nullptr);
+		int instanceNumber = instances.size();
+
+		if(p.isKeyword("generic")) { // skip the generic map
+			p.next();
+			p.expectKeyword("map");
+			p.expectSymbol("(");
+			for(int depth = 1; depth > 0 && !p.atEnd(); p.next())
+				depth += (p.isSymbol("(") ? 1 : (p.isSymbol(")") ? -1 : 0));
+		}
+		p.expectKeyword("port");
+		p.expectKeyword("map");
+		p.expectSymbol("(");
+		vector<pair<int, Driver>> outputDrivers;
+		while(true) {
+			string formal = p.expectIdentifier();
+			p.expectSymbol("=>");
+			int in = inst.model->inputNumber(formal);
+			int out = inst.model->outputNumber(formal);
+			if(p.isKeyword("open"))
+				p.next();
+			else if(in >= 0)
+				inst.inputs[in] = parseExpression(p);
+			else if(out >= 0) {
+				Driver d;
+				int s = parseTarget(p, d);
+				d.instance = instanceNumber;
+				d.port = out;
+				outputDrivers.push_back(make_pair(s, d));
+			}
+			else { // clk, rst and the like
+				for(int depth = 0; !p.atEnd() && !(depth == 0 && (p.isSymbol(",") || p.isSymbol(")"))); p.next())
+					depth += (p.isSymbol("(") ? 1 : (p.isSymbol(")") ? -1 : 0));
+			}
+			if(!p.isSymbol(","))
+				break;
+			p.next();
+		}
+		p.expectSymbol(")");
+		p.expectSymbol(";");
+		instances.push_back(std::move(inst));
+		for(auto& od: outputDrivers)
+			drivers[od.first].push_back(od.second);
+	}
+
+
+	Node* SimulationModel::parseWaveform(Parser& p) {
+		Node* first = parseExpression(p);
+		if(!p.isKeyword("when"))
+			return first;
+		Node* n = newNode(Node::conditional);
+		n->args.push_back(first);
+		while(p.isKeyword("when")) {
+			p.next();
+			n->args.push_back(parseExpression(p));
+			p.expectKeyword("else");
+			n->args.push_back(parseExpression(p));
+		}
+		return n;
+	}
+
+
+	Node* SimulationModel::parseExpression(Parser& p) {
+		static const set<string> logicalOperators = {"and", "or", "xor", "nand", "nor", "xnor"};
+		Node* l = parseRelation(p);
+		while(p.peek().type == Token::identifier && logicalOperators.count(p.peek().lower)) {
+			string name = p.next().lower;
+			l = operationNode(Node::binary, name, {l, parseRelation(p)});
+		}
+		return l;
+	}
+
+
+	Node* SimulationModel::parseRelation(Parser& p) {
+		static const set<string> relationalOperators = {"=", "/=", "<", "<=", ">", ">="};
+		Node* l = parseShift(p);
+		if(p.peek().type == Token::symbol && relationalOperators.count(p.peek().text)) {
+			string name = p.next().text;
+			return operationNode(Node::binary, name, {l, parseShift(p)});
+		}
+		return l;
+	}
+
+
+	Node* SimulationModel::parseShift(Parser& p) {
+		static const set<string> shiftOperators = {"sll", "srl", "sla", "sra"};
+		Node* l = parseSimpleExpression(p);
+		if(p.peek().type == Token::identifier && shiftOperators.count(p.peek().lower)) {
+			string name = p.next().lower;
+			return operationNode(Node::binary, name, {l, parseSimpleExpression(p)});
+		}
+		return l;
+	}
+
+
+	Node* SimulationModel::parseSimpleExpression(Parser& p) {
+		Node* l;
+		if(p.isSymbol("-") || p.isSymbol("+")) { // the sign applies to the first term
+			string name = p.next().text;
+			l = operationNode(Node::unary, name, {parseTerm(p)});
+		}
+		else
+			l = parseTerm(p);
+		while(p.isSymbol("+") || p.isSymbol("-") || p.isSymbol("&")) {
+			string name = p.next().text;
+			l = operationNode(Node::binary, name, {l, parseTerm(p)});
+		}
+		return l;
+	}
+
+
+	Node* SimulationModel::parseTerm(Parser& p) {
+		Node* l = parseFactor(p);
+		while(p.isSymbol("*") || p.isSymbol("/") || p.isKeyword("mod") || p.isKeyword("rem")) {
+			string name = p.next().lower;
+			l = operationNode(Node::binary, name, {l, parseFactor(p)});
+		}
+		return l;
+	}
+
+
+	Node* SimulationModel::parseFactor(Parser& p) {
+		if(p.isKeyword("not") || p.isKeyword("abs")) {
+			string name = p.next().lower;
+			return operationNode(Node::unary, name, {parsePrimary(p)});
+		}
+		Node* l = parsePrimary(p);
+		if(p.isSymbol("**")) {
+			string name = p.next().text;
+			return operationNode(Node::binary, name, {l, parsePrimary(p)});
+		}
+		return l;
+	}
+
+
+	Node* SimulationModel::parsePrimary(Parser& p) {
+		const Token& t = p.peek();
+		if(t.type == Token::number) {
+			Node* n = newNode(Node::constant);
+			n->value = makeScalar(Value::integer, mpz_class(p.next().text));
+			return n;
+		}
+		if(t.type == Token::bitString) {
+			string digits = p.next().text;
+			mpz_class v = 0;
+			for(char c: digits) // don't care and metavalues read as 0
+				v = 2*v + (c == '1' || c == 'H' || c == 'h' ? 1 : 0);
+			Node* n = newNode(Node::constant);
+			n->value = makeBits(v, digits.size(), slvSigned);
+			n->value.untyped = true;
+			return n;
+		}
+		if(t.type == Token::character) {
+			char c = p.next().text[0];
+			Node* n = newNode(Node::constant);
+			n->value = makeScalar(Value::bit, (c == '1' || c == 'H' || c == 'h' ? 1 : 0));
+			return n;
+		}
+		if(t.type == Token::identifier)
+			return parseIdentifier(p);
+		if(p.isSymbol("(")) {
+			p.next();
+			if(p.isKeyword("others") && p.isSymbol("=>", 1)) {
+				p.next();
+				p.next();
+				Node* n = newNode(Node::fill);
+				n->args = {parseExpression(p)};
+				p.expectSymbol(")");
+				return n;
+			}
+			Node* e = parseExpression(p);
+			if(p.isKeyword("downto") || p.isKeyword("to")) { // (h downto l => b)
+				bool downto = p.next().lower == "downto";
+				Node* e2 = parseExpression(p);
+				p.expectSymbol("=>");
+				Node* n = newNode(Node::rangeFill);
+				n->args = {downto ? e : e2, downto ? e2 : e, parseExpression(p)};
+				p.expectSymbol(")");
+				return n;
+			}
+			while(p.isSymbol(",")) { // positional aggregate of bits: a concatenation
+				p.next();
+				e = operationNode(Node::binary, "&", {e, parseExpression(p)});
+			}
+			p.expectSymbol(")");
+			return e;
+		}
+		SIMERROR("unexpected '" << t.text << "' in expression");
+	}
+
+
+	Node* SimulationModel::parseIdentifier(Parser& p) {
+		string name = p.next().text;
+		string lower = p.tokens[p.pos-1].lower;
+		int delay;
+		int s = signalNumber(name, &delay);
+		if(s >= 0) {
+			if(p.isSymbol("'")) { // the attributes of a signal are constants
+				p.next();
+				string attribute = p.next().lower;
+				int w = signals[s]->width();
+				if(attribute != "length" && attribute != "high" && attribute != "low")
+					SIMERROR("unsupported attribute '" << attribute << " of " << name);
+				Node* n = newNode(Node::constant);
+				n->value = makeScalar(Value::integer, attribute == "length" ? w : (attribute == "high" ? w-1 : 0));
+				return n;
+			}
+			if(!p.isSymbol("(")) {
+				Node* n = newNode(Node::signal);
+				n->sig = s;
+				n->delay = delay;
+				return n;
+			}
+			p.next();
+			Node* n = newNode(Node::index);
+			n->sig = s;
+			n->delay = delay;
+			n->args = {parseExpression(p)};
+			if(p.isKeyword("downto") || p.isKeyword("to")) {
+				bool downto = p.next().lower == "downto";
+				n->op = Node::slice;
+				Node* e2 = parseExpression(p);
+				n->args = {downto ? n->args[0] : e2, downto ? e2 : n->args[0]};
+			}
+			p.expectSymbol(")");
+			return n;
+		}
+		Node* c = constantNode(name);
+		if(c != nullptr)
+			return c;
+		if(lower == "true" || lower == "false") {
+			Node* n = newNode(Node::constant);
+			n->value = makeScalar(Value::boolean, lower == "true" ? 1 : 0);
+			return n;
+		}
+		auto f = functions.find(lower);
+		if(f != functions.end()) {
+			if(p.isSymbol("'")) // qualified expression, such as unsigned'("0101")
+				p.next();
+			Node* n = newNode(Node::call);
+			n->name = lower;
+			n->function = f->second;
+			p.expectSymbol("(");
+			n->args.push_back(parseExpression(p));
+			while(p.isSymbol(",")) {
+				p.next();
+				n->args.push_back(parseExpression(p));
+			}
+			p.expectSymbol(")");
+			return n;
+		}
+		SIMERROR("unknown identifier " << name);
+	}
+
+
+
+	void SimulationModel::collectSignals(Node* n, vector<int>& combinational, vector<int>& registered) {
+		if(n == nullptr)
+			return;
+		if(n->op == Node::signal || n->op == Node::index || n->op == Node::slice)
+			(n->delay == 0 ? combinational : registered).push_back(n->sig);
+		for(auto a: n->args)
+			collectSignals(a, combinational, registered);
+	}
+
+
+	void SimulationModel::buildEvaluationOrder() {
+		// Units are the signals, then the instances. A signal depends on the signals read by its drivers,
+		// on the instances driving it, and on its predecessors in the signal graph of the operator.
+		// What is read through a register (X_dN, or a predecessor edge with a delay) is the value
+		// of a previous cycle: it must be simulated, but does not constrain the order within a cycle.
+		int nSignals = signals.size();
+		int nUnits = nSignals + instances.size();
+		vector<vector<int>> dependencies(nUnits);
+		vector<vector<int>> registered(nUnits);
+		vector<char> isInput(nSignals, 0);
+		for(int s: inputIndex)
+			isInput[s] = 1;
+		map<Signal*, int> numbers;
+		for(int s = 0; s < nSignals; s++)
+			numbers[signals[s]] = s;
+		for(int s = 0; s < nSignals; s++) {
+			for(auto& d: drivers[s]) {
+				collectSignals(d.high, dependencies[s], registered[s]);
+				collectSignals(d.low, dependencies[s], registered[s]);
+				collectSignals(d.value, dependencies[s], registered[s]);
+				if(d.selected >= 0) {
+					SelectedAssignment& sa = selectedAssignments[d.selected];
+					collectSignals(sa.selector, dependencies[s], registered[s]);
+					collectSignals(sa.others, dependencies[s], registered[s]);
+					for(auto& c: sa.choices) {
+						collectSignals(c.first, dependencies[s], registered[s]);
+						collectSignals(c.second, dependencies[s], registered[s]);
+					}
+				}
+				if(d.instance >= 0)
+					dependencies[s].push_back(nSignals + d.instance);
+			}
+			if(drivers[s].empty())
+				continue;
+			// the predecessors that are simulated here (the actuals of instances belong to the parent operator)
+			for(auto& pred: *signals[s]->predecessors()) {
+				auto it = numbers.find(pred.first);
+				if(it != numbers.end() && (isInput[it->second] || !drivers[it->second].empty()))
+					(pred.second == 0 ? dependencies[s] : registered[s]).push_back(it->second);
+			}
+		}
+		for(size_t i = 0; i < instances.size(); i++)
+			for(auto a: instances[i].inputs)
+				collectSignals(a, dependencies[nSignals + i], registered[nSignals + i]);
+
+		auto unitName = [&](int u) {
+			return (u < nSignals ? "signal " + signals[u]->getName() : "instance " + instances[u-nSignals].name);
+		};
+
+		// Only what the outputs depend on is simulated
+		vector<char> needed(nUnits, 0);
+		vector<int> stack;
+		for(int s: outputIndex) {
+			if(!needed[s]) {
+				needed[s] = 1;
+				stack.push_back(s);
+			}
+		}
+		while(!stack.empty()) {
+			int u = stack.back();
+			stack.pop_back();
+			for(auto uses: {&dependencies[u], &registered[u]}) {
+				for(int v: *uses) {
+					if(needed[v])
+						continue;
+					if(v < nSignals && !isInput[v] && drivers[v].empty())
+						SIMERROR("signal " << signals[v]->getName() << " is used but never assigned");
+					needed[v] = 1;
+					stack.push_back(v);
+				}
+			}
+		}
+
+		// Kahn's algorithm on the successors of each unit, the inputs being available from the start
+		auto isSource = [&](int u) {
+			return u < nSignals && isInput[u];
+		};
+		vector<vector<int>> successors(nUnits);
+		vector<int> pending(nUnits, 0);
+		for(int u = 0; u < nUnits; u++) {
+			if(!needed[u] || isSource(u))
+				continue;
+			sort(dependencies[u].begin(), dependencies[u].end());
+			dependencies[u].erase(unique(dependencies[u].begin(), dependencies[u].end()), dependencies[u].end());
+			for(int v: dependencies[u]) {
+				if(!isSource(v)) {
+					successors[v].push_back(u);
+					pending[u]++;
+				}
+			}
+		}
+		priority_queue<int, vector<int>, greater<int>> ready; // lowest number first, for a deterministic order
+		for(int u = 0; u < nUnits; u++)
+			if(needed[u] && !isSource(u) && pending[u] == 0)
+				ready.push(u);
+		while(!ready.empty()) {
+			int u = ready.top();
+			ready.pop();
+			evaluationOrder.push_back(u);
+			for(int v: successors[u])
+				if(--pending[v] == 0)
+					ready.push(v);
+		}
+		for(int u = 0; u < nUnits; u++)
+			if(pending[u] > 0)
+				SIMERROR("combinational loop through " << unitName(u));
+	}
+
+
+
+	int SimulationModel::allocate(int width) {
+		int slot = frame.size();
+		frame.resize(slot + wordCount(width), 0);
+		constantSlot.resize(frame.size(), 0);
+		return slot;
+	}
+
+
+	Operand SimulationModel::temporary(Type t) {
+		return {t, allocate(storedWidth(t))};
+	}
+
+
+	int SimulationModel::message(string m) {
+		messages.push_back(m);
+		return messages.size()-1;
+	}
+
+
+	void SimulationModel::emit(Instr i, bool foldable) {
+		// an instruction on constants into a new temporary is computed now, once and for all
+		if(foldable && (i.a < 0 || constantSlot[i.a]) && (i.b < 0 || constantSlot[i.b])) {
+			try {
+				apply(i);
+				constantSlot[i.dst] = 1;
+				return;
+			} catch(string&) {
+				// left to the program, which raises the error only if this code is reached
+			}
+		}
+		program.push_back(i);
+	}
+
+
+	bool SimulationModel::isConstant(Node* n) {
+		if(n->op == Node::constant || n->op == Node::namedConstant)
+			return true;
+		if(n->op == Node::signal || n->op == Node::index || n->op == Node::slice)
+			return false;
+		for(auto a: n->args)
+			if(!isConstant(a))
+				return false;
+		return true;
+	}
+
+
+	Operand SimulationModel::constantOperand(const Value& v) {
+		Operand x = temporary(v.kind == Value::bits ? bitsType(v.width, v.isSigned, v.untyped) : scalarType(v.kind));
+		if(v.kind == Value::integer) {
+			if(!v.v.fits_slong_p())
+				SIMERROR("integer " << v.v << " is too large");
+			frame[x.slot] = (uint64_t)v.v.get_si();
+		}
+		else
+			mpz_export(&frame[x.slot], nullptr, -1, sizeof(uint64_t), 0, 0, v.v.get_mpz_t());
+		constantSlot[x.slot] = 1;
+		return x;
+	}
+
+
+	Operand SimulationModel::toBits(Operand x, int w, bool isSigned) {
+		if(x.t.kind == Value::bit)
+			return {bitsType(1, isSigned, true), x.slot};
+		if(x.t.kind != Value::fill)
+			return x;
+		Operand r = temporary(bitsType(w, isSigned, true));
+		emit(makeInstr(Opcode::Fill, r.slot, w, x.slot, 1));
+		return r;
+	}
+
+
+	Operand SimulationModel::extended(Operand x, int w, bool isSigned) {
+		if(x.t.kind == Value::bits && x.t.width == w)
+			return x;
+		Operand r = temporary(bitsType(w, false));
+		emit(makeInstr(Opcode::Extend, r.slot, w, x.slot, storedWidth(x.t), isSigned));
+		return r;
+	}
+
+
+	Operand SimulationModel::toInteger(Operand x) {
+		if(x.t.kind == Value::integer)
+			return x;
+		int w = storedWidth(x.t);
+		if(w > 64)
+			SIMERROR("conversion to integer of a vector of " << w << " bits");
+		Operand r = temporary(scalarType(Value::integer));
+		emit(makeInstr(Opcode::ToInt, r.slot, 64, x.slot, w, numericSigned(x.t)));
+		return r;
+	}
+
+
+	int64_t SimulationModel::constantInteger(Node* n, string what) {
+		Operand x = toInteger(compile(n));
+		if(!constantSlot[x.slot])
+			SIMERROR(what << " should be constant");
+		return (int64_t)frame[x.slot];
+	}
+
+
+	Operand SimulationModel::signalOperand(int s, int delay) {
+		if(delay == 0)
+			return {signalTypes[s], signalSlots[s]};
+		// the registers of the delayed versions of s, up to this one
+		while((int)history[s].size() < delay)
+			history[s].push_back(allocate(storedWidth(signalTypes[s])));
+		return {signalTypes[s], history[s][delay-1]};
+	}
+
+
+	Operand SimulationModel::compile(Node* n) {
+		switch(n->op) {
+		case Node::constant:
+			return constantOperand(n->value);
+		case Node::namedConstant: {
+			auto it = compiledConstants.find(n);
+			if(it != compiledConstants.end())
+				return it->second;
+			Operand x = compile(n->args[0]);
+			if(!constantSlot[x.slot])
+				SIMERROR("the value of constant " << n->name << " could not be computed");
+			if(x.t.kind == Value::bits) {
+				x.t.untyped = false;
+				x.t.isSigned = n->value.isSigned;
+			}
+			compiledConstants[n] = x;
+			return x;
+		}
+		case Node::signal:
+			return signalOperand(n->sig, n->delay);
+		case Node::index: {
+			Operand x = signalOperand(n->sig, n->delay);
+			string name = signals[n->sig]->getName();
+			if(x.t.kind != Value::bits)
+				SIMERROR("index of " << name << ", which is not a vector");
+			Operand i = toInteger(compile(n->args[0]));
+			Operand r = temporary(scalarType(Value::bit));
+			int64_t k = (int64_t)frame[i.slot];
+			if(constantSlot[i.slot] && k >= 0 && k < x.t.width)
+				emit(makeInstr(Opcode::Extract, r.slot, 1, x.slot, x.t.width, false, -1, 0, false, k));
+			else
+				emit(makeInstr(Opcode::ExtractDyn, r.slot, 1, x.slot, x.t.width, false, i.slot, 64, true, message(name)));
+			return r;
+		}
+		case Node::slice: {
+			Operand x = signalOperand(n->sig, n->delay);
+			string name = signals[n->sig]->getName();
+			if(x.t.kind != Value::bits)
+				SIMERROR("slice of " << name << ", which is not a vector");
+			int64_t h = constantInteger(n->args[0], "the bounds of a slice of " + name);
+			int64_t l = constantInteger(n->args[1], "the bounds of a slice of " + name);
+			Operand r = temporary(bitsType(std::max(h-l+1, (int64_t)0), x.t.isSigned));
+			if(l < 0 || h >= x.t.width) {
+				ostringstream o;
+				o << "ERROR in BitAccurateSimulator: slice (" << h << " downto " << l << ") out of the range of " << name;
+				emit(makeInstr(Opcode::Error, r.slot, 0, -1, 0, false, -1, 0, false, message(o.str())), false);
+			}
+			else
+				emit(makeInstr(Opcode::Extract, r.slot, r.t.width, x.slot, x.t.width, false, -1, 0, false, l));
+			return r;
+		}
+		case Node::unary: {
+			Operand x = compile(n->args[0]);
+			switch(n->operation) {
+			case Operation::Add:
+				return x;
+			case Operation::Not: {
+				Operand r = temporary(x.t);
+				if(x.t.kind == Value::integer) // 1 - v, like for bits and booleans
+					emit(makeInstr(Opcode::IntSub, r.slot, 64, constantOperand(makeScalar(Value::integer, 1)).slot, 64, true, x.slot, 64, true));
+				else
+					emit(makeInstr(Opcode::Not, r.slot, storedWidth(x.t), x.slot, storedWidth(x.t)));
+				return r;
+			}
+			case Operation::Sub:
+			case Operation::Abs: {
+				bool minus = (n->operation == Operation::Sub);
+				if(x.t.kind == Value::integer) {
+					Operand r = temporary(x.t);
+					emit(makeInstr(minus ? Opcode::IntNeg : Opcode::IntAbs, r.slot, 64, x.slot, 64, true));
+					return r;
+				}
+				int w = x.t.width;
+				Operand e = extended(x, w, numericSigned(x.t));
+				Operand r = temporary(bitsType(w, x.t.isSigned, x.t.untyped));
+				emit(makeInstr(minus ? Opcode::Neg : Opcode::Abs, r.slot, w, e.slot, w, numericSigned(x.t)));
+				return r;
+			}
+			default:
+				SIMERROR("unsupported unary operator " << n->name);
+			}
+		}
+		case Node::binary: {
+			Operand a = compile(n->args[0]);
+			Operand b = compile(n->args[1]);
+			return compileBinary(n, a, b);
+		}
+		case Node::call:
+			return compileCall(n);
+		case Node::conditional:
+			SIMERROR("conditional expression outside of an assignment");
+		case Node::fill: {
+			Operand x = compile(n->args[0]);
+			return {scalarType(Value::fill), x.slot};
+		}
+		case Node::rangeFill: {
+			int64_t h = constantInteger(n->args[0], "the bounds of an aggregate");
+			int64_t l = constantInteger(n->args[1], "the bounds of an aggregate");
+			Operand x = compile(n->args[2]);
+			int w = std::max(h-l+1, (int64_t)0);
+			Operand r = temporary(bitsType(w, slvSigned, true));
+			emit(makeInstr(Opcode::Fill, r.slot, w, x.slot, 1));
+			return r;
+		}
+		}
+		SIMERROR("unknown expression node");
+	}
+
+
+	Operand SimulationModel::compileBinary(Node* n, Operand a, Operand b) {
+		// (others => b) takes the width of the other operand, and literals its signedness
+		if(a.t.kind == Value::fill && b.t.kind == Value::bits)
+			a = toBits(a, b.t.width, b.t.isSigned);
+		if(b.t.kind == Value::fill && a.t.kind == Value::bits)
+			b = toBits(b, a.t.width, a.t.isSigned);
+		if(a.t.kind == Value::bits && b.t.kind == Value::bits) {
+			if(a.t.untyped && !b.t.untyped)
+				a.t.isSigned = b.t.isSigned;
+			if(b.t.untyped && !a.t.untyped)
+				b.t.isSigned = a.t.isSigned;
+		}
+		bool aBits = (a.t.kind == Value::bits), bBits = (b.t.kind == Value::bits);
+		bool isSigned = (aBits && a.t.isSigned) || (bBits && b.t.isSigned);
+		Operation o = n->operation;
+
+		switch(o) {
+		case Operation::And: case Operation::Or: case Operation::Xor:
+		case Operation::Nand: case Operation::Nor: case Operation::Xnor: {
+			Opcode code = (o == Operation::And || o == Operation::Nand ? Opcode::And : (o == Operation::Or || o == Operation::Nor ? Opcode::Or : Opcode::Xor));
+			bool negate = (o == Operation::Nand || o == Operation::Nor || o == Operation::Xnor);
+			Type t = a.t;
+			int w = 1;
+			if(aBits || bBits) {
+				w = std::max(a.t.width, b.t.width);
+				t = bitsType(w, aBits && !a.t.untyped ? a.t.isSigned : isSigned, a.t.untyped && b.t.untyped);
+				a = extended(a, w, false);
+				b = extended(b, w, false);
+			}
+			Operand r = temporary(t);
+			emit(makeInstr(code, r.slot, w, a.slot, w, false, b.slot, w));
+			if(!negate)
+				return r;
+			Operand nr = temporary(t);
+			emit(makeInstr(Opcode::Not, nr.slot, w, r.slot, w));
+			return nr;
+		}
+
+		case Operation::Eq: case Operation::Ne: case Operation::Lt:
+		case Operation::Le: case Operation::Gt: case Operation::Ge: {
+			static const map<Operation, Opcode> comparisons = {
+				{Operation::Eq, Opcode::CmpEq}, {Operation::Ne, Opcode::CmpNe}, {Operation::Lt, Opcode::CmpLt},
+				{Operation::Le, Opcode::CmpLe}, {Operation::Gt, Opcode::CmpGt}, {Operation::Ge, Opcode::CmpGe}};
+			Operand r = temporary(scalarType(Value::boolean));
+			emit(makeInstr(comparisons.at(o), r.slot, 1, a.slot, storedWidth(a.t), numericSigned(a.t), b.slot, storedWidth(b.t), numericSigned(b.t)));
+			return r;
+		}
+
+		case Operation::Concat: {
+			Operand x = toBits(a, a.t.width, a.t.isSigned);
+			Operand y = toBits(b, b.t.width, b.t.isSigned);
+			if(x.t.kind != Value::bits || y.t.kind != Value::bits)
+				SIMERROR("concatenation of a value that is not a bit or a vector");
+			int w = x.t.width + y.t.width;
+			Operand r = temporary(bitsType(w, !x.t.untyped ? x.t.isSigned : (!y.t.untyped ? y.t.isSigned : slvSigned), x.t.untyped && y.t.untyped));
+			emit(makeInstr(Opcode::Concat, r.slot, w, x.slot, x.t.width, false, y.slot, y.t.width));
+			return r;
+		}
+
+		default:
+			break;
+		}
+
+		if(a.t.kind == Value::integer && b.t.kind == Value::integer) {
+			static const map<Operation, Opcode> integerOperations = {
+				{Operation::Add, Opcode::IntAdd}, {Operation::Sub, Opcode::IntSub}, {Operation::Mul, Opcode::IntMul}, {Operation::Pow, Opcode::IntPow},
+				{Operation::Div, Opcode::IntDiv}, {Operation::Rem, Opcode::IntRem}, {Operation::Mod, Opcode::IntMod}};
+			auto it = integerOperations.find(o);
+			if(it == integerOperations.end())
+				SIMERROR("unsupported operator " << n->name << " on integers");
+			Operand r = temporary(scalarType(Value::integer));
+			emit(makeInstr(it->second, r.slot, 64, a.slot, 64, true, b.slot, 64, true));
+			return r;
+		}
+
+		if(o == Operation::Sll || o == Operation::Srl || o == Operation::Sla || o == Operation::Sra) {
+			if(!aBits && a.t.kind != Value::bit)
+				SIMERROR("shift of a value that is not a vector");
+			Operand amount = toInteger(b);
+			int w = a.t.width;
+			Operand r = temporary(bitsType(w, a.t.isSigned));
+			Opcode code = (o == Operation::Sll || o == Operation::Sla ? Opcode::Shl : (o == Operation::Sra ? Opcode::Sra : Opcode::Shr));
+			emit(makeInstr(code, r.slot, w, a.slot, w, aBits && a.t.isSigned, amount.slot, 64, true));
+			return r;
+		}
+
+		// Vector arithmetic: the result has the width of the widest vector operand (the sum of the widths for *)
+		int wa = (aBits ? a.t.width : 0);
+		int wb = (bBits ? b.t.width : 0);
+		switch(o) {
+		case Operation::Add:
+		case Operation::Sub:
+		case Operation::Mul: {
+			int w = (o == Operation::Mul ? (wa > 0 && wb > 0 ? wa + wb : 2*std::max(wa, wb)) : std::max(max(wa, wb), 1));
+			Operand x = extended(a, w, numericSigned(a.t));
+			Operand y = extended(b, w, numericSigned(b.t));
+			Operand r = temporary(bitsType(w, isSigned));
+			emit(makeInstr(o == Operation::Add ? Opcode::Add : (o == Operation::Sub ? Opcode::Sub : Opcode::Mul), r.slot, w, x.slot, w, false, y.slot, w));
+			return r;
+		}
+		case Operation::Div:
+		case Operation::Rem:
+		case Operation::Mod: {
+			if(storedWidth(a.t) > 64 || storedWidth(b.t) > 64)
+				SIMERROR("operator " << n->name << " on more than 64 bits is not supported");
+			int w = std::max(wa, wb);
+			Operand r = temporary(bitsType(w, isSigned));
+			emit(makeInstr(o == Operation::Div ? Opcode::Div : (o == Operation::Rem ? Opcode::Rem : Opcode::Mod), r.slot, w,
+			               a.slot, storedWidth(a.t), numericSigned(a.t), b.slot, storedWidth(b.t), numericSigned(b.t)));
+			return r;
+		}
+		default:
+			SIMERROR("unsupported operator " << n->name);
+		}
+	}
+
+
+	Operand SimulationModel::compileCall(Node* n) {
+		Function f = n->function;
+		bool conversion = (f == Function::Unsigned || f == Function::Signed || f == Function::StdLogicVector || f == Function::ToInteger);
+		size_t arity = (conversion ? 1 : 2);
+		if(n->args.size() != arity)
+			SIMERROR(n->name << " expects " << arity << " argument(s), got " << n->args.size());
+		Operand x = compile(n->args[0]);
+		bool xBits = (x.t.kind == Value::bits);
+
+		if(conversion) {
+			if(f == Function::ToInteger)
+				return toInteger(x);
+			// type conversions keep the bits
+			if(x.t.kind == Value::fill)
+				return x;
+			if(!xBits && x.t.kind != Value::bit)
+				SIMERROR(n->name << " of a value that is not a vector");
+			return {bitsType(x.t.width, f == Function::Signed || (f != Function::Unsigned && slvSigned)), x.slot};
+		}
+
+		if(f == Function::ShiftLeft || f == Function::ShiftRight) {
+			if(!xBits && x.t.kind != Value::bit)
+				SIMERROR(n->name << " of a value that is not a vector");
+			Operand amount = toInteger(compile(n->args[1]));
+			int w = x.t.width;
+			Operand r = temporary(bitsType(w, x.t.isSigned));
+			emit(makeInstr(f == Function::ShiftLeft ? Opcode::Shl : Opcode::Sra, r.slot, w, x.slot, w, xBits && x.t.isSigned, amount.slot, 64, true));
+			return r;
+		}
+
+		int64_t size = constantInteger(n->args[1], "the size argument of " + n->name);
+		if(size < 0)
+			SIMERROR("negative size " << size << " in " << n->name);
+		int w = size;
+		if(f == Function::Resize && xBits && x.t.isSigned && w < x.t.width && w > 0) { // numeric_std keeps the sign bit
+			Operand sign = temporary(bitsType(1, false));
+			emit(makeInstr(Opcode::Extract, sign.slot, 1, x.slot, x.t.width, false, -1, 0, false, x.t.width-1));
+			Operand low = temporary(bitsType(w-1, false));
+			emit(makeInstr(Opcode::Extract, low.slot, w-1, x.slot, x.t.width, false, -1, 0, false, 0));
+			Operand r = temporary(bitsType(w, true));
+			emit(makeInstr(Opcode::Concat, r.slot, w, sign.slot, 1, false, low.slot, w-1));
+			return r;
+		}
+		if(f == Function::Ext) {
+			Operand r = temporary(bitsType(w, slvSigned));
+			emit(makeInstr(Opcode::Extend, r.slot, w, x.slot, storedWidth(x.t), x.t.kind == Value::integer));
+			return r;
+		}
+		bool isSigned = (f == Function::ToSigned || f == Function::ConvSigned || f == Function::Sxt || (f == Function::Resize && xBits && x.t.isSigned) || (f == Function::ConvStdLogicVector && slvSigned));
+		Operand r = temporary(bitsType(w, isSigned));
+		emit(makeInstr(Opcode::Extend, r.slot, w, x.slot, storedWidth(x.t), numericSigned(x.t) || (f == Function::Sxt && xBits)));
+		return r;
+	}
+
+
+	void SimulationModel::store(Operand x, int slot, int w, bool foldable) {
+		if(x.t.kind == Value::fill)
+			emit(makeInstr(Opcode::Fill, slot, w, x.slot, 1), foldable);
+		else
+			emit(makeInstr(Opcode::Extend, slot, w, x.slot, storedWidth(x.t), x.t.kind == Value::integer), foldable);
+	}
+
+
+	void SimulationModel::compileWaveform(Node* n, int slot, int w) {
+		if(n->op != Node::conditional) {
+			store(compile(n), slot, w, false);
+			return;
+		}
+		vector<size_t> jumpsToEnd;
+		bool done = false;
+		for(size_t i = 0; i+1 < n->args.size() && !done; i += 2) {
+			Operand c = compile(n->args[i+1]);
+			if(c.t.kind != Value::boolean && c.t.kind != Value::bit)
+				SIMERROR("a condition should be a boolean or a std_logic");
+			if(constantSlot[c.slot]) {
+				if(frame[c.slot] != 0) {
+					store(compile(n->args[i]), slot, w, false);
+					done = true;
+				}
+				continue;
+			}
+			size_t skip = program.size();
+			emit(makeInstr(Opcode::JumpIfZero, -1, 0, c.slot), false);
+			store(compile(n->args[i]), slot, w, false);
+			jumpsToEnd.push_back(program.size());
+			emit(makeInstr(Opcode::Jump, -1, 0), false);
+			program[skip].imm = program.size();
+		}
+		if(!done)
+			store(compile(n->args.back()), slot, w, false);
+		for(size_t j: jumpsToEnd)
+			program[j].imm = program.size();
+	}
+
+
+	void SimulationModel::compileSelected(SelectedAssignment& sa, int slot, int w) {
+		Operand selector = compile(sa.selector);
+		int keyWidth = storedWidth(selector.t);
+		int keyWords = wordCount(keyWidth);
+
+		// the choices that are constants are looked up directly: this is how tables are simulated
+		vector<pair<vector<uint64_t>, Node*>> constantChoices;
+		vector<pair<Operand, Node*>> otherChoices;
+		for(auto& c: sa.choices) {
+			if(!isConstant(c.first)) {
+				otherChoices.push_back(make_pair(compile(c.first), c.second));
+				continue;
+			}
+			Operand x = compile(c.first);
+			if(x.t.kind == Value::integer && (int64_t)frame[x.slot] < 0 && selector.t.kind != Value::integer)
+				continue; // never equal to the bits of the selector
+			int n = wordCount(storedWidth(x.t));
+			vector<uint64_t> key(frame.begin() + x.slot, frame.begin() + x.slot + n);
+			bool fits = true;
+			for(int k = keyWords; k < n; k++)
+				fits = fits && (key[k] == 0);
+			key.resize(keyWords, 0);
+			fits = fits && (key.back() & ~lowMask(keyWidth - 64*(keyWords-1))) == 0;
+			if(fits)
+				constantChoices.push_back(make_pair(key, c.second));
+		}
+
+		// the value of each choice, converted to the width of the target
+		map<Node*, int> convertedConstants;
+		auto convertedConstant = [&](Node* v) {
+			auto it = convertedConstants.find(v);
+			if(it != convertedConstants.end())
+				return it->second;
+			Operand x = compile(v);
+			int r = allocate(w);
+			store(x, r, w, true);
+			convertedConstants[v] = r;
+			return r;
+		};
+
+		bool allConstant = otherChoices.empty() && (sa.others == nullptr || isConstant(sa.others))
+			&& (selector.t.kind == Value::bits || selector.t.kind == Value::bit) && keyWidth <= 16;
+		for(auto& c: constantChoices)
+			allConstant = allConstant && isConstant(c.second);
+		if(allConstant) {
+			vector<int> table(size_t(1) << keyWidth, sa.others == nullptr ? -1 : convertedConstant(sa.others));
+			vector<char> chosen(table.size(), 0);
+			for(auto& c: constantChoices) {
+				uint64_t k = c.first[0];
+				if(!chosen[k]) {
+					table[k] = convertedConstant(c.second);
+					chosen[k] = 1;
+				}
+			}
+			lookupTables.push_back(table);
+			emit(makeInstr(Opcode::Lookup, slot, w, selector.slot, keyWidth, false, -1, 0, false, lookupTables.size()-1), false);
+			return;
+		}
+
+		size_t switchTable = switchTables.size();
+		switchTables.push_back(SwitchTable());
+		emit(makeInstr(Opcode::Switch, -1, 0, selector.slot, keyWidth, false, -1, 0, false, switchTable), false);
+		vector<pair<size_t, Node*>> choiceJumps;
+		for(auto& c: otherChoices) {
+			Operand differs = temporary(scalarType(Value::boolean));
+			emit(makeInstr(Opcode::CmpNe, differs.slot, 1, selector.slot, keyWidth, selector.t.kind == Value::integer, c.first.slot, storedWidth(c.first.t), c.first.t.kind == Value::integer));
+			choiceJumps.push_back(make_pair(program.size(), c.second));
+			emit(makeInstr(Opcode::JumpIfZero, -1, 0, differs.slot), false);
+		}
+		vector<size_t> jumpsToEnd;
+		if(sa.others != nullptr)
+			store(compile(sa.others), slot, w, false);
+		else
+			emit(makeInstr(Opcode::NoChoice, -1, 0, selector.slot, keyWidth), false);
+		jumpsToEnd.push_back(program.size());
+		emit(makeInstr(Opcode::Jump, -1, 0), false);
+
+		map<Node*, int64_t> branches;
+		auto branch = [&](Node* v) {
+			auto it = branches.find(v);
+			if(it != branches.end())
+				return it->second;
+			int64_t start = program.size();
+			store(compile(v), slot, w, false);
+			jumpsToEnd.push_back(program.size());
+			emit(makeInstr(Opcode::Jump, -1, 0), false);
+			branches[v] = start;
+			return start;
+		};
+		SwitchTable& t = switchTables[switchTable];
+		for(auto& c: constantChoices) {
+			int64_t target = branch(c.second);
+			if(keyWidth <= 64)
+				t.targets.emplace(c.first[0], target);
+			else
+				t.wideTargets.emplace(c.first, target);
+		}
+		for(auto& j: choiceJumps)
+			program[j.first].imm = branch(j.second);
+		for(size_t j: jumpsToEnd)
+			program[j].imm = program.size();
+	}
+
+
+	void SimulationModel::compileDriver(Driver& d, int slot, int w) {
+		if(d.instance >= 0) {
+			Instance& inst = instances[d.instance];
+			SimulationModel* m = inst.model;
+			store({m->signalTypes[m->outputIndex[d.port]], inst.outputSlots[d.port]}, slot, w, false);
+		}
+		else if(d.selected >= 0)
+			compileSelected(selectedAssignments[d.selected], slot, w);
+		else
+			compileWaveform(d.value, slot, w);
+	}
+
+
+	void SimulationModel::compileSignal(int s) {
+		int slot = signalSlots[s];
+		int w = storedWidth(signalTypes[s]);
+		vector<Driver>& ds = drivers[s];
+		if(ds.size() != 1 || ds[0].high != nullptr)
+			emit(makeInstr(Opcode::Clear, slot, w), false);
+		for(auto& d: ds) {
+			if(d.high == nullptr) {
+				compileDriver(d, slot, w);
+				continue;
+			}
+			string name = signals[s]->getName();
+			int64_t h = constantInteger(d.high, "the bounds of an assignment to " + name);
+			int64_t l = constantInteger(d.low, "the bounds of an assignment to " + name);
+			if(l < 0 || h >= w || h < l)
+				SIMERROR("assignment to (" << h << " downto " << l << ") out of the range of " << name);
+			int part = allocate(h-l+1);
+			compileDriver(d, part, h-l+1);
+			emit(makeInstr(Opcode::Insert, slot, h-l+1, part, h-l+1, false, -1, 0, false, l), false);
+		}
+	}
+
+
+	void SimulationModel::compileInstance(int i) {
+		Instance& inst = instances[i];
+		SimulationModel* m = inst.model;
+		for(size_t k = 0; k < inst.inputs.size(); k++) {
+			if(inst.inputs[k] == nullptr)
+				SIMERROR("input " << m->inputs[k]->getName() << " of instance " << inst.name << " is not connected");
+			int w = storedWidth(m->signalTypes[m->inputIndex[k]]);
+			int slot = allocate(w);
+			store(compile(inst.inputs[k]), slot, w, true);
+			inst.inputSlots.push_back(slot);
+		}
+		for(int s: m->outputIndex)
+			inst.outputSlots.push_back(allocate(storedWidth(m->signalTypes[s])));
+		emit(makeInstr(Opcode::Call, -1, 0, -1, 0, false, -1, 0, false, i), false);
+	}
+
+
+	void SimulationModel::compileProgram() {
+		for(auto sig: signals) {
+			if(sig->width() == 1 && !sig->isBus())
+				signalTypes.push_back(scalarType(Value::bit));
+			else
+				signalTypes.push_back(bitsType(sig->width(), sig->isFix() ? sig->isSigned() : slvSigned));
+			signalSlots.push_back(allocate(storedWidth(signalTypes.back())));
+		}
+		history.resize(signals.size());
+		int nSignals = signals.size();
+		for(int u: evaluationOrder) {
+			if(u < nSignals)
+				compileSignal(u);
+			else
+				compileInstance(u - nSignals);
+		}
+		// each register takes the value of the previous one, the oldest first
+		for(int s = 0; s < nSignals; s++) {
+			int words = wordCount(storedWidth(signalTypes[s]));
+			for(int d = history[s].size()-1; d >= 0; d--)
+				registerCopies.push_back({history[s][d], d > 0 ? history[s][d-1] : signalSlots[s], words});
+		}
+	}
+
+
+
+	void SimulationModel::apply(const Instr& i) {
+		uint64_t* f = frame.data();
+		uint64_t* d = f + i.dst;
+		const uint64_t* a = f + std::max(i.a, 0);
+		const uint64_t* b = f + std::max(i.b, 0);
+		int n = wordCount(i.w);
+		bool small = (i.w <= 64);
+		switch(i.op) {
+		case Opcode::Clear:
+			std::fill(d, d+n, 0);
+			break;
+		case Opcode::Extend:
+			if(small && i.wa <= 64) {
+				uint64_t v = a[0];
+				if(i.sa && i.wa > 0 && i.wa < 64 && ((v >> (i.wa-1)) & 1))
+					v |= ~lowMask(i.wa);
+				d[0] = v & i.mask;
+			}
+			else
+				extend(d, i.w, a, i.wa, i.sa);
+			break;
+		case Opcode::Fill:
+			std::fill(d, d+n, a[0] != 0 ? ~uint64_t(0) : 0);
+			maskTop(d, i.w);
+			break;
+		case Opcode::Not:
+			for(int k = 0; k < n; k++)
+				d[k] = ~a[k];
+			maskTop(d, i.w);
+			break;
+		case Opcode::And:
+			for(int k = 0; k < n; k++)
+				d[k] = a[k] & b[k];
+			break;
+		case Opcode::Or:
+			for(int k = 0; k < n; k++)
+				d[k] = a[k] | b[k];
+			break;
+		case Opcode::Xor:
+			for(int k = 0; k < n; k++)
+				d[k] = a[k] ^ b[k];
+			break;
+		case Opcode::Add:
+		case Opcode::Sub:
+			if(small)
+				d[0] = (i.op == Opcode::Add ? a[0] + b[0] : a[0] - b[0]) & i.mask;
+			else
+				add(d, a, b, i.w, i.op == Opcode::Sub);
+			break;
+		case Opcode::Neg:
+			if(small)
+				d[0] = (0 - a[0]) & i.mask;
+			else
+				negate(d, a, i.w);
+			break;
+		case Opcode::Abs:
+			if(i.sa && i.w > 0 && testBit(a, i.w-1))
+				negate(d, a, i.w);
+			else
+				std::copy(a, a+n, d);
+			break;
+		case Opcode::Mul:
+			if(small)
+				d[0] = (a[0] * b[0]) & i.mask;
+			else
+				multiply(d, a, b, i.w);
+			break;
+		case Opcode::Div:
+		case Opcode::Rem:
+		case Opcode::Mod: {
+			__int128 x = toInt128(a, i.wa, i.sa), y = toInt128(b, i.wb, i.sb);
+			if(y == 0)
+				SIMERROR("division by zero");
+			__int128 r = (i.op == Opcode::Div ? x / y : x % y);
+			if(i.op == Opcode::Mod && r != 0 && ((r < 0) != (y < 0)))
+				r += y;
+			d[0] = (uint64_t)r & i.mask;
+			break;
+		}
+		case Opcode::CmpEq:
+		case Opcode::CmpNe:
+		case Opcode::CmpLt:
+		case Opcode::CmpLe:
+		case Opcode::CmpGt:
+		case Opcode::CmpGe: {
+			int c = compare(a, i.wa, i.sa, b, i.wb, i.sb);
+			bool r = (i.op == Opcode::CmpEq ? c == 0 : i.op == Opcode::CmpNe ? c != 0 : i.op == Opcode::CmpLt ? c < 0 : i.op == Opcode::CmpLe ? c <= 0 : i.op == Opcode::CmpGt ? c > 0 : c >= 0);
+			d[0] = r;
+			break;
+		}
+		case Opcode::Extract:
+			if(small)
+				d[0] = getWord(a, wordCount(i.wa), i.imm) & i.mask;
+			else
+				extract(d, i.w, a, i.wa, i.imm);
+			break;
+		case Opcode::ExtractDyn: {
+			int64_t k = (int64_t)b[0];
+			if(k < 0 || k >= i.wa)
+				SIMERROR("index " << k << " out of the range of " << messages[i.imm]);
+			d[0] = testBit(a, k);
+			break;
+		}
+		case Opcode::Insert:
+			deposit(d, i.imm, a, i.w);
+			break;
+		case Opcode::Concat:
+			if(small)
+				d[0] = (i.wb >= 64 ? b[0] : (a[0] << i.wb) | b[0]) & i.mask;
+			else {
+				deposit(d, 0, b, i.wb);
+				deposit(d, i.wb, a, i.wa);
+			}
+			break;
+		case Opcode::Shl:
+		case Opcode::Shr:
+		case Opcode::Sra: {
+			int64_t k = (int64_t)b[0];
+			if(k < 0)
+				SIMERROR("negative shift amount " << k);
+			bool arithmetic = (i.op == Opcode::Sra && i.sa);
+			if(small) {
+				uint64_t v = a[0];
+				if(arithmetic && i.w > 0 && ((v >> (i.w-1)) & 1))
+					v |= ~i.mask;
+				if(i.op == Opcode::Shl)
+					v = (k >= 64 ? 0 : v << k);
+				else if(arithmetic)
+					v = (uint64_t)((int64_t)v >> std::min(k, (int64_t)63));
+				else
+					v = (k >= 64 ? 0 : v >> k);
+				d[0] = v & i.mask;
+			}
+			else
+				shift(d, a, i.w, k, i.op != Opcode::Shl, arithmetic);
+			break;
+		}
+		case Opcode::IntAdd:
+			d[0] = a[0] + b[0];
+			break;
+		case Opcode::IntSub:
+			d[0] = a[0] - b[0];
+			break;
+		case Opcode::IntMul:
+			d[0] = a[0] * b[0];
+			break;
+		case Opcode::IntPow: {
+			int64_t e = (int64_t)b[0];
+			if(e < 0)
+				SIMERROR("negative exponent " << e);
+			uint64_t r = 1;
+			for(int64_t k = 0; k < e && r != 0; k++)
+				r *= a[0];
+			d[0] = r;
+			break;
+		}
+		case Opcode::IntDiv:
+		case Opcode::IntRem:
+		case Opcode::IntMod: {
+			__int128 x = (int64_t)a[0], y = (int64_t)b[0];
+			if(y == 0)
+				SIMERROR("division by zero");
+			__int128 r = (i.op == Opcode::IntDiv ? x / y : x % y);
+			if(i.op == Opcode::IntMod && r != 0 && ((r < 0) != (y < 0)))
+				r += y;
+			d[0] = (uint64_t)r;
+			break;
+		}
+		case Opcode::IntNeg:
+			d[0] = 0 - a[0];
+			break;
+		case Opcode::IntAbs:
+			d[0] = ((int64_t)a[0] < 0 ? 0 - a[0] : a[0]);
+			break;
+		case Opcode::ToInt:
+			d[0] = (uint64_t)toInt128(a, i.wa, i.sa);
+			break;
+		case Opcode::Lookup: {
+			int s = lookupTables[i.imm][a[0]];
+			if(s < 0)
+				SIMERROR("no choice for selector value " << a[0]);
+			std::copy(f+s, f+s+n, d);
+			break;
+		}
+		case Opcode::NoChoice:
+			SIMERROR("no choice for selector value " << toMpz(a, i.wa));
+		case Opcode::Call:
+			call(instances[i.imm]);
+			break;
+		case Opcode::Error:
+			throw messages[i.imm];
+		default:
+			SIMERROR("unexpected instruction");
+		}
+	}
+
+
+	void SimulationModel::call(Instance& inst) {
+		SimulationModel* m = inst.model;
+		for(size_t k = 0; k < inst.inputSlots.size(); k++) {
+			int s = m->inputIndex[k];
+			std::copy_n(&frame[inst.inputSlots[k]], wordCount(storedWidth(m->signalTypes[s])), &m->frame[m->signalSlots[s]]);
+		}
+		m->evaluate();
+		for(size_t k = 0; k < inst.outputSlots.size(); k++) {
+			int s = m->outputIndex[k];
+			std::copy_n(&m->frame[m->signalSlots[s]], wordCount(storedWidth(m->signalTypes[s])), &frame[inst.outputSlots[k]]);
+		}
+	}
+
+
+	void SimulationModel::clock() {
+		for(auto& r: registerCopies)
+			std::copy_n(&frame[r.src], r.words, &frame[r.dst]);
+		for(auto& i: instances)
+			i.model->clock();
+	}
+
+
+	void SimulationModel::evaluate() {
+		size_t n = program.size();
+		for(size_t pc = 0; pc < n; ) {
+			const Instr& i = program[pc++];
+			switch(i.op) {
+			case Opcode::Jump:
+				pc = i.imm;
+				break;
+			case Opcode::JumpIfZero:
+				if(frame[i.a] == 0)
+					pc = i.imm;
+				break;
+			case Opcode::Switch: {
+				SwitchTable& t = switchTables[i.imm];
+				if(i.wa <= 64) {
+					auto it = t.targets.find(frame[i.a]);
+					if(it != t.targets.end())
+						pc = it->second;
+				}
+				else {
+					auto it = t.wideTargets.find(vector<uint64_t>(&frame[i.a], &frame[i.a] + wordCount(i.wa)));
+					if(it != t.wideTargets.end())
+						pc = it->second;
+				}
+				break;
+			}
+			default:
+				apply(i);
+			}
+		}
+	}
+
+
+	void SimulationModel::setInput(int i, mpz_class v) {
+		int s = inputIndex[i];
+		int w = storedWidth(signalTypes[s]);
+		mpz_class bits = v & ones(w);
+		std::fill_n(&frame[signalSlots[s]], wordCount(w), 0);
+		mpz_export(&frame[signalSlots[s]], nullptr, -1, sizeof(uint64_t), 0, 0, bits.get_mpz_t());
+	}
+
+
+	mpz_class SimulationModel::getOutput(int i) {
+		int s = outputIndex[i];
+		return toMpz(&frame[signalSlots[s]], storedWidth(signalTypes[s]));
+	}
+
+
+
+
+	BitAccurateSimulator::BitAccurateSimulator(Operator *op_) :
+		op(op_)
+	{
+		model = new SimulationModel(op, models);
+		models[op] = model;
+	}
+
+
+	BitAccurateSimulator::~BitAccurateSimulator() {
+		for(auto& m: models)
+			delete m.second;
+	}
+
+
+	map<string, mpz_class> BitAccurateSimulator::simulate(map<string, mpz_class> inputs) {
+		for(size_t i = 0; i < model->inputs.size(); i++) {
+			string name = model->inputs[i]->getName();
+			auto it = inputs.find(name);
+			if(it == inputs.end())
+				SIMERROR("no value for input " << name);
+			model->setInput(i, it->second);
+		}
+		// the inputs are held until they reach the outputs
+		map<string, mpz_class> outputs;
+		for(int cycle = 0; cycle <= op->getPipelineDepth(); cycle++) {
+			model->evaluate();
+			if(cycle == op->getPipelineDepth())
+				for(size_t i = 0; i < model->outputs.size(); i++)
+					outputs[model->outputs[i]->getName()] = model->getOutput(i);
+			model->clock();
+		}
+		return outputs;
+	}
+
+
+	namespace {
+		/** What is needed to check the outputs of a test case, which may be deleted before they are computed */
+		struct ExpectedOutputs {
+			int id;
+			string description;
+			int64_t cycle;  /**< the cycle where the inputs were applied */
+			map<string, TestCase::OutputType> types;
+			map<string, vector<mpz_class>> values;
+
+			ExpectedOutputs(TestCase* tc, Operator* op, int64_t cycle_) :
+				id(tc->getId()), description(tc->getDescription()), cycle(cycle_)
+			{
+				for(auto s: op->getOutputList()) {
+					types[s->getName()] = tc->getOutputType(s->getName());
+					values[s->getName()] = tc->getExpectedOutputValues(s->getName());
+				}
+			}
+		};
+
+		/** Mirrors the comparisons of the VHDL TestBench: fp_equal for FloPoCo floating-point, fp_equal_ieee for IEEE */
+		bool outputMatches(Signal* s, mpz_class v, mpz_class e) {
+			if(s->isFP()) {
+				int w = s->width();
+				mpz_class exn = e >> (w-2);
+				if(exn == 1)
+					return v == e;
+				if(exn == 3)
+					return (v >> (w-2)) == 3;
+				return (v >> (w-3)) == (e >> (w-3));
+			}
+			if(s->isIEEE()) {
+				int wE = s->wE(), wF = s->wF();
+				if((v >> wF) == (e >> wF) && ((e >> wF) & ones(wE)) == ones(wE)) {
+					if((e & ones(wF)) == 0)
+						return (v & ones(wF)) == 0;
+					return (v & ones(wF)) != 0;
+				}
+			}
+			return v == e;
+		}
+
+		bool outputsMatch(Operator* op, ExpectedOutputs& expected, map<string, mpz_class>& outputs, string& report) {
+			ostringstream o;
+			bool success = true;
+			for(auto s: op->getOutputList()) {
+				string name = s->getName();
+				mpz_class v = outputs[name];
+				vector<mpz_class>& values = expected.values[name];
+				bool ok = false;
+				switch(expected.types[name]) {
+				case TestCase::list_of_values:
+					ok = values.empty();
+					for(auto e: values)
+						ok = ok || outputMatches(s, v, e);
+					break;
+				case TestCase::unsigned_interval:
+					ok = (v >= values[0] && v <= values[1]);
+					break;
+				case TestCase::signed_interval: {
+					mpz_class sv = signedValue(v, s->width());
+					ok = (sv >= values[0] && sv <= values[1]);
+					break;
+				}
+				default:
+					SIMERROR("unsupported type of expected output for " << name);
+				}
+				if(!ok) {
+					o << "  " << name << "=" << unsignedBinary(v, s->width()) << ", expected";
+					for(auto e: values)
+						o << " " << unsignedBinary(e, s->width());
+					o << endl;
+				}
+				success = success && ok;
+			}
+			if(!success)
+				report = "Test " + to_string(expected.id) + " failed: " + expected.description + "\n" + o.str();
+			return success;
+		}
+	}
+
+
+	bool BitAccurateSimulator::check(TestCase* tc, string& report) {
+		map<string, mpz_class> inputs;
+		for(auto s: op->getInputList())
+			inputs[s->getName()] = tc->getInputValue(s->getName());
+		map<string, mpz_class> outputs = simulate(inputs);
+		ExpectedOutputs expected(tc, op, 0);
+		return outputsMatch(op, expected, outputs, report);
+	}
+
+
+	int64_t BitAccurateSimulator::run(int64_t n) {
+		op->numberOfTests = n;
+		FloPoCoRandomState::init(n);
+		TestCaseList tcl;
+		int64_t failures = 0;
+		int64_t cycle = 0;
+		int depth = op->getPipelineDepth();
+		deque<ExpectedOutputs> inFlight;  // the test cases whose outputs are still in the pipeline
+
+		// one clock cycle: the outputs are those of the test case applied depth cycles ago
+		auto step = [&]() {
+			model->evaluate();
+			if(!inFlight.empty() && inFlight.front().cycle + depth == cycle) {
+				map<string, mpz_class> outputs;
+				for(size_t i = 0; i < model->outputs.size(); i++)
+					outputs[model->outputs[i]->getName()] = model->getOutput(i);
+				string report;
+				if(!outputsMatch(op, inFlight.front(), outputs, report)) {
+					failures++;
+					if(failures <= 10)
+						cerr << report;
+				}
+				inFlight.pop_front();
+			}
+			model->clock();
+			cycle++;
+		};
+		auto apply = [&](TestCase* tc) {
+			for(size_t i = 0; i < model->inputs.size(); i++)
+				model->setInput(i, tc->getInputValue(model->inputs[i]->getName()));
+			inFlight.emplace_back(tc, op, cycle);
+			step();
+		};
+
+		if( (n == -2) || ((n == -1) && (op->countInputBits() <= 16)) ) {
+			REPORT(LogLevel::MESSAGE, "Simulating the exhaustive test of " << op->getName());
+			// apply the test cases as they are built
+			ostringstream nothing;
+			tcl.streamTo(&nothing, [&](TestCase* tc) {
+					apply(tc);
+					return string();
+				});
+			n = op->buildExhaustiveTestCaseList(&tcl);
+			tcl.flush();
+		}
+		else {
+			if (n == -1) {
+				n=1000;
+			}
+			op->buildStandardTestCases(&tcl);
+			op->buildRandomTestCaseList(&tcl, n);
+			for(int i = 0; i < tcl.getNumberOfTestCases(); i++)
+				apply(tcl.getTestCase(i));
+		}
+		// flush the pipeline, the last inputs being held
+		while(!inFlight.empty())
+			step();
+		REPORT(LogLevel::MESSAGE, tcl.getNumberOfTestCases() << " test cases simulated, " << failures << " failed");
+		return failures;
+	}
+
+
+	OperatorPtr BitAccurateSimulator::parseArguments(OperatorPtr parentOp, Target *target, vector<string> &args, UserInterface& ui) {
+		int n;
+
+		if(ui.globalOpList.empty()){
+			throw(string("Simulate has no operator to simulate (it should come after the operator it simulates)"));
+		}
+
+		ui.parseInt(args, "n", &n);
+		Operator* toSimulate = ui.globalOpList.back();
+		BitAccurateSimulator* simulator;
+		try {
+			simulator = new BitAccurateSimulator(toSimulate);
+		} catch(string& e) {
+			// what this simulator does not support is left to a VHDL simulator
+			REPORT(LogLevel::MESSAGE, "Simulate: " << e << endl << "Generating a TestBench for a VHDL simulator instead");
+			return new TestBench(target, toSimulate, n);
+		}
+		int64_t failures = simulator->run(n);
+		delete simulator;
+		if(failures > 0)
+			throw(string("Simulate: ") + to_string(failures) + " test(s) failed");
+		return nullptr;
+	}
+
+	template <>
+	const OperatorDescription<BitAccurateSimulator> op_descriptor<BitAccurateSimulator> {
+	    "Simulate", // name
+	    "In-process, cycle-accurate simulation of the preceding operator, checked against its emulate() method. Faster than a VHDL simulator, but only the VHDL subset generated for datapaths is supported: otherwise a TestBench is generated instead, for a VHDL simulator.",
+	    "TestBenches", // categories
+	    "TestBench", // seeAlso
+	    "n(int)=-1: number of random tests. If n=-2, an exhaustive test is performed (use only for small operators). If n=-1, an exhaustive test is selected if there are fewer than 16 input bits, otherwise 1000 random tests are performed;",
+	    ""};
+}
@@ -26,6 +26,7 @@
 #include "flopoco/Operator.hpp"
 #include "flopoco/TestBenches/TestBench.hpp"
 #include "flopoco/TestBenches/TestCase.hpp"
+#include "flopoco/Tools/PhaseTrace.hpp"
 #include "flopoco/utils.hpp"
 
 using namespace std;
@@ -33,8 +34,8 @@ using namespace std;
 namespace flopoco{
 
 
-	TestBench::TestBench(Target* target, Operator* op_, int64_t n_):
-		Operator(nullptr, target), op(op_), n(n_)
+	TestBench::TestBench(Target* target, Operator* op_, int64_t n_, bool hexFile_):
+		Operator(nullptr, target), op(op_), n(n_), hexFile(hexFile_)
 	{
 		//We do not set the parent operator to this operator
 		setNoParseNoSchedule();
@@ -60,7 +61,19 @@ namespace flopoco{
 				|| ((n == -1) && (op->countInputBits() <= 16)) /* 65536 tests typicall take less than one second*/
 				) {
 			REPORT(LogLevel::MESSAGE,"Generating the exhaustive test bench, this may take some time");
+			// An exhaustive test may have millions of test cases: write them to the file as they are built
+			list<string> inputSignalNames, outputSignalNames;
+			for(Signal* s: op->getInputList())
+				inputSignalNames.push_back(s->getName());
+			for(Signal* s: op->getOutputList())
+				outputSignalNames.push_back(s->getName());
+			openTestInputFile();
+			tcl.streamTo(&testInputFile, [&](TestCase* tc) {
+					return hexFile ? tc->testFileHexString(inputSignalNames, outputSignalNames) : tc->testFileString(inputSignalNames, outputSignalNames);
+				});
 			n = op-> buildExhaustiveTestCaseList(&tcl);
+			tcl.flush();
+			testInputFile.close();
 		}
 		else {
 			if (n == -1) {
@@ -190,6 +203,8 @@ namespace flopoco{
 		o << tab << tab << "variable possibilityNumber : integer;" << endl;
 		o << tab << tab << "variable testSuccess: boolean;" << endl;
 		o << tab << tab << "variable errorMessage: string(1 to 10000);" << endl;
+		if(hexFile)
+			o << tab << tab << "variable tmpChar: character;" << endl;
 		//		o << tab << tab << "variable tmpErrorMessage: line;" << endl;
 		//    o << tab << tab << "variable errorMessage: line;" << endl;
 		for(Signal* s: outputSignalVector){
@@ -203,7 +218,24 @@ namespace flopoco{
 				o << tab << tab << "variable inf_" << s->getName() << ": bit_vector (" << s->width() -1 << " downto 0); -- for intervals" << endl;
 				o << tab << tab << "variable sup_" << s->getName() << ": bit_vector (" << s->width() -1 << " downto 0); -- for intervals" << endl;
 			}
+			if(hexFile)
+				o << tab << tab << "variable expectedHex_" << s->getName() << ": string(1 to " << hexDigits(s) << ");" << endl;
 		}
+		// reading one expected value into the bit or bit_vector variable var
+		auto readValue = [&](Signal* s, string var, string indent) {
+			ostringstream r;
+			if(hexFile) {
+				r << indent << "read(expectedOutput, tmpChar);" << endl;
+				r << indent << "read(expectedOutput, expectedHex_" << s->getName() << ");" << endl;
+				if (s->isBus())
+					r << indent << var << " := to_bitvector(hex_to_slv(expectedHex_" << s->getName() << ", " << s->width() << "));" << endl;
+				else
+					r << indent << var << " := to_bit(hex_to_slv(expectedHex_" << s->getName() << ", 1)(0));" << endl;
+			}
+			else
+				r << indent << "read(expectedOutput, " << var << ");" << endl;
+			return r.str();
+		};
 		o << tab << "begin" << endl;
 		o << tab << tab << "write(expectedOutput, expectedOutputS);" << endl;
 		for(Signal* s: outputSignalVector){
@@ -215,7 +247,7 @@ namespace flopoco{
 			o << tab << tab << "if possibilityNumber > 0 then -- a list of values" << endl;
 			o << tab << tab << "testSuccess_" << s->getName() << " := false;" << endl;
 			o << tab <<tab << tab << "for i in 1 to possibilityNumber loop" << endl;
-			o << tab << tab << tab << tab << "read(expectedOutput, expected_" << s->getName() << ");" << endl;
+			o << readValue(s, "expected_" + s->getName(), tab + tab + tab + tab);
 			//			o << tab << tab << tab << tab << "errorMessage := errorMessage & \" \" & expected_" << s->getName()<< ";" << endl;
 			if(s->isFP()){
 				o << tab << tab << tab << tab << "if fp_equal(" << s->getName() << ", to_stdlogicvector(expected_" << s->getName() << ")) then" << endl;
@@ -235,8 +267,8 @@ namespace flopoco{
 			o << tab << tab << "end if;" << endl;
 			o << tab << tab << "if possibilityNumber < 0  then -- an interval" << endl;
 			if (s->isBus()) {
-				o << tab << tab << tab << "read(expectedOutput, inf_" << s->getName() << ");" << endl;
-				o << tab << tab << tab << "read(expectedOutput, sup_" << s->getName() << ");" << endl;
+				o << readValue(s, "inf_" + s->getName(), tab + tab + tab);
+				o << readValue(s, "sup_" + s->getName(), tab + tab + tab);
 				o << tab << tab << tab << "if possibilityNumber =-1  then -- an unsigned interval" << endl;
 				o << tab << tab << tab << tab  << "testSuccess_" << s->getName() << " := (" << s->getName() << " >= to_stdlogicvector(inf_" << s->getName() << ")) and (" << s->getName() << " <= to_stdlogicvector(sup_" << s->getName() << "));" << endl;
 				o << tab << tab << tab << "elsif possibilityNumber =-2  then -- a signed interval" << endl;
@@ -276,6 +308,7 @@ namespace flopoco{
 		 They used to be stored in the VHDL itself, but with zillions of tests the compilation of the VHDL took more time than the actual simulation..
 	 */
 		void TestBench::generateTestFromFile() {
+		TRACE_PHASE("testGeneration", op->getName());
 		vector<Signal*> inputSignalVector = op->getInputList();
 		vector<Signal*> outputSignalVector = op->getOutputList();
 
@@ -311,6 +344,10 @@ namespace flopoco{
 			/*if (s->width() != 1)*/ vhdl << " : bit_vector("<< s->width() - 1 << " downto 0);" << endl;
 			//else vhdl << " : bit;" << endl;
 		}
+		if(hexFile) {
+			for(Signal* s: inputSignalVector)
+				vhdl << tab << tab << "variable H_" << s->getName() << " : string(1 to " << hexDigits(s) << ");" << endl;
+		}
 
 		/* The process that resets then sets inputs */
 		vhdl << tab << "begin" << endl;
@@ -322,18 +359,31 @@ namespace flopoco{
 		vhdl << tab << tab << "readline(inputsFile, input); -- skip the first line of advertising" << endl;
 		
 		vhdl << tab << tab << "while not endfile(inputsFile) loop" << endl;
-		vhdl << tab << tab << tab << "readline(inputsFile, input); -- skip the comment line" << endl;
-		vhdl << tab << tab << tab << "readline(inputsFile, input);" << endl;
-		vhdl << tab << tab << tab << "readline(inputsFile, expectedOutput); -- comment line, unused in this process" << endl;
-		vhdl << tab << tab << tab << "readline(inputsFile, expectedOutput); -- unused in this process" << endl;
+		if(hexFile) {
+			vhdl << tab << tab << tab << "readline(inputsFile, input); -- the inputs come first, the rest of the line is unused in this process" << endl;
+		}
+		else {
+			vhdl << tab << tab << tab << "readline(inputsFile, input); -- skip the comment line" << endl;
+			vhdl << tab << tab << tab << "readline(inputsFile, input);" << endl;
+			vhdl << tab << tab << tab << "readline(inputsFile, expectedOutput); -- comment line, unused in this process" << endl;
+			vhdl << tab << tab << tab << "readline(inputsFile, expectedOutput); -- unused in this process" << endl;
+		}
 
 		// input reading and forwarding to the operator
 		for(unsigned int i=0; i < inputSignalVector.size(); i++){
 			Signal* s = inputSignalVector[i];
-			vhdl << tab << tab << tab << "read(input ,V_"<< s->getName() << ");" << endl;
-			vhdl << tab << tab << tab << "read(input,tmpChar);" << endl; // we consume the character between each inputs
-			if ((s->width() == 1) && (!s->isBus())) vhdl << tab << tab << tab << s->getName() << " <= to_stdlogicvector(V_" << s->getName() << ")(0);" << endl;
-			else vhdl << tab << tab << tab << s->getName() << " <= to_stdlogicvector(V_" << s->getName() << ");" << endl;
+			if(hexFile) {
+				vhdl << tab << tab << tab << "read(input ,H_"<< s->getName() << ");" << endl;
+				vhdl << tab << tab << tab << "read(input,tmpChar);" << endl;
+				if ((s->width() == 1) && (!s->isBus())) vhdl << tab << tab << tab << s->getName() << " <= hex_to_slv(H_" << s->getName() << ", 1)(0);" << endl;
+				else vhdl << tab << tab << tab << s->getName() << " <= hex_to_slv(H_" << s->getName() << ", " << s->width() << ");" << endl;
+			}
+			else {
+				vhdl << tab << tab << tab << "read(input ,V_"<< s->getName() << ");" << endl;
+				vhdl << tab << tab << tab << "read(input,tmpChar);" << endl; // we consume the character between each inputs
+				if ((s->width() == 1) && (!s->isBus())) vhdl << tab << tab << tab << s->getName() << " <= to_stdlogicvector(V_" << s->getName() << ")(0);" << endl;
+				else vhdl << tab << tab << tab << s->getName() << " <= to_stdlogicvector(V_" << s->getName() << ");" << endl;
+			}
 			// adding the IO to IOorder
 			inputSignalNames.push_back(s->getName());
 		}
@@ -360,6 +410,11 @@ namespace flopoco{
 		vhdl << tab << tab << "variable expectedOutputString : string(1 to 10000);" << endl;
 
 		vhdl << tab << tab << "variable testSuccess: boolean;" << endl;
+		int inputChars = 0; // in a hex file, the width of the inputs at the beginning of each line
+		for(Signal* s: inputSignalVector)
+			inputChars += hexDigits(s) + 1;
+		if(hexFile && inputChars > 0)
+			vhdl << tab << tab << "variable inputPart : string(1 to " << inputChars << ");" << endl;
 		vhdl << tab << "begin" << endl;
 		vhdl << tab << tab << "wait for 12 ns; -- wait for reset " << endl; 
 		if (op->getPipelineDepth() > 0){
@@ -369,10 +424,17 @@ namespace flopoco{
 		vhdl << tab << tab << "readline(inputsFile, input); -- skip the first line of advertising" << endl;
 		
 		vhdl << tab << tab << "while not endfile(inputsFile) loop" << endl;
-		vhdl << tab << tab << tab << "readline(inputsFile, input); -- input comment, unused" << endl; 
-		vhdl << tab << tab << tab << "readline(inputsFile, input); -- input line, unused" << endl; // read the input line
-		vhdl << tab << tab << tab << "readline(inputsFile, expectedOutput); -- comment line, unused in this process" << endl;
-		vhdl << tab << tab << tab << "readline(inputsFile, expectedOutput);" << endl; // read the outputs line
+		if(hexFile) {
+			vhdl << tab << tab << tab << "readline(inputsFile, expectedOutput);" << endl;
+			if(inputChars > 0)
+				vhdl << tab << tab << tab << "read(expectedOutput, inputPart); -- inputs, unused in this process" << endl;
+		}
+		else {
+			vhdl << tab << tab << tab << "readline(inputsFile, input); -- input comment, unused" << endl; 
+			vhdl << tab << tab << tab << "readline(inputsFile, input); -- input line, unused" << endl; // read the input line
+			vhdl << tab << tab << tab << "readline(inputsFile, expectedOutput); -- comment line, unused in this process" << endl;
+			vhdl << tab << tab << tab << "readline(inputsFile, expectedOutput);" << endl; // read the outputs line
+		}
 		vhdl << tab << tab << tab << "expectedOutputString := expectedOutput.all & (expectedOutput'Length+1 to 10000 => ' ');" << endl;
 		vhdl << tab << tab << tab << "testSuccess := testLine(testCounter, expectedOutputString, expectedOutput'Length";
 		// Using for testLine the delayed signals so it resyncronises the outputs before testing the result
@@ -425,35 +487,48 @@ vhdl << tab << tab << tab << "if possibilityNumber = -1 then -- this means an in
 		/* Generating a file of inputs */
 		// opening a file to write down the output (for text-file based test)
 		// if n < 0 we do not generate a file
-		if (n >= 0) {
-			string inputFileName = "test.input";
-			ofstream fileOut(inputFileName.c_str(),ios::out);
-			// if error at opening, let's mention it !
-			if (!fileOut) {
-				ostringstream e;
-				e << "FloPoCo was not able to open " << inputFileName << " in order to write inputs. " << endl;
-				throw e.str();
-			}
-			fileOut << "# TestBench input file, generated by FloPoCo:" << endl; 
+		// if the test case list was streamed, the file is already written
+		if (n >= 0 && !tcl.isStreaming()) {
+			openTestInputFile();
 
 			for (int i = 0; i < tcl.getNumberOfTestCases(); i++)	{
 				TestCase* tc = tcl.getTestCase(i);
-				fileOut << tc->testFileString(inputSignalNames, outputSignalNames);
+				testInputFile << (hexFile ? tc->testFileHexString(inputSignalNames, outputSignalNames) : tc->testFileString(inputSignalNames, outputSignalNames));
 			}
 
 			// closing input file
-			fileOut.close();
+			testInputFile.close();
 		};
 
 	}
 
 
 
+	void TestBench::openTestInputFile() {
+		string inputFileName = "test.input";
+		testInputFile.open(inputFileName.c_str(),ios::out);
+		// if error at opening, let's mention it !
+		if (!testInputFile) {
+			ostringstream e;
+			e << "FloPoCo was not able to open " << inputFileName << " in order to write inputs. " << endl;
+			throw e.str();
+		}
+		testInputFile << "# TestBench input file, generated by FloPoCo:" << endl; 
+	}
+
+
+
 	TestBench::~TestBench() {
 	}
 
 
 
+	int TestBench::hexDigits(Signal* s) {
+		return (s->width() + 3) / 4;
+	}
+
+
+
 
 	void TestBench::outputVHDL(ostream& o, string name) {
 		// If the IOs of the tested operator are not synchronized
@@ -555,6 +630,26 @@ vhdl << tab << tab << tab << "if possibilityNumber = -1 then -- this means an in
 		  << tab << "end str;" << endl;
 		o << endl;
 
+		if(hexFile){
+			o << tab << "-- converts a string of hexadecimal digits into a std_logic_vector of w bits" << endl
+				<< tab << "function hex_to_slv(h: string; w: integer) return std_logic_vector is" << endl
+				<< tab << tab << "variable r: std_logic_vector(4*h'length-1 downto 0);" << endl
+				<< tab << tab << "variable d: integer;" << endl
+				<< tab << "begin" << endl
+				<< tab << tab << "for i in h'range loop" << endl
+				<< tab << tab << tab << "case h(i) is" << endl
+				<< tab << tab << tab << tab << "when '0' to '9' => d := character'pos(h(i)) - character'pos('0');" << endl
+				<< tab << tab << tab << tab << "when 'a' to 'f' => d := character'pos(h(i)) - character'pos('a') + 10;" << endl
+				<< tab << tab << tab << tab << "when 'A' to 'F' => d := character'pos(h(i)) - character'pos('A') + 10;" << endl
+				<< tab << tab << tab << tab << "when others => d := 0;" << endl
+				<< tab << tab << tab << "end case;" << endl
+				<< tab << tab << tab << "r(4*(h'high-i)+3 downto 4*(h'high-i)) := std_logic_vector(to_unsigned(d, 4));" << endl
+				<< tab << tab << "end loop;" << endl
+				<< tab << tab << "return r(w-1 downto 0);" << endl
+				<< tab << "end hex_to_slv;" << endl;
+			o << endl;
+		}
+
 		if(hasFPOutputs){
 			o << tab << "-- FP compare function (found vs. real)\n" 
   			<<	tab << "function fp_equal(a : std_logic_vector; b : std_logic_vector) return boolean is\n" 
@@ -710,8 +805,12 @@ vhdl << tab << tab << tab << "if possibilityNumber = -1 then -- this means an in
 		}
 
 		ui.parseInt(args, "n", &n);
+		string format;
+		ui.parseString(args, "format", &format);
+		if(format != "text" && format != "hex")
+			throw(string("TestBench: format should be text or hex, got ") + format);
 		Operator* toWrap = ui.globalOpList.back();
-		Operator* newOp = new TestBench(target, toWrap, n);
+		Operator* newOp = new TestBench(target, toWrap, n, format == "hex");
 		// the instance in newOp has added toWrap as a subcomponent of newOp,
 		// so we may remove it from globalOpList
 		//UserInterface::globalOpList.popback();
@@ -724,6 +823,7 @@ vhdl << tab << tab << tab << "if possibilityNumber = -1 then -- this means an in
 	    "Behavorial test bench for the preceding operator.",
 	    "TestBenches", // categories
 	    "", // seeAlso
-	    "n(int)=-1: number of random tests. If n=-2, an exhaustive test is generated (use only for small operators). If n=-1, an exhaustive test is selected if there are fewer than 16 input bits, otherwise 10000 random tests are performed;",
+	    "n(int)=-1: number of random tests. If n=-2, an exhaustive test is generated (use only for small operators). If n=-1, an exhaustive test is selected if there are fewer than 16 input bits, otherwise 10000 random tests are performed;"
+	    "format(string)=text: format of test.input, either text (readable, four lines per test) or hex (one compact line per test, faster to simulate for large tests);",
 	    ""};
 }
@@ -9,6 +9,13 @@ namespace flopoco{
 
 
 	void TestCaseList::add(TestCase* tc){
+		if(streamOut != nullptr) {
+			tc->setId(++numberOfStreamedTestCases);
+			v.push_back(tc);
+			if(v.size() >= (size_t)streamBatchSize)
+				flush();
+			return;
+		}
 		v.push_back(tc);
 		tc->setId(v.size()); // id is the index in this vector
 	}
@@ -22,13 +29,42 @@ namespace flopoco{
 	}
 
 	int TestCaseList::getNumberOfTestCases(){
+		if(streamOut != nullptr)
+			return numberOfStreamedTestCases;
 		return v.size();
 	}
 
 	TestCase* TestCaseList::getTestCase(int i){
+		if(streamOut != nullptr)
+			throw string("TestCaseList::getTestCase: the test cases of a streaming TestCaseList are not kept");
 		return v[i];
 	}
 
+	void TestCaseList::streamTo(ostream* o, std::function<string(TestCase*)> format, int batchSize){
+		// the test cases already stored go first
+		streamOut = o;
+		streamFormat = format;
+		streamBatchSize = max(batchSize, 1);
+		numberOfStreamedTestCases = v.size();
+		flush();
+	}
+
+	void TestCaseList::flush(){
+		if(streamOut == nullptr)
+			return;
+		ostringstream batch;
+		for(auto tc: v) {
+			batch << streamFormat(tc);
+			delete tc;
+		}
+		v.clear();
+		*streamOut << batch.str();
+	}
+
+	bool TestCaseList::isStreaming(){
+		return streamOut != nullptr;
+	}
+
 
 
 	/*
@@ -260,6 +296,11 @@ namespace flopoco{
 		return outputs[s]; // return all possible output values as a vector of mpz_class
 	}
 
+	TestCase::OutputType TestCase::getOutputType(string s) {
+		auto it = outputType.find(s);
+		return (it == outputType.end() ? list_of_values : it->second);
+	}
+
 
 	string TestCase::getInputVHDL(string prepend)
 	{
@@ -330,6 +371,34 @@ namespace flopoco{
 		return o.str();	
 	}
 
+
+	std::string TestCase::testFileHexString(list<string> inputSignalNames, list<string> outputSignalNames) {
+		ostringstream o;
+		auto hex = [&](Signal* s, mpz_class v) {
+			if(v<0)
+				v = signedToBitVector(v, s->width());
+			return s->valueToVHDLHex(v, false);
+		};
+		for (auto x: inputSignalNames) {
+			Signal* s = op_->getSignalByName(x);
+			o << hex(s, inputs[x]) << " ";
+		}
+		for (auto x: outputSignalNames) {
+			Signal* s = op_->getSignalByName(x);
+			OutputType type = outputType[x];
+			vector<mpz_class> vs = outputs[x];
+			if(type==list_of_values)
+				o << vs.size();
+			else
+				o << type;
+			for (auto v: vs)
+				o << " " << hex(s, v);
+			o << " ";
+		}
+		o << endl;
+		return o.str();
+	}
+
 	
 
 
@@ -349,6 +418,73 @@ namespace flopoco{
 		return intId;
 	}
 
+	namespace {
+		void writeRawString(FILE* f, const string& s) {
+			size_t size = s.size();
+			fwrite(&size, sizeof(size), 1, f);
+			fwrite(s.data(), 1, size, f);
+		}
+
+		string readRawString(FILE* f) {
+			size_t size = 0;
+			if(fread(&size, sizeof(size), 1, f) != 1)
+				throw string("TestCase::readRaw: unexpected end of file");
+			string s(size, ' ');
+			if(fread(&s[0], 1, size, f) != size)
+				throw string("TestCase::readRaw: unexpected end of file");
+			return s;
+		}
+
+		void writeRawInt(FILE* f, int64_t i) {
+			fwrite(&i, sizeof(i), 1, f);
+		}
+
+		int64_t readRawInt(FILE* f) {
+			int64_t i = 0;
+			if(fread(&i, sizeof(i), 1, f) != 1)
+				throw string("TestCase::readRaw: unexpected end of file");
+			return i;
+		}
+	}
+
+	void TestCase::writeRaw(FILE* f) {
+		writeRawInt(f, inputs.size());
+		for (auto& i: inputs) {
+			writeRawString(f, i.first);
+			mpz_out_raw(f, i.second.get_mpz_t());
+		}
+		writeRawInt(f, outputs.size());
+		for (auto& o: outputs) {
+			writeRawString(f, o.first);
+			writeRawInt(f, outputType[o.first]);
+			writeRawInt(f, o.second.size());
+			for (auto& v: o.second)
+				mpz_out_raw(f, v.get_mpz_t());
+		}
+		writeRawString(f, comment);
+	}
+
+	void TestCase::readRaw(FILE* f) {
+		inputs.clear();
+		outputs.clear();
+		outputType.clear();
+		int64_t numberOfInputs = readRawInt(f);
+		for (int64_t i = 0; i < numberOfInputs; i++) {
+			string name = readRawString(f);
+			mpz_inp_raw(inputs[name].get_mpz_t(), f);
+		}
+		int64_t numberOfOutputs = readRawInt(f);
+		for (int64_t i = 0; i < numberOfOutputs; i++) {
+			string name = readRawString(f);
+			outputType[name] = (OutputType) readRawInt(f);
+			vector<mpz_class>& values = outputs[name];
+			values.resize(readRawInt(f));
+			for (auto& v: values)
+				mpz_inp_raw(v.get_mpz_t(), f);
+		}
+		comment = readRawString(f);
+	}
+
 	string TestCase::getDescription() {
 		ostringstream msg;
 		msg << "Test Case number : " << getId() << std::endl;
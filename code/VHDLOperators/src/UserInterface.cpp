@@ -1,5 +1,6 @@
 #include <algorithm>
 #include <cstdlib>
+#include <fstream>
 #include <string>
 #include <sys/stat.h>
 #include <iostream>
@@ -11,6 +12,8 @@
 #include "flopoco/Tables/TableCostModel.hpp"
 #include "flopoco/Targets/AllTargetsHeaders.hpp"
 #include "flopoco/TestBenches/TestBench.hpp"
+#include "flopoco/Tools/DiskCache.hpp"
+#include "flopoco/Tools/PhaseTrace.hpp"
 #include "flopoco/UserInterface.hpp"
 #include "flopoco/report.hpp"
 // TODO check the hard mult threshold
@@ -48,7 +51,12 @@ namespace flopoco
 	}
  
 	UserInterface::UserInterface():factRegistry(FactoryRegistry::getFactoryRegistry()) {
+		setDefaultOptions();
+	}
+
+	void UserInterface::setDefaultOptions() {
 		outputFileName="flopoco.vhdl";
+		entityName="";
 		targetFPGA=defaultFPGA;
 		targetFrequencyMHz=0;
 		useHardMult=true;
@@ -57,11 +65,16 @@ namespace flopoco
 		allRegistersWithAsyncReset=false;
 		unusedHardMultThreshold=0.7;
 		compression = "heuristicMaxEff";
-		// TODO: restore tiling = "heuristicBeamSearchTiling";
 		tiling = "heuristicBasicTiling";
 
 		ilpSolver = "Gurobi";
 		ilpTimeout = 0; //timeout disabled
+		threads = 1;
+		beamThreads = 0;
+		writeEnable = false;
+		nameSignalByCycle = false;
+		plainVHDL = false;
+		useTargetOpt = false;
 
 		depGraphDrawing = "no";
 		generateFigures = false;
@@ -151,6 +164,10 @@ namespace flopoco
 				v.push_back(option_t("outputFile", values));
 				v.push_back(option_t("hardMultThreshold", values));
 				v.push_back(option_t("frequency", values));
+				v.push_back(option_t("threads", values));
+				v.push_back(option_t("beamThreads", values));
+				v.push_back(option_t("batch", values));
+				v.push_back(option_t("trace", values));
 
 				//Cost model to use
 				values.clear();
@@ -231,6 +248,8 @@ namespace flopoco
 		parseBoolean(args, "useTargetOpt", &useTargetOpt, true);
 		parseString(args, "ilpSolver", &ilpSolver, true); // sticky option
 		parsePositiveInt(args, "ilpTimeout", &ilpTimeout, true); // sticky option
+		parseStrictlyPositiveInt(args, "threads", &threads, true); // sticky option
+		parsePositiveInt(args, "beamThreads", &beamThreads, true); // sticky option
 		parseString(args, "compression", &compression, true);
 		parseString(args, "tiling", &tiling, true);
 		parseBoolean(args, "allRegistersWithAsyncReset", &allRegistersWithAsyncReset, true);
@@ -301,6 +320,7 @@ namespace flopoco
 
 				//output the vhdl code to file if it was not done already
 				if(alreadyOutput.find(i->getName())==alreadyOutput.end()) {
+					TRACE_PHASE("outputVHDL", i->getName());
 					i->outputVHDL(file);
 					alreadyOutput.insert(i->getName());
 				}
@@ -372,16 +392,63 @@ namespace flopoco
 			exit(EXIT_SUCCESS);
 		}
 
-		// First convert for convenience the input arg list into
-		// 1/ a (possibly empty) vector of global args / initial options,
-		// 2/ a vector of operator specification, each being itself a vector of strings
-		vector<string> initialOptions;
-		vector<vector<string>> operatorSpecs;
-
 		vector<string> args;
 		// convert all the char* to strings
 		for (int i=1; i<argc; i++) // start with 1 to skip executable name
 			args.push_back(string(argv[i]));
+		vector<string> initialOptions;
+		vector<vector<string>> operatorSpecs;
+		splitCommandLine(args, initialOptions, operatorSpecs);
+
+		// Now we have organized our input: do the parsing itself. All the sub-parsers erase the data they consume from the string vectors
+		try {
+			parseString(initialOptions, "batch", &batchFileName, true);
+			string traceFileName;
+			parseString(initialOptions, "trace", &traceFileName, true);
+			if(traceFileName!="")
+				PhaseTrace::enable(traceFileName);
+			vector<string> globalOptions = initialOptions; // kept for the batch jobs
+			parseGenericOptions(initialOptions);
+			initialOptions.erase(initialOptions.begin());
+			if(initialOptions.size()>0){
+				ostringstream s;
+				s << "Don't know what to do with the following global option(s) :" <<endl ;
+				for (auto i : initialOptions)
+					s << "  "<<i<<" ";
+				s << endl;
+				throw s.str();
+			}
+
+			if(batchFileName!="") {
+				if(operatorSpecs.size()>0)
+					throw string("In batch mode, the operators are read from the batch file, not from the command line");
+				int failures = runBatch(globalOptions);
+				exit(failures==0 ? EXIT_SUCCESS : EXIT_FAILURE);
+			}
+
+			if(operatorSpecs.size()==0) {
+				cerr << "No operator specified" << endl << getFullDoc();
+				exit(EXIT_SUCCESS);
+			}
+			buildOperators(operatorSpecs);
+		}catch(std::string &s){
+			std::cerr<<"Error : "<<s<<"\n";
+			//factory->Usage(std::cerr);
+			exit(EXIT_FAILURE);
+		}catch(std::exception &s){
+			std::cerr<<"Exception : "<<s.what()<<"\n";
+			//factory->Usage(std::cerr);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+
+	void UserInterface::splitCommandLine(vector<string> args, vector<string>& initialOptions, vector<vector<string>>& operatorSpecs) {
+		// Convert for convenience the input arg list into
+		// 1/ a (possibly empty) vector of global args / initial options,
+		// 2/ a vector of operator specification, each being itself a vector of strings
+		initialOptions.clear();
+		operatorSpecs.clear();
 
 		// Build the global option list
 		initialOptions.push_back("$$initialOptions$$");
@@ -402,107 +469,197 @@ namespace flopoco
 			}
 			operatorSpecs.push_back(opSpec);
 		}
+	}
 
 
-		// Now we have organized our input: do the parsing itself. All the sub-parsers erase the data they consume from the string vectors
-		try {
-			parseGenericOptions(initialOptions);
-			initialOptions.erase(initialOptions.begin());
-			if(initialOptions.size()>0){
-				ostringstream s;
-				s << "Don't know what to do with the following global option(s) :" <<endl ;
-				for (auto i : initialOptions)
-					s << "  "<<i<<" ";
-				s << endl;
-				throw s.str();
+	Target* UserInterface::getTarget() {
+		// make this option case-insensitive, too
+		std::transform(targetFPGA.begin(), targetFPGA.end(), targetFPGA.begin(), ::tolower);
+
+		Target* target;
+		// This could also be a factory but it is less critical
+		if (targetFPGA=="zynq7000")  target=new Zynq7000();
+		//					else if(targetFPGA=="virtex4") target=new Virtex4();
+		//				else if (targetFPGA=="virtex5") target=new Virtex5();
+		else if (targetFPGA=="kintex7") target=new Kintex7();
+		else if (targetFPGA=="virtexultrascaleplus") target=new VirtexUltrascalePlus();
+		else if (targetFPGA=="virtex6") target=new Virtex6();
+		//					else if (targetFPGA=="spartan3") target=new Spartan3();
+		//					else if (targetFPGA=="stratixii" || targetFPGA=="stratix2") target=new StratixII();
+		//					else if (targetFPGA=="stratixiii" || targetFPGA=="stratix3") target=new StratixIII();
+		//				else if (targetFPGA=="stratixiv" || targetFPGA=="stratix4") target=new StratixIV();
+		else if (targetFPGA=="stratixv" || targetFPGA=="stratix5") target=new StratixV();
+		//					else if (targetFPGA=="cycloneii" || targetFPGA=="cyclone2") target=new CycloneII();
+		//					else if (targetFPGA=="cycloneiii" || targetFPGA=="cyclone3") target=new CycloneIII();
+		//					else if (targetFPGA=="cycloneiv" || targetFPGA=="cyclone4") target=new CycloneIV();
+		//				else if (targetFPGA=="cyclonev" || targetFPGA=="cyclone5") target=new CycloneV();
+		else if (targetFPGA=="versal") target=new Versal();
+		else if (targetFPGA=="manualpipeline") target=new ManualPipeline();
+		else {
+			throw("ERROR: unknown target: " + targetFPGA);
+		}
+		target->setWriteEnable(writeEnable);
+		if (writeEnable) {
+			target->setNameSignalByCycle(true);
+			REPORT(LogLevel::MESSAGE,"If write enable is active, name signals by their cycle number instead of the delay.");
+		} else {
+			target->setNameSignalByCycle(nameSignalByCycle);
+		}				
+		target->setFrequency(1e6*targetFrequencyMHz);
+		target->setUseHardMultipliers(useHardMult);
+		target->setUnusedHardMultThreshold(unusedHardMultThreshold);
+		target->setRegisterLargeTables(registerLargeTables);
+		target->setTableCompression(tableCompression);
+		target->setPlainVHDL(plainVHDL);
+		target->setGenerateFigures(generateFigures);
+		target->setUseTargetOpt(useTargetOpt);
+		target->setCompressionMethod(toLowerCase(compression));
+		target->setILPSolver(ilpSolver);
+		target->setILPTimeout(ilpTimeout);
+		target->setThreads(threads);
+		target->setBeamThreads(beamThreads);
+		target->setTilingMethod(toLowerCase(tiling));
+		return target;
+	}
+
+
+	void UserInterface::clearOperators() {
+		globalOpList.clear();
+		Operator::clearSharedOperatorCache();
+	}
+
+
+	void UserInterface::buildOperators(vector<vector<string>>& operatorSpecs) {
+		for (auto opParams: operatorSpecs) {
+			string opName = opParams[0];  // operator Name
+			// remove the generic options
+			parseGenericOptions(opParams);
+
+			// build the Target for this operator
+			Target* target = getTarget();
+
+			// Now build the operator
+			auto fact = factRegistry.getPublicFactoryByName(opName);
+			if (fact == nullptr) {
+				throw string("No factory for operator " + opName);
 			}
 
-			if(operatorSpecs.size()==0) {
-				cerr << "No operator specified" << endl << getFullDoc();
-				exit(EXIT_SUCCESS);
+			// Call the constructor at last (through the factory)
+			OperatorPtr op;
+			{
+				TRACE_PHASE("construct", opName);
+				op = fact->parseArguments(nullptr, target, opParams, *this);
 			}
-			for (auto opParams: operatorSpecs) {
-				string opName = opParams[0];  // operator Name
-				// remove the generic options
-				parseGenericOptions(opParams);
-
-				// build the Target for this operator
-				Target* target;
-				// make this option case-insensitive, too
-				std::transform(targetFPGA.begin(), targetFPGA.end(), targetFPGA.begin(), ::tolower);
-
-					// This could also be a factory but it is less critical
-				if (targetFPGA=="zynq7000")  target=new Zynq7000();
-				//					else if(targetFPGA=="virtex4") target=new Virtex4();
-				//				else if (targetFPGA=="virtex5") target=new Virtex5();
-				else if (targetFPGA=="kintex7") target=new Kintex7();
-				else if (targetFPGA=="virtexultrascaleplus") target=new VirtexUltrascalePlus();
-				else if (targetFPGA=="virtex6") target=new Virtex6();
-				//					else if (targetFPGA=="spartan3") target=new Spartan3();
-				//					else if (targetFPGA=="stratixii" || targetFPGA=="stratix2") target=new StratixII();
-				//					else if (targetFPGA=="stratixiii" || targetFPGA=="stratix3") target=new StratixIII();
-				//				else if (targetFPGA=="stratixiv" || targetFPGA=="stratix4") target=new StratixIV();
-				else if (targetFPGA=="stratixv" || targetFPGA=="stratix5") target=new StratixV();
-				//					else if (targetFPGA=="cycloneii" || targetFPGA=="cyclone2") target=new CycloneII();
-				//					else if (targetFPGA=="cycloneiii" || targetFPGA=="cyclone3") target=new CycloneIII();
-				//					else if (targetFPGA=="cycloneiv" || targetFPGA=="cyclone4") target=new CycloneIV();
-				//				else if (targetFPGA=="cyclonev" || targetFPGA=="cyclone5") target=new CycloneV();
-				else if (targetFPGA=="versal") target=new Versal();
-				else if (targetFPGA=="manualpipeline") target=new ManualPipeline();
-				else {
-					throw("ERROR: unknown target: " + targetFPGA);
-				}
-				target->setWriteEnable(writeEnable);
-				if (writeEnable) {
-					target->setNameSignalByCycle(true);
-					REPORT(LogLevel::MESSAGE,"If write enable is active, name signals by their cycle number instead of the delay.");
-				} else {
-					target->setNameSignalByCycle(nameSignalByCycle);
-				}				
-				target->setFrequency(1e6*targetFrequencyMHz);
-				target->setUseHardMultipliers(useHardMult);
-				target->setUnusedHardMultThreshold(unusedHardMultThreshold);
-				target->setRegisterLargeTables(registerLargeTables);
-				target->setTableCompression(tableCompression);
-				target->setPlainVHDL(plainVHDL);
-				target->setGenerateFigures(generateFigures);
-        target->setUseTargetOpt(useTargetOpt);
-				target->setCompressionMethod(toLowerCase(compression));
-				target->setILPSolver(ilpSolver);
-				target->setILPTimeout(ilpTimeout);
-				target->setTilingMethod(toLowerCase(tiling));
-
-				// Now build the operator
-				auto fact = factRegistry.getPublicFactoryByName(opName);
-				if (fact == nullptr) {
-					std:cerr << "Error: No factory for operator " << opName << "\n";
-					exit(EXIT_FAILURE);
+			if(op!=NULL)	{// Some factories don't actually create an operator
+				if(entityName!="") {
+					op->changeName(entityName);
+					entityName="";
 				}
+				UserInterface::globalOpList.push_back(op);
+				// Schedule it
+				op->schedule();
+				op->applySchedule();
+			}
+		}
+	}
 
-				// Call the constructor at last (through the factory)
-				OperatorPtr op = fact->parseArguments(nullptr, target, opParams, *this);
-				if(op!=NULL)	{// Some factories don't actually create an operator
-					if(entityName!="") {
-						op->changeName(entityName);
-						entityName="";
-					}
-					UserInterface::globalOpList.push_back(op);
-					// Schedule it
-					op->schedule();
-					op->applySchedule();
-				}
+
+	int UserInterface::runBatch(vector<string> const & globalOptions) {
+		ifstream file;
+		istream* in = &cin;
+		if(batchFileName!="-") {
+			file.open(batchFileName);
+			if(!file)
+				throw("Cannot open batch file " + batchFileName);
+			in = &file;
+		}
+		// The function tables evaluated by a job are kept for the next ones
+		DiskCache::enableMemoryCache();
+
+		string line;
+		int lineNumber=0, jobs=0, failures=0;
+		while(getline(*in, line)) {
+			lineNumber++;
+			vector<string> words = splitBatchLine(line);
+			if(words.empty() || words[0][0]=='#') // empty line or comment
+				continue;
+
+			jobs++;
+			try {
+				runBatchJob(words, globalOptions, jobs);
+				REPORT(LogLevel::MESSAGE, "Batch job " << jobs << " (line " << lineNumber << ") written to " << outputFileName);
+			}catch(std::string &s){
+				failures++;
+				cerr << "Error in batch job " << jobs << " (line " << lineNumber << "): " << s << endl;
+			}catch(std::exception &s){
+				failures++;
+				cerr << "Exception in batch job " << jobs << " (line " << lineNumber << "): " << s.what() << endl;
 			}
-		}catch(std::string &s){
-			std::cerr<<"Error : "<<s<<"\n";
-			//factory->Usage(std::cerr);
-			exit(EXIT_FAILURE);
-		}catch(std::exception &s){
-			std::cerr<<"Exception : "<<s.what()<<"\n";
-			//factory->Usage(std::cerr);
-			exit(EXIT_FAILURE);
 		}
+		clearOperators();
+		REPORT(LogLevel::MESSAGE, "Batch: " << jobs << " jobs, " << failures << " failed");
+		return failures;
 	}
 
+
+	vector<string> UserInterface::splitBatchLine(string const & line) {
+		vector<string> words;
+		string word;
+		bool inWord=false;
+		char quote=0;
+		for(char c: line) {
+			if(quote!=0) {
+				if(c==quote)
+					quote=0;
+				else
+					word += c;
+			}
+			else if(c=='"' || c=='\'') {
+				quote=c;
+				inWord=true;
+			}
+			else if(isspace(c)) {
+				if(inWord)
+					words.push_back(word);
+				word="";
+				inWord=false;
+			}
+			else {
+				word += c;
+				inWord=true;
+			}
+		}
+		if(inWord)
+			words.push_back(word);
+		return words;
+	}
+
+
+	void UserInterface::runBatchJob(vector<string> const & words, vector<string> const & globalOptions, int job) {
+		setDefaultOptions();
+		vector<string> options = globalOptions;
+		parseGenericOptions(options);
+		outputFileName = "flopoco_" + to_string(job) + ".vhdl"; // may be overriden by outputFile= on the job line
+
+		vector<string> jobOptions;
+		vector<vector<string>> operatorSpecs;
+		splitCommandLine(words, jobOptions, operatorSpecs);
+		parseGenericOptions(jobOptions);
+		if(jobOptions.size()>1)
+			throw("Don't know what to do with the option " + jobOptions[1]);
+		if(operatorSpecs.size()==0)
+			throw string("No operator specified");
+
+		clearOperators();
+		buildOperators(operatorSpecs);
+		if(depGraphDrawing != "no") {
+			mkdir("dot", S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH);
+			drawDotDiagram(globalOpList);
+		}
+		outputVHDL();
+	}
+
+
 	void UserInterface::drawDotDiagram(vector<OperatorPtr> & oplist) {
 		ofstream file;
 		for(auto i: oplist) {
@@ -817,14 +974,20 @@ namespace flopoco
 		s << "  " << COLOR_BOLD << "allRegistersWithAsyncReset" << COLOR_NORMAL << "=<0|1>: if set, all the pipeline registers have an asynchronous reset signal" << COLOR_RED_NORMAL << "(sticky option)" << COLOR_NORMAL<<endl;
 		s << "  " << COLOR_BOLD << "ilpSolver" << COLOR_NORMAL << "=<string>:           override ILP solver for operators optimized by ILP, has to match a solver name known by the ScaLP library" << COLOR_RED_NORMAL << "(sticky option)" << COLOR_NORMAL<<endl;
 		s << "  " << COLOR_BOLD << "ilpTimeout" << COLOR_NORMAL << "=<int>:             sets the timeout in seconds for the ILP solver for operators optimized by ILP (default=3600)" << COLOR_RED_NORMAL << "(sticky option)" << COLOR_NORMAL<<endl;
-		s << "  " << COLOR_BOLD << "compression" << COLOR_NORMAL << "=<heuristicMaxEff,heuristicPA,heuristicFirstFit,optimal,optimalMinStages>:        compression method (default=heuristicMaxEff)" << COLOR_RED_NORMAL << "(sticky option)" << COLOR_NORMAL<<endl;
+		s << "  " << COLOR_BOLD << "compression" << COLOR_NORMAL << "=<heuristicMaxEff,heuristicPA,heuristicFirstFit,optimal,optimalMinStages,race>:        compression method, race keeps the best of the heuristics (default=heuristicMaxEff)" << COLOR_RED_NORMAL << "(sticky option)" << COLOR_NORMAL<<endl;
 		s << "  " << COLOR_BOLD << "tiling" << COLOR_NORMAL << "=<heuristicBasicTiling,optimal,heuristicGreedyTiling,heuristicXGreedyTiling,heuristicBeamSearchTiling,csv>:        tiling method (default=heuristicBasicTiling)" << COLOR_RED_NORMAL << "(sticky option)" << COLOR_NORMAL<<endl;
+		s << "  " << COLOR_BOLD << "beamThreads" << COLOR_NORMAL << "=<int>:            number of threads evaluating the alternatives of tiling=heuristicBeamSearchTiling (default=0: same as threads)" << COLOR_RED_NORMAL << "(sticky option)" << COLOR_NORMAL<<endl;
+		s << "  " << COLOR_BOLD << "threads" << COLOR_NORMAL << "=<int>:                number of parallel workers for the parallel parts of the generator, such as function table evaluation (default=1)" << COLOR_RED_NORMAL << "(sticky option)" << COLOR_NORMAL<<endl;
+		s << "  " << COLOR_BOLD << "batch" << COLOR_NORMAL << "=<string>:               build in one process the operators of each line of this file (- for stdin), each line having the syntax of a command line; job n is written to flopoco_n.vhdl unless it has an outputFile option. Each job gets its own Targets: the speedup over separate runs comes from the process startup and the in-memory cache of function tables, shared between jobs" <<endl;
+		s << "  " << COLOR_BOLD << "trace" << COLOR_NORMAL << "=<string>:               write to this file the time spent in each phase (construction, lexing, scheduling, VHDL output, test generation) of each operator, as a Chrome trace, or as CSV if the file name ends with .csv" <<endl;
 		s << "  " << COLOR_BOLD << "verbose" << COLOR_NORMAL << "=<int>:        verbosity level (0-4, default=1)" << COLOR_RED_NORMAL << "(sticky option)" << COLOR_NORMAL<<endl;
 		s << "  " << COLOR_BOLD << "generateFigures" << COLOR_NORMAL << "=<0|1>:generate graphics in SVG or LaTeX for some operators (default off) " << COLOR_RED_NORMAL << "(sticky option)" << COLOR_NORMAL << endl;
 		s << "  " << COLOR_BOLD << "dependencyGraph" << COLOR_NORMAL << "=<no|compact|full>: generate data dependence drawing of the Operator (default no) " << COLOR_RED_NORMAL << COLOR_NORMAL<<endl;
 		s << "  " << COLOR_BOLD << "nameSignalByCycle" << COLOR_NORMAL << "=<0|1>:when pipelining, postfix signal names by their cycle (default off)" << endl;
 		s << "  " << COLOR_BOLD << "writeEnable" << COLOR_NORMAL << "=<0|1>:when pipelining, adds write enable signals that enables the different pipeline stages to progress (default off)" << endl;
 		s << "  " << COLOR_BOLD << "showHidden" << COLOR_NORMAL << "=<0|1>: show operators and operator arguments that are for internal use and normally hidden from the command line (default=0)" <<endl;
+		s << "Environment variables:" << endl;
+		s << "  " << COLOR_BOLD << "FLOPOCO_CACHE_DIR" << COLOR_NORMAL << ": if set, directory where evaluated function tables, polynomial approximations and solver results are cached from one run to the next, and shared by concurrent runs. Its file index lists the entries (erasing it is harmless)" <<endl;
 		
 		return s.str();
 	}
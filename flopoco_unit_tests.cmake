@@ -7,6 +7,16 @@ if(BUILD_UNIT_TEST)
 	target_link_libraries(TableTest_exe FloPoCoLib ${Boost_LIBRARIES})
 	add_test(TableTest TableTest_exe)
 
+	## Comparing the machine word and mpz computations of the differential compression
+	add_executable(DifferentialCompressionWordsTest_exe tests/Table/DifferentialCompressionWords.cpp)
+	target_link_libraries(DifferentialCompressionWordsTest_exe FloPoCoLib ${Boost_LIBRARIES})
+	add_test(DifferentialCompressionWordsTest DifferentialCompressionWordsTest_exe)
+
+	## Comparing the in-process simulation of the generated VHDL with emulate()
+	add_executable(BitAccurateSimulatorTest_exe tests/TestBenches/BitAccurateSimulator.cpp ${CMAKE_CURRENT_BINARY_DIR}/Factories.cpp ${CMAKE_CURRENT_BINARY_DIR}/VHDLLexer.cpp)
+	target_link_libraries(BitAccurateSimulatorTest_exe FloPoCoLib ${Boost_LIBRARIES})
+	add_test(BitAccurateSimulatorTest BitAccurateSimulatorTest_exe)
+
 	## Testing Posit format
 	add_executable(NumberFormatTest_exe tests/TestBenches/PositNumber.cpp)
 	target_include_directories(NumberFormatTest_exe PUBLIC ${Boost_INCLUDE_DIR})
@@ -0,0 +1,131 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE DifferentialCompressionWordsTest
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <gmpxx.h>
+#include <boost/test/unit_test.hpp>
+
+#include "flopoco/Tables/DifferentialCompression.hpp"
+#include "flopoco/Tables/Table.hpp"
+#include "flopoco/Tables/TableCostModel.hpp"
+#include "flopoco/Targets/Kintex7.hpp"
+
+using std::vector;
+using namespace flopoco;
+
+/* find_differential_compression() computes on machine words when wOut < 64 and all the values fit,
+	 and on mpz_class otherwise. Both computations must give exactly the same compression. */
+
+namespace {
+	enum class Content {Random, Smooth, Blocks};
+
+	// a random value of at most w bits (w may exceed 64)
+	mpz_class randomBits(std::mt19937_64 & rng, int w)
+	{
+		mpz_class r = 0;
+		for (int done = 0 ; done < w ; done += 64) {
+			int chunk = std::min(64, w - done);
+			uint64_t bits = rng();
+			if (chunk < 64)
+				bits &= (uint64_t(1) << chunk) - 1;
+			mpz_class c;
+			mpz_import(c.get_mpz_t(), 1, -1, sizeof(bits), 0, 0, &bits);
+			r = (r << chunk) + c;
+		}
+		return r;
+	}
+
+	// a table of 2^wIn values of at most wOut bits, the largest of which has exactly wOut bits
+	vector<mpz_class> makeTable(std::mt19937_64 & rng, int wIn, int wOut, Content content)
+	{
+		size_t size = size_t(1) << wIn;
+		mpz_class limit = mpz_class(1) << wOut;
+		vector<mpz_class> values(size);
+		mpz_class step = randomBits(rng, wOut) / size;
+		for (size_t i = 0 ; i < size ; ++i) {
+			switch (content) {
+			case Content::Random:
+				values[i] = randomBits(rng, wOut);
+				break;
+			case Content::Smooth: // the kind of contents that compresses well
+				values[i] = step * mpz_class(static_cast<unsigned long>(i)) + randomBits(rng, std::min(wOut, 4));
+				break;
+			case Content::Blocks:
+				values[i] = (randomBits(rng, wOut) >> 3 << 3) + (i & 7);
+				break;
+			}
+			values[i] %= limit;
+		}
+		mpz_setbit(values[rng() % size].get_mpz_t(), wOut - 1);
+		return values;
+	}
+
+	void checkSameCompression(vector<mpz_class> const & values, int wIn, int wOut, Target * target)
+	{
+		table_cost_function_t cost = getGlobalCostModel();
+		auto dispatched = DifferentialCompression::find_differential_compression(values, wIn, wOut, target, cost);
+		auto reference = DifferentialCompression::find_differential_compression_mpz(values, wIn, wOut, target, cost);
+
+		BOOST_REQUIRE_MESSAGE(dispatched.getInitialTable() == values, "wIn=" << wIn << " wOut=" << wOut << ": the compressed table does not give back the values");
+		BOOST_REQUIRE_MESSAGE(dispatched.subsamplingIndexSize == reference.subsamplingIndexSize
+				&& dispatched.subsamplingWordSize == reference.subsamplingWordSize
+				&& dispatched.diffWordSize == reference.diffWordSize
+				&& dispatched.diffIndexSize == reference.diffIndexSize
+				&& dispatched.originalWout == reference.originalWout,
+				"wIn=" << wIn << " wOut=" << wOut << ": different parameters, " << dispatched.report() << " instead of " << reference.report());
+		BOOST_REQUIRE_MESSAGE(dispatched.originalCost == reference.originalCost
+				&& dispatched.subsamplingCost == reference.subsamplingCost
+				&& dispatched.diffCost == reference.diffCost,
+				"wIn=" << wIn << " wOut=" << wOut << ": different costs");
+		BOOST_REQUIRE_MESSAGE(dispatched.subsampling == reference.subsampling && dispatched.diffs == reference.diffs,
+				"wIn=" << wIn << " wOut=" << wOut << ": different table contents");
+	}
+}
+
+BOOST_AUTO_TEST_CASE(TestDifferentialCompressionWordsMatchMpz)
+{
+	std::mt19937_64 rng(42);
+	Kintex7 target{};
+	// around 64 bits: 63 is the widest word computation, 64 and above fall back to mpz_class
+	const vector<int> wOuts = {1, 2, 5, 8, 13, 17, 24, 31, 32, 33, 47, 62, 63, 64, 65, 70};
+	int tables = 0;
+	for (int wIn = 1 ; wIn <= 10 ; wIn++) {
+		for (int wOut : wOuts) {
+			for (auto content : {Content::Random, Content::Smooth, Content::Blocks}) {
+				for (int trial = 0 ; trial < 2 ; trial++) {
+					checkSameCompression(makeTable(rng, wIn, wOut, content), wIn, wOut, &target);
+					tables++;
+				}
+			}
+		}
+	}
+	BOOST_TEST_MESSAGE(tables << " tables compressed identically on words and on mpz_class");
+}
+
+BOOST_AUTO_TEST_CASE(TestSixtyFourBitValues)
+{
+	// Values of exactly 64 bits fit in the packed representation of Table,
+	// but are too wide for the word computation of the differential compression
+	std::mt19937_64 rng(64);
+	Kintex7 target{};
+	for (int wIn = 1 ; wIn <= 8 ; wIn++) {
+		for (auto content : {Content::Random, Content::Smooth, Content::Blocks}) {
+			vector<mpz_class> values = makeTable(rng, wIn, 64, content);
+			BOOST_REQUIRE(mpz_sizeinbase(values[0].get_mpz_t(), 2) <= 64);
+
+			Table table(values, wIn);
+			BOOST_REQUIRE_MESSAGE(table.isPacked(), "a table of 64-bit values should be packed");
+			BOOST_REQUIRE_EQUAL(table.wOut, 64);
+			for (size_t i = 0 ; i < values.size() ; ++i) {
+				mpz_class unpacked;
+				mpz_import(unpacked.get_mpz_t(), 1, -1, sizeof(uint64_t), 0, 0, &table.packedValues[i]);
+				BOOST_REQUIRE_MESSAGE(unpacked == values[i], "packed value " << i << " is " << unpacked << " instead of " << values[i]);
+			}
+
+			checkSameCompression(values, wIn, 64, &target);
+		}
+	}
+}
@@ -0,0 +1,170 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE BitAccurateSimulatorTest
+
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "flopoco/FixFunctions/Alpha.hpp"
+#include "flopoco/IntAddSubCmp/IntAdder.hpp"
+#include "flopoco/ShiftersEtc/Shifters.hpp"
+#include "flopoco/Targets/Kintex7.hpp"
+#include "flopoco/TestBenches/BitAccurateSimulator.hpp"
+
+using namespace flopoco;
+
+/* The simulation of the generated VHDL must agree with emulate(), exhaustively for small operators
+	 and on the standard and random test cases otherwise. */
+
+namespace {
+	/** An adder whose VHDL is given, so that the registers are placed by hand */
+	class HandWrittenAdder : public Operator
+	{
+	public:
+		HandWrittenAdder(Target* target, int w, std::string code, int outputCycle = 0,
+										 std::vector<std::string> signals = {}) :
+			Operator(nullptr, target), w(w)
+		{
+			setName("HandWrittenAdder");
+			addInput("X", w);
+			addInput("Y", w);
+			addOutput("R", w+1);
+			for (auto s : signals)
+				declare(s, w+1);
+			vhdl.setSecondLevelCode(code);
+			getSignalByName("R")->setCycle(outputCycle);
+			computePipelineDepths();
+		}
+
+		void emulate(TestCase * tc)
+		{
+			tc->addExpectedOutput("R", tc->getInputValue("X") + tc->getInputValue("Y"));
+		}
+
+		int w;
+	};
+
+	void checkAgainstEmulate(Operator * op, int64_t n = -1)
+	{
+		op->schedule();
+		op->applySchedule();
+		BitAccurateSimulator simulator(op);
+		int64_t failures = simulator.run(n);
+		BOOST_REQUIRE_MESSAGE(failures == 0, op->getName() << ": " << failures << " test(s) differ from emulate()");
+	}
+}
+
+BOOST_AUTO_TEST_CASE(TestIntAdder)
+{
+	Kintex7 target{};
+	// 64 is the widest single-word value, 100 spans two words
+	for (int wIn : {1, 8, 17, 63, 64, 65, 100}) {
+		IntAdder op(nullptr, &target, wIn);
+		checkAgainstEmulate(&op);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(TestShifter)
+{
+	Kintex7 target{};
+	for (auto dir : {Shifter::Left, Shifter::Right}) {
+		Shifter plain(nullptr, &target, 8, 8, dir);
+		checkAgainstEmulate(&plain);
+		Shifter sticky(nullptr, &target, 24, 24, dir, 24, true);
+		checkAgainstEmulate(&sticky);
+		Shifter wide(nullptr, &target, 70, 80, dir);
+		checkAgainstEmulate(&wide, 1000);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(TestAlpha)
+{
+	Kintex7 target{};
+	for (std::string method : {"PlainTable", "MultiPartite"}) {
+		Alpha op(nullptr, &target, "Tanh", 8, 8, method, 8.0, -1, false, false, false);
+		checkAgainstEmulate(&op);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(TestCombinational)
+{
+	Kintex7 target{};
+	for (int w : {8, 64, 100}) {
+		HandWrittenAdder op(&target, w, "T <= ('0' & X) + ('0' & Y);\nR <= T;\n", 0, {"T"});
+		BitAccurateSimulator simulator(&op);
+		mpz_class x = (mpz_class(1) << w) - 1, y = 1;
+		auto outputs = simulator.simulate({{"X", x}, {"Y", y}});
+		BOOST_REQUIRE_EQUAL(outputs["R"], x + y);
+		BOOST_REQUIRE_EQUAL(simulator.run(1000), 0);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(TestRegisters)
+{
+	Kintex7 target{};
+	// the sum goes through two registers, and the outputs are checked two cycles after the inputs
+	std::string code = "T <= ('0' & X) + ('0' & Y);\nR <= T_d2;\n";
+	HandWrittenAdder pipelined(&target, 8, code, 2, {"T"});
+	BOOST_REQUIRE_EQUAL(pipelined.getPipelineDepth(), 2);
+	BitAccurateSimulator simulator(&pipelined);
+	BOOST_REQUIRE_EQUAL(simulator.simulate({{"X", 200}, {"Y", 100}})["R"], 300);
+	BOOST_REQUIRE_EQUAL(simulator.run(-2), 0);
+
+	// the same VHDL, but with an output declared one cycle too early
+	HandWrittenAdder misscheduled(&target, 8, code, 1, {"T"});
+	BitAccurateSimulator wrong(&misscheduled);
+	BOOST_REQUIRE_GT(wrong.run(1000), 0);
+}
+
+BOOST_AUTO_TEST_CASE(TestFeedback)
+{
+	Kintex7 target{};
+	// an accumulator: A_d1 is a register, not a combinational loop
+	Operator op(nullptr, &target);
+	op.setName("Accumulator");
+	op.addInput("X", 8);
+	op.addOutput("R", 8);
+	op.declare("A", 8);
+	op.vhdl.setSecondLevelCode("A <= A_d1 + X;\nR <= A;\n");
+	BitAccurateSimulator simulator(&op);
+	mpz_class sum = 0;
+	for (int x : {3, 250, 17, 0, 99}) {
+		sum = (sum + x) % 256;
+		BOOST_REQUIRE_EQUAL(simulator.simulate({{"X", x}})["R"], sum);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(TestInstances)
+{
+	Kintex7 target{};
+	// each instance of a pipelined sub-component has its own registers
+	Operator* sub = new Operator(nullptr, &target);
+	sub->setName("Delay");
+	sub->addInput("A", 8);
+	sub->addOutput("S", 8);
+	sub->vhdl.setSecondLevelCode("S <= A_d1;\n");
+	Operator op(nullptr, &target);
+	op.setName("TwoDelays");
+	op.addSubComponent(sub);
+	op.addInput("X", 8);
+	op.addInput("Y", 8);
+	op.addOutput("R", 8);
+	op.addOutput("Q", 8);
+	op.vhdl.setSecondLevelCode("u1: Delay port map (clk => clk, A => X, S => R);\nu2: Delay port map (clk => clk, A => Y, S => Q);\n");
+	op.getSignalByName("R")->setCycle(1);
+	op.getSignalByName("Q")->setCycle(1);
+	op.computePipelineDepths();
+	BitAccurateSimulator simulator(&op);
+	auto outputs = simulator.simulate({{"X", 5}, {"Y", 7}});
+	BOOST_REQUIRE_EQUAL(outputs["R"], 5);
+	BOOST_REQUIRE_EQUAL(outputs["Q"], 7);
+}
+
+BOOST_AUTO_TEST_CASE(TestUnsupported)
+{
+	Kintex7 target{};
+	// a process is left to a VHDL simulator: the Simulate command then generates a TestBench
+	HandWrittenAdder op(&target, 8, "process(X, Y)\nbegin\n  R <= ('0' & X) + ('0' & Y);\nend process;\n");
+	BOOST_REQUIRE_THROW(BitAccurateSimulator simulator(&op), std::string);
+}